@@ -0,0 +1,94 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "kube_config_alloc.h"
+
+/* All hooks NULL: the C library. */
+static kubeyaml_allocator_t allocator;
+
+int kubeyaml_set_allocator(const kubeyaml_allocator_t * hooks)
+{
+    static char fname[] = "kubeyaml_set_allocator()";
+
+    if (!hooks) {
+        memset(&allocator, 0, sizeof(allocator));
+        return 0;
+    }
+    if (!hooks->malloc || !hooks->realloc || !hooks->free) {
+        fprintf(stderr, "%s: The malloc, realloc and free hooks are all needed.\n", fname);
+        return -1;
+    }
+    allocator = *hooks;
+    return 0;
+}
+
+int kubeyaml_has_allocator()
+{
+    return allocator.malloc ? 1 : 0;
+}
+
+void *kubeyaml_malloc(size_t size)
+{
+    if (allocator.malloc) {
+        return allocator.malloc(allocator.ctx, size);
+    }
+    return malloc(size);
+}
+
+void *kubeyaml_calloc(size_t count, size_t size)
+{
+    void *ptr = NULL;
+
+    if (!allocator.malloc) {
+        return calloc(count, size);
+    }
+    if (size && count > SIZE_MAX / size) {
+        return NULL;
+    }
+    ptr = allocator.malloc(allocator.ctx, count * size);
+    if (ptr) {
+        memset(ptr, 0, count * size);
+    }
+    return ptr;
+}
+
+void *kubeyaml_realloc(void *ptr, size_t size)
+{
+    if (allocator.realloc) {
+        return allocator.realloc(allocator.ctx, ptr, size);
+    }
+    return realloc(ptr, size);
+}
+
+void kubeyaml_free(void *ptr)
+{
+    if (!ptr) {
+        return;
+    }
+    if (allocator.free) {
+        allocator.free(allocator.ctx, ptr);
+        return;
+    }
+    free(ptr);
+}
+
+char *kubeyaml_strndup(const char *string, size_t length)
+{
+    char *copy = NULL;
+
+    if (length == SIZE_MAX) {
+        return NULL;
+    }
+    copy = kubeyaml_malloc(length + 1);
+    if (copy) {
+        memcpy(copy, string, length);
+        copy[length] = '\0';
+    }
+    return copy;
+}
+
+char *kubeyaml_strdup(const char *string)
+{
+    return kubeyaml_strndup(string, strlen(string));
+}
@@ -0,0 +1,69 @@
+#ifndef _KUBE_CONFIG_ALLOC_H
+#define _KUBE_CONFIG_ALLOC_H
+
+#include <stddef.h>
+
+#ifdef  __cplusplus
+extern "C" {
+#endif
+
+/*
+ * The library allocates its memory, the kubeconfigs and their strings
+ * included, through kubeyaml_malloc() and the functions below. By default
+ * they are the ones of the C library, kubeyaml_set_allocator() routes them
+ * to hooks of the caller, e.g. to allocate from jemalloc arenas or to
+ * account the memory of each tenant.
+ *
+ * libyaml is linked prebuilt and allocates its parser state and events
+ * with the C library. This memory is released before a load returns: when
+ * hooks are set, the strings of libyaml are copied instead of kept in the
+ * kubeconfig.
+ */
+
+    typedef struct kubeyaml_allocator_t {
+        void *(*malloc) (void *ctx, size_t size);
+        void *(*realloc) (void *ctx, void *ptr, size_t size);
+        void (*free) (void *ctx, void *ptr);
+        void *ctx;              /* passed to the hooks */
+    } kubeyaml_allocator_t;
+
+/*
+ * kubeyaml_set_allocator
+ *
+ * Description:
+ *
+ * Allocate the memory of the library with the hooks of allocator. The
+ * hooks are used by all threads. They must be set before anything is
+ * allocated and not changed while memory allocated by the former ones is
+ * still in use, which is then freed by the new free hook. Memory the
+ * caller puts into a kubeconfig and leaves to kubeconfig_free(), e.g.
+ * kubeconfig->fileName, must come from kubeyaml_malloc() or
+ * kubeyaml_strdup() too.
+ *
+ * Return:
+ *
+ *   0     Success
+ *  -1     Failed, one of the hooks is null
+ *
+ * Parameter:
+ *
+ * IN:
+ * allocator: hooks, copied, NULL restores the functions of the C library
+ *
+ */
+    int kubeyaml_set_allocator(const kubeyaml_allocator_t * allocator);
+
+/* 1 if hooks are set by kubeyaml_set_allocator(), 0 if the C library allocates. */
+    int kubeyaml_has_allocator();
+
+    void *kubeyaml_malloc(size_t size);
+    void *kubeyaml_calloc(size_t count, size_t size);
+    void *kubeyaml_realloc(void *ptr, size_t size);
+    void kubeyaml_free(void *ptr);
+    char *kubeyaml_strdup(const char *string);
+    char *kubeyaml_strndup(const char *string, size_t length);
+
+#ifdef  __cplusplus
+}
+#endif
+#endif                          /* _KUBE_CONFIG_ALLOC_H */
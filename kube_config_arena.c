@@ -0,0 +1,203 @@
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "kube_config_arena.h"
+#include "kube_config_alloc.h"
+
+#define ARENA_ALIGNMENT KUBECONFIG_ARENA_ALIGNMENT
+#define ARENA_ALIGN(size) (((size) + (ARENA_ALIGNMENT - 1)) & ~((size_t) ARENA_ALIGNMENT - 1))
+
+struct kubeconfig_arena_chunk_t {
+    kubeconfig_arena_chunk_t *next;
+    size_t size;                /* bytes after the header */
+    size_t used;
+    size_t last;                /* offset of the last allocation, it can grow in place */
+};
+
+#define CHUNK_HEADER_SIZE ARENA_ALIGN(sizeof(kubeconfig_arena_chunk_t))
+#define CHUNK_DATA(chunk) ((unsigned char *) (chunk) + CHUNK_HEADER_SIZE)
+
+kubeconfig_arena_t *kubeconfig_arena_create()
+{
+    kubeconfig_arena_t *arena = kubeyaml_calloc(1, sizeof(kubeconfig_arena_t));
+    if (arena) {
+        arena->next_size = KUBECONFIG_ARENA_CHUNK_MIN;
+    }
+    return arena;
+}
+
+void kubeconfig_arena_free(kubeconfig_arena_t * arena)
+{
+    kubeconfig_arena_chunk_t *chunk = NULL;
+    kubeconfig_arena_chunk_t *next = NULL;
+
+    if (!arena) {
+        return;
+    }
+
+    for (chunk = arena->chunks; chunk; chunk = next) {
+        next = chunk->next;
+        kubeyaml_free(chunk);
+    }
+    kubeyaml_free(arena);
+}
+
+static kubeconfig_arena_chunk_t *arena_chunk_create(size_t size)
+{
+    kubeconfig_arena_chunk_t *chunk = NULL;
+
+    if (size > SIZE_MAX - CHUNK_HEADER_SIZE) {
+        return NULL;
+    }
+    chunk = kubeyaml_malloc(CHUNK_HEADER_SIZE + size);
+    if (chunk) {
+        chunk->next = NULL;
+        chunk->size = size;
+        chunk->used = 0;
+        chunk->last = 0;
+    }
+    return chunk;
+}
+
+/* Allocate size bytes at an offset of the chunk aligned to align, a power of 2, not set to zero. */
+static void *arena_bump(kubeconfig_arena_t * arena, size_t size, size_t align)
+{
+    kubeconfig_arena_chunk_t *chunk = arena->chunks;
+    size_t offset = 0;
+
+    if (size > SIZE_MAX - ARENA_ALIGNMENT) {
+        return NULL;
+    }
+    size = size ? size : 1;
+    if (chunk) {
+        offset = (chunk->used + align - 1) & ~(align - 1);
+    }
+
+    if (!chunk || offset > chunk->size || chunk->size - offset < size) {
+        if (size > arena->next_size / 4) {
+            /* A large allocation gets a chunk of its own, behind the current one. */
+            chunk = arena_chunk_create(size);
+            if (!chunk) {
+                return NULL;
+            }
+            chunk->used = size;
+            if (arena->chunks) {
+                chunk->next = arena->chunks->next;
+                arena->chunks->next = chunk;
+            } else {
+                arena->chunks = chunk;
+            }
+            return CHUNK_DATA(chunk);
+        }
+
+        chunk = arena_chunk_create(arena->next_size);
+        if (!chunk) {
+            return NULL;
+        }
+        chunk->next = arena->chunks;
+        arena->chunks = chunk;
+        if (arena->next_size < KUBECONFIG_ARENA_CHUNK_MAX) {
+            arena->next_size *= 2;
+        }
+        offset = 0;
+    }
+
+    chunk->last = offset;
+    chunk->used = offset + size;
+    return CHUNK_DATA(chunk) + offset;
+}
+
+void *kubeconfig_arena_alloc(kubeconfig_arena_t * arena, size_t size)
+{
+    void *ptr = arena_bump(arena, size, ARENA_ALIGNMENT);
+    if (ptr) {
+        memset(ptr, 0, size);
+    }
+    return ptr;
+}
+
+void *kubeconfig_arena_realloc(kubeconfig_arena_t * arena, void *ptr, size_t old_size, size_t size)
+{
+    kubeconfig_arena_chunk_t *chunk = arena->chunks;
+    void *grown = NULL;
+
+    if (ptr && chunk && (unsigned char *) ptr == CHUNK_DATA(chunk) + chunk->last && chunk->size - chunk->last >= size) {
+        chunk->used = chunk->last + (size ? size : 1);
+        return ptr;
+    }
+
+    grown = arena_bump(arena, size, ARENA_ALIGNMENT);
+    if (grown && ptr) {
+        memcpy(grown, ptr, old_size < size ? old_size : size);
+    }
+    return grown;
+}
+
+char *kubeconfig_arena_strndup(kubeconfig_arena_t * arena, const char *string, size_t length)
+{
+    char *copy = NULL;
+
+    if (length == SIZE_MAX) {
+        return NULL;
+    }
+    /* Strings need no alignment, they are packed. */
+    copy = arena_bump(arena, length + 1, 1);
+    if (copy) {
+        memcpy(copy, string, length);
+        copy[length] = '\0';
+    }
+    return copy;
+}
+
+int kubeconfig_arena_reserve(kubeconfig_arena_t * arena, size_t size)
+{
+    kubeconfig_arena_chunk_t *chunk = arena->chunks;
+
+    if (!size || (chunk && chunk->size - chunk->used >= size)) {
+        return 0;
+    }
+    chunk = arena_chunk_create(size);
+    if (!chunk) {
+        return -1;
+    }
+    chunk->next = arena->chunks;
+    arena->chunks = chunk;
+    return 0;
+}
+
+int kubeconfig_arena_owns(const kubeconfig_arena_t * arena, const void *ptr)
+{
+    uintptr_t address = (uintptr_t) ptr;
+
+    if (!arena) {
+        return 0;
+    }
+
+    for (const kubeconfig_arena_chunk_t * chunk = arena->chunks; chunk; chunk = chunk->next) {
+        uintptr_t data = (uintptr_t) CHUNK_DATA(chunk);
+        if (address >= data && address - data < chunk->size) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+void kubeconfig_arena_merge(kubeconfig_arena_t * arena, kubeconfig_arena_t * from)
+{
+    kubeconfig_arena_chunk_t *tail = NULL;
+
+    if (!from || !from->chunks) {
+        return;
+    }
+
+    if (!arena->chunks) {
+        arena->chunks = from->chunks;
+    } else {
+        /* Behind the current chunk of arena, which keeps taking the allocations. */
+        for (tail = from->chunks; tail->next; tail = tail->next) {
+        }
+        tail->next = arena->chunks->next;
+        arena->chunks->next = from->chunks;
+    }
+    from->chunks = NULL;
+}
@@ -0,0 +1,67 @@
+#ifndef _KUBE_CONFIG_ARENA_H
+#define _KUBE_CONFIG_ARENA_H
+
+#include <stddef.h>
+
+#ifdef  __cplusplus
+extern "C" {
+#endif
+
+/*
+ * An arena holds many small allocations in a few large chunks. An
+ * allocation only moves a pointer forward in the current chunk, the memory
+ * is not freed one allocation at a time but all at once with the arena.
+ *
+ * The chunks double in size, up to KUBECONFIG_ARENA_CHUNK_MAX, so that a
+ * large kubeconfig needs a handful of them and kubeconfig_arena_owns()
+ * stays cheap. An allocation larger than a chunk gets a chunk of its own.
+ *
+ * An arena is not thread-safe, each thread allocates from its own arena
+ * and kubeconfig_arena_merge() gathers them afterwards.
+ */
+
+#define KUBECONFIG_ARENA_CHUNK_MIN (16 * 1024)
+#define KUBECONFIG_ARENA_CHUNK_MAX (4 * 1024 * 1024)
+#define KUBECONFIG_ARENA_ALIGNMENT 16   /* of the allocations but strings */
+
+    typedef struct kubeconfig_arena_chunk_t kubeconfig_arena_chunk_t;
+
+    typedef struct kubeconfig_arena_t {
+        kubeconfig_arena_chunk_t *chunks;       /* the current chunk first */
+        size_t next_size;       /* size of the next chunk */
+    } kubeconfig_arena_t;
+
+    kubeconfig_arena_t *kubeconfig_arena_create();
+    void kubeconfig_arena_free(kubeconfig_arena_t * arena);
+
+/* Allocate size bytes set to zero, NULL if the memory cannot be allocated. */
+    void *kubeconfig_arena_alloc(kubeconfig_arena_t * arena, size_t size);
+
+/*
+ * Grow the allocation ptr of old_size bytes to size bytes, in place when it
+ * is the last allocation of the arena. Like realloc(), ptr may be NULL and
+ * it is left as it is when the memory cannot be allocated. The new bytes
+ * are not set to zero.
+ */
+    void *kubeconfig_arena_realloc(kubeconfig_arena_t * arena, void *ptr, size_t old_size, size_t size);
+
+/* Copy the length bytes at string and a terminating NUL, not aligned. */
+    char *kubeconfig_arena_strndup(kubeconfig_arena_t * arena, const char *string, size_t length);
+
+/*
+ * Make room for size bytes in the current chunk, alignment included, so
+ * that the next allocations of a known total size take one chunk of that
+ * size. 0 on success, -1 if the memory cannot be allocated.
+ */
+    int kubeconfig_arena_reserve(kubeconfig_arena_t * arena, size_t size);
+
+/* 1 if ptr was allocated from the arena, 0 otherwise. arena may be NULL. */
+    int kubeconfig_arena_owns(const kubeconfig_arena_t * arena, const void *ptr);
+
+/* Move the chunks of from into arena, the allocations of from are then freed with arena. */
+    void kubeconfig_arena_merge(kubeconfig_arena_t * arena, kubeconfig_arena_t * from);
+
+#ifdef  __cplusplus
+}
+#endif
+#endif                          /* _KUBE_CONFIG_ARENA_H */
@@ -0,0 +1,168 @@
+#include <stdio.h>
+#include <string.h>
+#include "kube_config_base64.h"
+
+/* The table holds the value of a character plus one, 0 for the characters outside the alphabet. */
+#define BASE64_PAD 65
+#define BASE64_BLANK 66
+
+static const unsigned char base64_table[256] = {
+    ['A'] = 1, ['B'] = 2, ['C'] = 3, ['D'] = 4, ['E'] = 5, ['F'] = 6, ['G'] = 7, ['H'] = 8,
+    ['I'] = 9, ['J'] = 10, ['K'] = 11, ['L'] = 12, ['M'] = 13, ['N'] = 14, ['O'] = 15, ['P'] = 16,
+    ['Q'] = 17, ['R'] = 18, ['S'] = 19, ['T'] = 20, ['U'] = 21, ['V'] = 22, ['W'] = 23, ['X'] = 24,
+    ['Y'] = 25, ['Z'] = 26, ['a'] = 27, ['b'] = 28, ['c'] = 29, ['d'] = 30, ['e'] = 31, ['f'] = 32,
+    ['g'] = 33, ['h'] = 34, ['i'] = 35, ['j'] = 36, ['k'] = 37, ['l'] = 38, ['m'] = 39, ['n'] = 40,
+    ['o'] = 41, ['p'] = 42, ['q'] = 43, ['r'] = 44, ['s'] = 45, ['t'] = 46, ['u'] = 47, ['v'] = 48,
+    ['w'] = 49, ['x'] = 50, ['y'] = 51, ['z'] = 52, ['0'] = 53, ['1'] = 54, ['2'] = 55, ['3'] = 56,
+    ['4'] = 57, ['5'] = 58, ['6'] = 59, ['7'] = 60, ['8'] = 61, ['9'] = 62, ['+'] = 63, ['/'] = 64,
+    ['='] = BASE64_PAD, [' '] = BASE64_BLANK, ['\t'] = BASE64_BLANK, ['\r'] = BASE64_BLANK, ['\n'] = BASE64_BLANK
+};
+
+void kubeconfig_base64_init(kubeconfig_base64_t * decoder, const char *text, size_t length)
+{
+    memset(decoder, 0, sizeof(kubeconfig_base64_t));
+    decoder->p = text;
+    decoder->end = text + length;
+}
+
+/* Write the bytes of a group, those that do not fit in the buffer are kept for the next call. */
+static void base64_emit(kubeconfig_base64_t * decoder, unsigned char *buffer, size_t size, size_t *n, uint32_t group, int count)
+{
+    for (int i = 0; i < count; i++) {
+        unsigned char byte = (unsigned char) (group >> (16 - 8 * i));
+        if (*n < size) {
+            buffer[(*n)++] = byte;
+        } else {
+            decoder->pending[decoder->pending_count++] = byte;
+        }
+    }
+}
+
+/* The end of the text or the padding closes the last group, a single sextet is not a byte. */
+static int base64_finish(kubeconfig_base64_t * decoder, unsigned char *buffer, size_t size, size_t *n)
+{
+    switch (decoder->quad_count) {
+    case 0:
+        return 0;
+    case 2:
+        base64_emit(decoder, buffer, size, n, decoder->quad << 12, 1);
+        break;
+    case 3:
+        base64_emit(decoder, buffer, size, n, decoder->quad << 6, 2);
+        break;
+    default:
+        return -1;
+    }
+    decoder->quad = 0;
+    decoder->quad_count = 0;
+    return 0;
+}
+
+int kubeconfig_base64_decode(kubeconfig_base64_t * decoder, unsigned char *buffer, size_t size, size_t * size_read)
+{
+    static char fname[] = "kubeconfig_base64_decode()";
+
+    const unsigned char *p = (const unsigned char *) decoder->p;
+    const unsigned char *end = (const unsigned char *) decoder->end;
+    unsigned int a = 0, b = 0, c = 0, d = 0;
+    unsigned int v = 0;
+    size_t n = 0;
+
+    decoder->pending_start = 0;
+    while (n < size && decoder->pending_count) {
+        buffer[n++] = decoder->pending[decoder->pending_start++];
+        decoder->pending_count--;
+    }
+    if (decoder->pending_count) {
+        /* Keep the rest at the start of pending. */
+        memmove(decoder->pending, decoder->pending + decoder->pending_start, (size_t) decoder->pending_count);
+    }
+
+    while (n < size) {
+        /* Whole groups without blanks, the bulk of the text */
+        if (0 == decoder->quad_count) {
+            while (end - p >= 4 && size - n >= 3) {
+                a = base64_table[p[0]] - 1u;
+                b = base64_table[p[1]] - 1u;
+                c = base64_table[p[2]] - 1u;
+                d = base64_table[p[3]] - 1u;
+                if ((a | b | c | d) > 63) {
+                    break;
+                }
+                v = a << 18 | b << 12 | c << 6 | d;
+                buffer[n] = (unsigned char) (v >> 16);
+                buffer[n + 1] = (unsigned char) (v >> 8);
+                buffer[n + 2] = (unsigned char) v;
+                n += 3;
+                p += 4;
+            }
+        }
+
+        if (p == end) {
+            if (0 != base64_finish(decoder, buffer, size, &n)) {
+                goto invalid;
+            }
+            break;
+        }
+
+        v = base64_table[*p++];
+        if (BASE64_BLANK == v) {
+            continue;
+        }
+        if (BASE64_PAD == v) {
+            if (decoder->quad_count < 2 || 0 != base64_finish(decoder, buffer, size, &n)) {
+                goto invalid;
+            }
+            /* Only padding and blanks may follow. */
+            while (p < end && (BASE64_PAD == base64_table[*p] || BASE64_BLANK == base64_table[*p])) {
+                p++;
+            }
+            if (p != end) {
+                goto invalid;
+            }
+            break;
+        }
+        if (0 == v) {
+            goto invalid;
+        }
+        decoder->quad = decoder->quad << 6 | (v - 1);
+        if (4 == ++decoder->quad_count) {
+            base64_emit(decoder, buffer, size, &n, decoder->quad, 3);
+            decoder->quad = 0;
+            decoder->quad_count = 0;
+        }
+    }
+
+    decoder->p = (const char *) p;
+    *size_read = n;
+    return 0;
+
+  invalid:
+    fprintf(stderr, "%s: The base64 text is invalid.\n", fname);
+    *size_read = 0;
+    return -1;
+}
+
+void kubeconfig_base64_encode(const unsigned char *data, size_t length, char *text)
+{
+    static const char alphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+    uint32_t v = 0;
+    size_t i = 0;
+
+    for (i = 0; i + 3 <= length; i += 3) {
+        v = (uint32_t) data[i] << 16 | (uint32_t) data[i + 1] << 8 | data[i + 2];
+        *text++ = alphabet[v >> 18];
+        *text++ = alphabet[(v >> 12) & 63];
+        *text++ = alphabet[(v >> 6) & 63];
+        *text++ = alphabet[v & 63];
+    }
+    if (i < length) {
+        v = (uint32_t) data[i] << 16 | (i + 1 < length ? (uint32_t) data[i + 1] << 8 : 0);
+        *text++ = alphabet[v >> 18];
+        *text++ = alphabet[(v >> 12) & 63];
+        *text++ = i + 1 < length ? alphabet[(v >> 6) & 63] : '=';
+        *text++ = '=';
+    }
+    *text = '\0';
+}
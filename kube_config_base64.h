@@ -0,0 +1,72 @@
+#ifndef _KUBE_CONFIG_BASE64_H
+#define _KUBE_CONFIG_BASE64_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef  __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Incremental decoder of the standard base64 alphabet, e.g. the data of a
+ * Secret or the *-data fields of a kubeconfig. The text is decoded in
+ * place into the caller's buffer as it is needed, line breaks and blanks
+ * are ignored and the padding is optional. kubeconfig_base64_encode()
+ * writes the text of decoded bytes back.
+ */
+
+    typedef struct kubeconfig_base64_t {
+        const char *p;          /* next character of the text */
+        const char *end;
+        uint32_t quad;          /* sextets of an incomplete group */
+        int quad_count;
+        unsigned char pending[3];       /* bytes of the last group that did not fit in the buffer */
+        int pending_start;
+        int pending_count;
+    } kubeconfig_base64_t;
+
+    void kubeconfig_base64_init(kubeconfig_base64_t * decoder, const char *text, size_t length);
+
+/*
+ * kubeconfig_base64_decode
+ *
+ * Description:
+ *
+ * Decode the next bytes of the text into buffer.
+ *
+ * Return:
+ *
+ *   0     Success, *size_read is 0 at the end of the text
+ *  -1     Failed, the text is not valid base64
+ *
+ * Parameter:
+ *
+ * IN:
+ * decoder: decoder initialized by kubeconfig_base64_init()
+ * size: size of buffer in bytes
+ *
+ * OUT:
+ * buffer: filled with at most size decoded bytes
+ * size_read: number of bytes written to buffer
+ *
+ */
+    int kubeconfig_base64_decode(kubeconfig_base64_t * decoder, unsigned char *buffer, size_t size, size_t * size_read);
+
+/* Length of the base64 text of length bytes, padding included, NUL excluded. */
+#define KUBECONFIG_BASE64_ENCODED_LENGTH(length) (((length) + 2) / 3 * 4)
+
+/* Largest number of bytes the base64 text of length characters decodes to. */
+#define KUBECONFIG_BASE64_DECODED_LENGTH(length) ((length) / 4 * 3 + 3)
+
+/*
+ * Encode the length bytes at data into text, with padding and without line
+ * breaks. text must hold KUBECONFIG_BASE64_ENCODED_LENGTH(length) + 1
+ * characters, it is NUL-terminated.
+ */
+    void kubeconfig_base64_encode(const unsigned char *data, size_t length, char *text);
+
+#ifdef  __cplusplus
+}
+#endif
+#endif                          /* _KUBE_CONFIG_BASE64_H */
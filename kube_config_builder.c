@@ -0,0 +1,510 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "kube_config_builder.h"
+#include "kube_config_alloc.h"
+
+typedef enum kubeconfig_builder_node_type_t {
+    KUBECONFIG_BUILDER_NODE_SCALAR = 1,
+    KUBECONFIG_BUILDER_NODE_MAPPING,
+    KUBECONFIG_BUILDER_NODE_SEQUENCE
+} kubeconfig_builder_node_type_t;
+
+static char *builder_string(kubeconfig_builder_t * builder, const char *value, size_t length, char **owned)
+{
+    char *string = NULL;
+
+    if (owned && *owned) {
+        string = *owned;
+        *owned = NULL;
+        return string;
+    }
+
+    return kubeconfig_strndup(builder->kubeconfig, value, length);
+}
+
+static int builder_set_string(kubeconfig_builder_t * builder, char **p_field, const char *value, size_t length, char **owned, int interned)
+{
+    static char fname[] = "kubeconfig_builder_set_string()";
+
+    char *string = NULL;
+
+    if (interned && builder->kubeconfig->strings) {
+        string = kubeconfig_intern(builder->kubeconfig, value, length);
+    } else {
+        string = builder_string(builder, value, length, owned);
+    }
+    if (!string) {
+        fprintf(stderr, "%s: Cannot allocate memory for kubeconfig string.\n", fname);
+        return -1;
+    }
+
+    if (*p_field) {
+        kubeconfig_string_free(builder->kubeconfig, *p_field);
+    }
+    *p_field = string;
+
+    return 0;
+}
+
+/* The arrays of kubeconfig grow in its arena if it has one, the frames (kubeconfig NULL) on the heap. */
+static void *builder_grow(kubeconfig_t * kubeconfig, void *array, int count, int *p_capacity, size_t item_size)
+{
+    void *grown = NULL;
+    int capacity = 0;
+
+    if (count < *p_capacity) {
+        return array;
+    }
+
+    capacity = *p_capacity ? *p_capacity * 2 : 4;
+    grown = kubeconfig_realloc(kubeconfig, array, *p_capacity * item_size, capacity * item_size);
+    if (!grown) {
+        return NULL;
+    }
+    *p_capacity = capacity;
+
+    return grown;
+}
+
+static kubeconfig_builder_frame_t *builder_push(kubeconfig_builder_t * builder, kubeconfig_builder_frame_type_t type)
+{
+    static char fname[] = "kubeconfig_builder_push()";
+
+    kubeconfig_builder_frame_t *frames = NULL;
+    kubeconfig_builder_frame_t *frame = NULL;
+
+    frames = builder_grow(NULL, builder->frames, builder->frames_count, &builder->frames_capacity, sizeof(kubeconfig_builder_frame_t));
+    if (!frames) {
+        fprintf(stderr, "%s: Cannot allocate memory for kubeconfig builder frame.\n", fname);
+        return NULL;
+    }
+    builder->frames = frames;
+
+    frame = &builder->frames[builder->frames_count++];
+    memset(frame, 0, sizeof(kubeconfig_builder_frame_t));
+    frame->type = type;
+
+    return frame;
+}
+
+static int builder_push_skip(kubeconfig_builder_t * builder)
+{
+    return builder_push(builder, KUBECONFIG_BUILDER_FRAME_SKIP) ? 0 : -1;
+}
+
+static void builder_pop(kubeconfig_builder_t * builder)
+{
+    builder->frames_count--;
+}
+
+static int builder_push_properties(kubeconfig_builder_t * builder, kubeconfig_property_t *** p_properties, int *p_properties_count, kubeconfig_property_type_t type)
+{
+    static char fname[] = "kubeconfig_builder_push_properties()";
+
+    kubeconfig_builder_frame_t *frame = NULL;
+
+    /* A later document replaces the properties of an earlier one. */
+    if (*p_properties) {
+        kubeconfig_properties_release(builder->kubeconfig, *p_properties, *p_properties_count);
+        *p_properties = NULL;
+        *p_properties_count = 0;
+    }
+
+    frame = builder_push(builder, KUBECONFIG_BUILDER_FRAME_PROPERTIES);
+    if (!frame) {
+        return -1;
+    }
+    frame->property_type = type;
+    frame->p_properties = p_properties;
+    frame->p_count = p_properties_count;
+
+    /* Like with the tree loader, an empty sequence leaves an empty array that replaces the properties of an earlier document. */
+    if (!builder->projection || !builder->projection->visit) {
+        *p_properties = builder_grow(builder->kubeconfig, NULL, 0, &(frame->capacity), sizeof(kubeconfig_property_t *));
+        if (!*p_properties) {
+            fprintf(stderr, "%s: Cannot allocate memory for kubeconfig properties.\n", fname);
+            return -1;
+        }
+    }
+
+    return 0;
+}
+
+static int builder_push_property(kubeconfig_builder_t * builder, kubeconfig_property_t * property)
+{
+    kubeconfig_builder_frame_t *frame = builder_push(builder, KUBECONFIG_BUILDER_FRAME_PROPERTY);
+    if (!frame) {
+        return -1;
+    }
+    frame->property = property;
+
+    return 0;
+}
+
+static int builder_push_sub_property(kubeconfig_builder_t * builder, kubeconfig_property_t ** p_sub_property, kubeconfig_property_type_t type)
+{
+    static char fname[] = "kubeconfig_builder_push_sub_property()";
+
+    kubeconfig_property_t *sub_property = kubeconfig_property_alloc(builder->kubeconfig, type);
+    if (!sub_property) {
+        fprintf(stderr, "%s: Cannot allocate memory for kubeconfig property.\n", fname);
+        return -1;
+    }
+
+    if (*p_sub_property) {
+        kubeconfig_property_release(builder->kubeconfig, *p_sub_property);
+    }
+    *p_sub_property = sub_property;
+
+    return builder_push_property(builder, sub_property);
+}
+
+static int builder_top_value(kubeconfig_builder_t * builder, kubeconfig_key_t key, kubeconfig_builder_node_type_t node, const char *value, size_t length, char **owned)
+{
+    kubeconfig_t *kubeconfig = builder->kubeconfig;
+    const kubeconfig_field_t *field = kubeconfig_top_field_lookup(key);
+
+    if (KUBECONFIG_BUILDER_NODE_SCALAR == node) {
+        if (KUBECONFIG_FIELD_STRING == field->kind) {
+            return builder_set_string(builder, KUBECONFIG_FIELD_MEMBER(kubeconfig, field->offset, char *), value, length, owned, field->interned);
+        }
+        return 0;
+    }
+
+    if (KUBECONFIG_BUILDER_NODE_SEQUENCE == node && KUBECONFIG_FIELD_PROPERTIES == field->kind) {
+        /* clusters, contexts or users */
+        return builder_push_properties(builder, KUBECONFIG_FIELD_MEMBER(kubeconfig, field->offset, kubeconfig_property_t **), KUBECONFIG_FIELD_MEMBER(kubeconfig, field->count_offset, int), field->property_type);
+    }
+
+    return builder_push_skip(builder);
+}
+
+static int builder_property_value(kubeconfig_builder_t * builder, kubeconfig_property_t * property, kubeconfig_key_t key, kubeconfig_builder_node_type_t node, const char *value, size_t length, char **owned)
+{
+    kubeconfig_builder_frame_t *frame = NULL;
+    const kubeconfig_field_t *field = kubeconfig_projection_field_lookup(builder->projection, property->type, key);
+
+    if (KUBECONFIG_BUILDER_NODE_SCALAR == node) {
+        if (KUBECONFIG_FIELD_STRING == field->kind) {
+            return builder_set_string(builder, KUBECONFIG_FIELD_MEMBER(property, field->offset, char *), value, length, owned, field->interned);
+        }
+        return 0;
+    }
+
+    if (KUBECONFIG_FIELD_SKIPPED == field->kind) {
+        return builder_push_skip(builder);
+    }
+
+    if (KUBECONFIG_BUILDER_NODE_MAPPING == node) {
+        if (KUBECONFIG_FIELD_SUB_PROPERTY == field->kind) {
+            /* user exec or auth provider */
+            return builder_push_sub_property(builder, KUBECONFIG_FIELD_MEMBER(property, field->offset, kubeconfig_property_t *), field->property_type);
+        }
+        /* e.g. the 'cluster', 'context' and 'user' mappings fill the property itself */
+        return builder_push_property(builder, property);
+    }
+
+    if (KUBECONFIG_FIELD_PAIRS == field->kind) {
+        keyValuePair_t ***p_pairs = KUBECONFIG_FIELD_MEMBER(property, field->offset, keyValuePair_t **);
+        int *p_count = KUBECONFIG_FIELD_MEMBER(property, field->count_offset, int);
+        kubeconfig_string_map_list_release(builder->kubeconfig, *p_pairs, *p_count);
+        *p_pairs = NULL;
+        *p_count = 0;
+        frame = builder_push(builder, KUBECONFIG_BUILDER_FRAME_PAIRS);
+        if (!frame) {
+            return -1;
+        }
+        frame->p_pairs = p_pairs;
+        frame->p_count = p_count;
+        return 0;
+    } else if (KUBECONFIG_FIELD_STRINGS == field->kind) {
+        char ***p_strings = KUBECONFIG_FIELD_MEMBER(property, field->offset, char **);
+        int *p_count = KUBECONFIG_FIELD_MEMBER(property, field->count_offset, int);
+        kubeconfig_string_list_release(builder->kubeconfig, *p_strings, *p_count);
+        *p_strings = NULL;
+        *p_count = 0;
+        frame = builder_push(builder, KUBECONFIG_BUILDER_FRAME_STRINGS);
+        if (!frame) {
+            return -1;
+        }
+        frame->p_strings = p_strings;
+        frame->p_count = p_count;
+        return 0;
+    }
+
+    return builder_push_skip(builder);
+}
+
+static int builder_pair_value(kubeconfig_builder_t * builder, keyValuePair_t * pair, kubeconfig_key_t key, kubeconfig_builder_node_type_t node, const char *value, size_t length, char **owned)
+{
+    if (KUBECONFIG_BUILDER_NODE_SCALAR != node) {
+        return builder_push_skip(builder);
+    }
+
+    switch (key) {
+    case KUBECONFIG_KEY_USER_EXEC_ENV_KEY:
+        return builder_set_string(builder, &(pair->key), value, length, owned, 0);
+    case KUBECONFIG_KEY_USER_EXEC_ENV_VALUE:
+        return builder_set_string(builder, (char **) &(pair->value), value, length, owned, 0);
+    default:
+        return 0;
+    }
+}
+
+static int builder_property_item(kubeconfig_builder_t * builder, kubeconfig_builder_frame_t * frame, kubeconfig_builder_node_type_t node)
+{
+    static char fname[] = "kubeconfig_builder_property_item()";
+
+    kubeconfig_property_t **properties = NULL;
+    kubeconfig_property_t *property = NULL;
+
+    /* An entry handed to the visitor when its mapping ends must be a mapping. */
+    if (KUBECONFIG_BUILDER_NODE_MAPPING != node && builder->projection && builder->projection->visit) {
+        return (KUBECONFIG_BUILDER_NODE_SCALAR == node) ? 0 : builder_push_skip(builder);
+    }
+
+    property = kubeconfig_property_alloc(builder->kubeconfig, frame->property_type);
+    if (!property) {
+        fprintf(stderr, "%s: Cannot allocate memory for kubeconfig property.\n", fname);
+        return -1;
+    }
+    if (builder->projection && builder->projection->visit) {
+        /* Held by the builder until its mapping ends, it is not added to the kubeconfig. */
+        builder->entry = property;
+        return builder_push_property(builder, property);
+    }
+    properties = builder_grow(builder->kubeconfig, *(frame->p_properties), *(frame->p_count), &(frame->capacity), sizeof(kubeconfig_property_t *));
+    if (!properties) {
+        fprintf(stderr, "%s: Cannot allocate memory for kubeconfig properties.\n", fname);
+        kubeconfig_property_release(builder->kubeconfig, property);
+        return -1;
+    }
+    properties[*(frame->p_count)] = property;
+    *(frame->p_properties) = properties;
+    (*(frame->p_count))++;
+
+    /* Like with the tree loader, an entry that is not a mapping is an empty property. */
+    if (KUBECONFIG_BUILDER_NODE_SCALAR == node) {
+        return 0;
+    } else if (KUBECONFIG_BUILDER_NODE_SEQUENCE == node) {
+        return builder_push_skip(builder);
+    }
+
+    return builder_push_property(builder, property);
+}
+
+static int builder_string_item(kubeconfig_builder_t * builder, kubeconfig_builder_frame_t * frame, kubeconfig_builder_node_type_t node, const char *value, size_t length, char **owned)
+{
+    static char fname[] = "kubeconfig_builder_string_item()";
+
+    char **strings = NULL;
+    char *string = NULL;
+
+    if (KUBECONFIG_BUILDER_NODE_SCALAR != node) {
+        return builder_push_skip(builder);
+    }
+
+    strings = builder_grow(builder->kubeconfig, *(frame->p_strings), *(frame->p_count), &(frame->capacity), sizeof(char *));
+    if (!strings) {
+        fprintf(stderr, "%s: Cannot allocate memory for string sequence.\n", fname);
+        return -1;
+    }
+    *(frame->p_strings) = strings;
+
+    string = builder_string(builder, value, length, owned);
+    if (!string) {
+        fprintf(stderr, "%s: Cannot allocate memory for string.\n", fname);
+        return -1;
+    }
+    strings[*(frame->p_count)] = string;
+    (*(frame->p_count))++;
+
+    return 0;
+}
+
+static int builder_pair_item(kubeconfig_builder_t * builder, kubeconfig_builder_frame_t * frame, kubeconfig_builder_node_type_t node)
+{
+    static char fname[] = "kubeconfig_builder_pair_item()";
+
+    keyValuePair_t **pairs = NULL;
+    keyValuePair_t *pair = NULL;
+
+    /* Like with the tree loader, an entry that is not a mapping is an empty pair. */
+    pairs = builder_grow(builder->kubeconfig, *(frame->p_pairs), *(frame->p_count), &(frame->capacity), sizeof(keyValuePair_t *));
+    if (!pairs) {
+        fprintf(stderr, "%s: Cannot allocate memory for string mappings.\n", fname);
+        return -1;
+    }
+    *(frame->p_pairs) = pairs;
+
+    pair = kubeconfig_alloc(builder->kubeconfig, sizeof(keyValuePair_t));
+    if (!pair) {
+        fprintf(stderr, "%s: Cannot allocate memory for string mapping.\n", fname);
+        return -1;
+    }
+    pairs[*(frame->p_count)] = pair;
+    (*(frame->p_count))++;
+
+    if (KUBECONFIG_BUILDER_NODE_SCALAR == node) {
+        return 0;
+    } else if (KUBECONFIG_BUILDER_NODE_SEQUENCE == node) {
+        return builder_push_skip(builder);
+    }
+
+    frame = builder_push(builder, KUBECONFIG_BUILDER_FRAME_PAIR);
+    if (!frame) {
+        return -1;
+    }
+    frame->pair = pair;
+
+    return 0;
+}
+
+static int builder_mapping_value(kubeconfig_builder_t * builder, kubeconfig_builder_frame_t * frame, kubeconfig_builder_node_type_t node, const char *value, size_t length, char **owned)
+{
+    /* The frame may move when the value pushes a new one, consume the key first. */
+    frame->has_key = 0;
+
+    if (KUBECONFIG_BUILDER_FRAME_TOP == frame->type) {
+        return builder_top_value(builder, frame->key, node, value, length, owned);
+    } else if (KUBECONFIG_BUILDER_FRAME_PROPERTY == frame->type) {
+        return builder_property_value(builder, frame->property, frame->key, node, value, length, owned);
+    }
+    return builder_pair_value(builder, frame->pair, frame->key, node, value, length, owned);
+}
+
+static int builder_node(kubeconfig_builder_t * builder, kubeconfig_builder_node_type_t node, const char *value, size_t length, char **owned)
+{
+    static char fname[] = "kubeconfig_builder_node()";
+
+    kubeconfig_builder_frame_t *frame = NULL;
+
+    if (0 == builder->frames_count) {
+        if (KUBECONFIG_BUILDER_NODE_MAPPING == node) {
+            return builder_push(builder, KUBECONFIG_BUILDER_FRAME_TOP) ? 0 : -1;
+        } else if (KUBECONFIG_BUILDER_NODE_SCALAR == node && 0 == length) {
+            /* empty document */
+            return 0;
+        }
+        fprintf(stderr, "%s: %s is not a valid kubeconfig file.\n", fname, builder->kubeconfig->fileName ? builder->kubeconfig->fileName : "The input");
+        return -1;
+    }
+
+    frame = &builder->frames[builder->frames_count - 1];
+
+    switch (frame->type) {
+    case KUBECONFIG_BUILDER_FRAME_TOP:
+    case KUBECONFIG_BUILDER_FRAME_PROPERTY:
+    case KUBECONFIG_BUILDER_FRAME_PAIR:
+        if (frame->has_key) {
+            return builder_mapping_value(builder, frame, node, value, length, owned);
+        }
+        if (KUBECONFIG_BUILDER_NODE_SCALAR != node) {
+            fprintf(stderr, "%s: The key node is not a scalar.\n", fname);
+            return -1;
+        }
+        frame->has_key = 1;
+        frame->key = kubeconfig_key_lookup(value, length);
+        return 0;
+    case KUBECONFIG_BUILDER_FRAME_PROPERTIES:
+        return builder_property_item(builder, frame, node);
+    case KUBECONFIG_BUILDER_FRAME_STRINGS:
+        return builder_string_item(builder, frame, node, value, length, owned);
+    case KUBECONFIG_BUILDER_FRAME_PAIRS:
+        return builder_pair_item(builder, frame, node);
+    case KUBECONFIG_BUILDER_FRAME_SKIP:
+        return (KUBECONFIG_BUILDER_NODE_SCALAR == node) ? 0 : builder_push_skip(builder);
+    }
+
+    return 0;
+}
+
+static int builder_visit(kubeconfig_builder_t * builder)
+{
+    int rc = builder->projection->visit(builder->projection->visit_data, builder->entry);
+
+    kubeconfig_property_release(builder->kubeconfig, builder->entry);
+    builder->entry = NULL;
+
+    return rc ? KUBECONFIG_BUILDER_STOPPED : 0;
+}
+
+static int builder_end(kubeconfig_builder_t * builder, kubeconfig_builder_node_type_t node)
+{
+    static char fname[] = "kubeconfig_builder_end()";
+
+    kubeconfig_builder_frame_t *frame = NULL;
+    int is_mapping = 0;
+
+    if (0 == builder->frames_count) {
+        fprintf(stderr, "%s: Unbalanced end of collection.\n", fname);
+        return -1;
+    }
+
+    frame = &builder->frames[builder->frames_count - 1];
+    if (KUBECONFIG_BUILDER_FRAME_SKIP != frame->type) {
+        is_mapping = (KUBECONFIG_BUILDER_FRAME_TOP == frame->type ||
+                      KUBECONFIG_BUILDER_FRAME_PROPERTY == frame->type || KUBECONFIG_BUILDER_FRAME_PAIR == frame->type);
+        if (is_mapping != (KUBECONFIG_BUILDER_NODE_MAPPING == node)) {
+            fprintf(stderr, "%s: Unbalanced end of collection.\n", fname);
+            return -1;
+        }
+    }
+
+    builder_pop(builder);
+
+    /* The mapping of a complete entry, the frame below it is its sequence. */
+    if (builder->entry && KUBECONFIG_BUILDER_FRAME_PROPERTY == frame->type && builder->entry == frame->property
+        && builder->frames_count > 0 && KUBECONFIG_BUILDER_FRAME_PROPERTIES == builder->frames[builder->frames_count - 1].type) {
+        return builder_visit(builder);
+    }
+    return 0;
+}
+
+void kubeconfig_builder_init(kubeconfig_builder_t * builder, kubeconfig_t * kubeconfig)
+{
+    memset(builder, 0, sizeof(kubeconfig_builder_t));
+    builder->kubeconfig = kubeconfig;
+}
+
+void kubeconfig_builder_clear(kubeconfig_builder_t * builder)
+{
+    while (builder->frames_count > 0) {
+        builder_pop(builder);
+    }
+    if (builder->frames) {
+        kubeyaml_free(builder->frames);
+        builder->frames = NULL;
+    }
+    builder->frames_capacity = 0;
+    if (builder->entry) {
+        kubeconfig_property_release(builder->kubeconfig, builder->entry);
+        builder->entry = NULL;
+    }
+}
+
+int kubeconfig_builder_mapping_start(kubeconfig_builder_t * builder)
+{
+    return builder_node(builder, KUBECONFIG_BUILDER_NODE_MAPPING, NULL, 0, NULL);
+}
+
+int kubeconfig_builder_mapping_end(kubeconfig_builder_t * builder)
+{
+    return builder_end(builder, KUBECONFIG_BUILDER_NODE_MAPPING);
+}
+
+int kubeconfig_builder_sequence_start(kubeconfig_builder_t * builder)
+{
+    return builder_node(builder, KUBECONFIG_BUILDER_NODE_SEQUENCE, NULL, 0, NULL);
+}
+
+int kubeconfig_builder_sequence_end(kubeconfig_builder_t * builder)
+{
+    return builder_end(builder, KUBECONFIG_BUILDER_NODE_SEQUENCE);
+}
+
+int kubeconfig_builder_scalar(kubeconfig_builder_t * builder, const char *value, size_t length, char **owned)
+{
+    return builder_node(builder, KUBECONFIG_BUILDER_NODE_SCALAR, value, length, owned);
+}
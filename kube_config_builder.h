@@ -0,0 +1,87 @@
+#ifndef _KUBE_CONFIG_BUILDER_H
+#define _KUBE_CONFIG_BUILDER_H
+
+#include <stddef.h>
+#include "kube_config_model.h"
+#include "kube_config_keys.h"
+#include "kube_config_projection.h"
+
+#ifdef  __cplusplus
+extern "C" {
+#endif
+
+/*
+ * The kubeconfig builder fills a kubeconfig_t directly from a stream of
+ * parser events (mapping start/end, sequence start/end and scalars), so a
+ * document can be loaded without building an intermediate node tree first.
+ *
+ * The events follow the grammar of the libyaml event stream:
+ *
+ * document :: = node
+ * node :: = SCALAR | sequence | mapping
+ * sequence :: = SEQUENCE - START node * SEQUENCE - END
+ * mapping :: = MAPPING - START(node node) * MAPPING - END
+ *
+ * Several documents may be fed one after the other, they are merged into
+ * the same kubeconfig like kubeyaml_load_kubeconfig() does.
+ */
+
+    typedef enum kubeconfig_builder_frame_type_t {
+        KUBECONFIG_BUILDER_FRAME_TOP = 1,       /* top mapping of a document */
+        KUBECONFIG_BUILDER_FRAME_PROPERTIES,    /* sequence of clusters, contexts or users */
+        KUBECONFIG_BUILDER_FRAME_PROPERTY,      /* mapping filling one property */
+        KUBECONFIG_BUILDER_FRAME_STRINGS,       /* sequence of strings (user exec args) */
+        KUBECONFIG_BUILDER_FRAME_PAIRS, /* sequence of name/value pairs (user exec env) */
+        KUBECONFIG_BUILDER_FRAME_PAIR,  /* mapping filling one name/value pair */
+        KUBECONFIG_BUILDER_FRAME_SKIP   /* collection the kubeconfig does not use */
+    } kubeconfig_builder_frame_type_t;
+
+    typedef struct kubeconfig_builder_frame_t {
+        kubeconfig_builder_frame_type_t type;
+        int has_key;            /* a mapping key is waiting for its value */
+        kubeconfig_key_t key;
+        kubeconfig_property_type_t property_type;       /* PROPERTIES */
+        kubeconfig_property_t ***p_properties;  /* PROPERTIES */
+        char ***p_strings;      /* STRINGS */
+        keyValuePair_t ***p_pairs;      /* PAIRS */
+        int *p_count;           /* PROPERTIES, STRINGS, PAIRS */
+        int capacity;           /* PROPERTIES, STRINGS, PAIRS */
+        kubeconfig_property_t *property;        /* PROPERTY */
+        keyValuePair_t *pair;   /* PAIR */
+    } kubeconfig_builder_frame_t;
+
+    typedef struct kubeconfig_builder_t {
+        kubeconfig_t *kubeconfig;
+        const kubeconfig_projection_t *projection;      /* fields to skip, NULL to fill all of them */
+        kubeconfig_builder_frame_t *frames;
+        int frames_count;
+        int frames_capacity;
+        kubeconfig_property_t *entry;   /* entry being filled for projection->visit */
+    } kubeconfig_builder_t;
+
+    void kubeconfig_builder_init(kubeconfig_builder_t * builder, kubeconfig_t * kubeconfig);
+    void kubeconfig_builder_clear(kubeconfig_builder_t * builder);
+
+    int kubeconfig_builder_mapping_start(kubeconfig_builder_t * builder);
+    int kubeconfig_builder_mapping_end(kubeconfig_builder_t * builder);
+    int kubeconfig_builder_sequence_start(kubeconfig_builder_t * builder);
+    int kubeconfig_builder_sequence_end(kubeconfig_builder_t * builder);
+
+/*
+ * The end of a collection returns KUBECONFIG_BUILDER_STOPPED when it
+ * completes an entry and projection->visit returns non-zero.
+ */
+#define KUBECONFIG_BUILDER_STOPPED 1
+
+/*
+ * value does not need to be NUL-terminated. If owned is not NULL, *owned is
+ * a heap copy of the scalar, or a NUL-terminated view into the retained
+ * buffer of the kubeconfig, the builder may keep instead of copying value.
+ * *owned is set to NULL when the builder takes it.
+ */
+    int kubeconfig_builder_scalar(kubeconfig_builder_t * builder, const char *value, size_t length, char **owned);
+
+#ifdef  __cplusplus
+}
+#endif
+#endif                          /* _KUBE_CONFIG_BUILDER_H */
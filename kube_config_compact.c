@@ -0,0 +1,572 @@
+#include <stdio.h>
+#include <string.h>
+#include "kube_config_compact.h"
+#include "kube_config_alloc.h"
+
+/*
+ * Copying
+ */
+
+typedef struct compact_builder_t {
+    kubeconfig_compact_t *compact;
+    kubeconfig_strings_t *names;        /* only needed while the names are copied */
+} compact_builder_t;
+
+/* Copy string into the arena of the compact kubeconfig, once if it is a name. 0 if a copy cannot be allocated. */
+static int compact_copy(compact_builder_t * builder, char **to, const char *string, int interned)
+{
+    if (!string) {
+        *to = NULL;
+        return 1;
+    }
+    if (interned) {
+        *to = kubeconfig_strings_intern(builder->names, string, strlen(string));
+    } else {
+        *to = kubeconfig_arena_strndup(builder->compact->arena, string, strlen(string));
+    }
+    return *to ? 1 : 0;
+}
+
+/* Copy a *-data field, the bytes of the kubeconfig_data_t when it is decoded. */
+static int compact_copy_data(compact_builder_t * builder, kubeconfig_data_t ** to, const kubeconfig_data_t * data)
+{
+    if (!data) {
+        *to = NULL;
+        return 1;
+    }
+    *to = kubeconfig_arena_alloc(builder->compact->arena, sizeof(kubeconfig_data_t) + data->length + 1);
+    if (*to) {
+        memcpy(*to, data, sizeof(kubeconfig_data_t) + data->length + 1);
+    }
+    return *to ? 1 : 0;
+}
+
+static int compact_copy_context(compact_builder_t * builder, kubeconfig_compact_context_t * context, const kubeconfig_property_t * property)
+{
+    return compact_copy(builder, &context->name, property->name, 1)
+        && compact_copy(builder, &context->cluster, property->cluster, 1)
+        && compact_copy(builder, &context->namespace, property->namespace, 1)
+        && compact_copy(builder, &context->user, property->user, 1);
+}
+
+static int compact_copy_cluster(compact_builder_t * builder, kubeconfig_compact_cluster_t * cluster, const kubeconfig_property_t * property)
+{
+    if (!compact_copy(builder, &cluster->name, property->name, 1) || !compact_copy(builder, &cluster->server, property->server, 0)) {
+        return 0;
+    }
+    if (builder->compact->data_decoded) {
+        return compact_copy_data(builder, &cluster->certificate_authority_data_decoded, property->certificate_authority_data_decoded);
+    }
+    return compact_copy(builder, &cluster->certificate_authority_data, property->certificate_authority_data, 0);
+}
+
+static int compact_copy_exec(compact_builder_t * builder, kubeconfig_compact_exec_t * exec, const kubeconfig_property_t * property)
+{
+    if (!compact_copy(builder, &exec->name, property->name, 0)
+        || !compact_copy(builder, &exec->command, property->command, 1)
+        || !compact_copy(builder, &exec->apiVersion, property->apiVersion, 1)) {
+        return 0;
+    }
+
+    if (property->envs && property->envs_count > 0) {
+        exec->envs = kubeconfig_arena_alloc(builder->compact->arena, property->envs_count * sizeof(keyValuePair_t));
+        if (!exec->envs) {
+            return 0;
+        }
+        for (int i = 0; i < property->envs_count; i++) {
+            char *value = NULL;
+            if (property->envs[i]
+                && (!compact_copy(builder, &exec->envs[i].key, property->envs[i]->key, 0)
+                    || !compact_copy(builder, &value, property->envs[i]->value, 0))) {
+                return 0;
+            }
+            exec->envs[i].value = value;
+        }
+        exec->envs_count = property->envs_count;
+    }
+
+    if (property->args && property->args_count > 0) {
+        exec->args = kubeconfig_arena_alloc(builder->compact->arena, property->args_count * sizeof(char *));
+        if (!exec->args) {
+            return 0;
+        }
+        for (int i = 0; i < property->args_count; i++) {
+            if (!compact_copy(builder, &exec->args[i], property->args[i], 0)) {
+                return 0;
+            }
+        }
+        exec->args_count = property->args_count;
+    }
+    return 1;
+}
+
+static int compact_copy_auth_provider(compact_builder_t * builder, kubeconfig_compact_auth_provider_t * auth_provider, const kubeconfig_property_t * property)
+{
+    return compact_copy(builder, &auth_provider->name, property->name, 1)
+        && compact_copy(builder, &auth_provider->access_token, property->access_token, 0)
+        && compact_copy(builder, &auth_provider->client_id, property->client_id, 0)
+        && compact_copy(builder, &auth_provider->client_secret, property->client_secret, 0)
+        && compact_copy(builder, &auth_provider->cmd_path, property->cmd_path, 0)
+        && compact_copy(builder, &auth_provider->expires_on, property->expires_on, 0)
+        && compact_copy(builder, &auth_provider->expiry, property->expiry, 0)
+        && compact_copy(builder, &auth_provider->id_token, property->id_token, 0)
+        && compact_copy(builder, &auth_provider->idp_certificate_authority_data, property->idp_certificate_authority_data, 0)
+        && compact_copy(builder, &auth_provider->idp_issuer_url, property->idp_issuer_url, 0)
+        && compact_copy(builder, &auth_provider->refresh_token, property->refresh_token, 0);
+}
+
+static int compact_copy_user(compact_builder_t * builder, kubeconfig_compact_user_t * user, const kubeconfig_property_t * property)
+{
+    if (!compact_copy(builder, &user->name, property->name, 1)
+        || !compact_copy(builder, &user->token, property->token, 0)
+        || !compact_copy(builder, &user->username, property->username, 0)
+        || !compact_copy(builder, &user->password, property->password, 0)) {
+        return 0;
+    }
+    if (builder->compact->data_decoded) {
+        if (!compact_copy_data(builder, &user->client_certificate_data_decoded, property->client_certificate_data_decoded)
+            || !compact_copy_data(builder, &user->client_key_data_decoded, property->client_key_data_decoded)) {
+            return 0;
+        }
+    } else if (!compact_copy(builder, &user->client_certificate_data, property->client_certificate_data, 0)
+               || !compact_copy(builder, &user->client_key_data, property->client_key_data, 0)) {
+        return 0;
+    }
+    user->insecure_skip_tls_verify = property->insecure_skip_tls_verify;
+
+    /* The arrays of exec and auth-provider entries are sized for all users. */
+    if (property->exec) {
+        user->exec = &builder->compact->execs[builder->compact->execs_count++];
+        if (!compact_copy_exec(builder, user->exec, property->exec)) {
+            return 0;
+        }
+    }
+    if (property->auth_provider) {
+        user->auth_provider = &builder->compact->auth_providers[builder->compact->auth_providers_count++];
+        if (!compact_copy_auth_provider(builder, user->auth_provider, property->auth_provider)) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+/* The array of count entries of size bytes, NULL for no entries. */
+static void *compact_array(kubeconfig_compact_t * compact, int count, size_t size)
+{
+    return count > 0 ? kubeconfig_arena_alloc(compact->arena, count * size) : NULL;
+}
+
+/*
+ * Sizing: the compact kubeconfig takes one chunk of its arena, reserved
+ * before the copy with room for the arrays, their alignment, and the
+ * strings that are not names. The names are interned in a chunk of their
+ * own.
+ */
+
+#define COMPACT_ARRAY_SIZE(count, size) ((count) > 0 ? (size_t) (count) * (size) + KUBECONFIG_ARENA_ALIGNMENT : 0)
+
+static size_t compact_string_size(const char *string)
+{
+    return string ? strlen(string) + 1 : 0;
+}
+
+/* A *-data field, its kubeconfig_data_t aligned like the arrays when it is decoded. */
+static size_t compact_data_size(const kubeconfig_t * kubeconfig, const char *field)
+{
+    const kubeconfig_data_t *data = (const kubeconfig_data_t *) field;
+
+    if (!kubeconfig->data_decoded) {
+        return compact_string_size(field);
+    }
+    return data ? sizeof(kubeconfig_data_t) + data->length + 1 + KUBECONFIG_ARENA_ALIGNMENT : 0;
+}
+
+static size_t compact_exec_size(const kubeconfig_property_t * exec)
+{
+    size_t size = compact_string_size(exec->name);
+
+    if (exec->envs && exec->envs_count > 0) {
+        size += COMPACT_ARRAY_SIZE(exec->envs_count, sizeof(keyValuePair_t));
+        for (int i = 0; i < exec->envs_count; i++) {
+            if (exec->envs[i]) {
+                size += compact_string_size(exec->envs[i]->key) + compact_string_size(exec->envs[i]->value);
+            }
+        }
+    }
+    if (exec->args && exec->args_count > 0) {
+        size += COMPACT_ARRAY_SIZE(exec->args_count, sizeof(char *));
+        for (int i = 0; i < exec->args_count; i++) {
+            size += compact_string_size(exec->args[i]);
+        }
+    }
+    return size;
+}
+
+static size_t compact_auth_provider_size(const kubeconfig_property_t * auth_provider)
+{
+    return compact_string_size(auth_provider->access_token) + compact_string_size(auth_provider->client_id)
+        + compact_string_size(auth_provider->client_secret) + compact_string_size(auth_provider->cmd_path)
+        + compact_string_size(auth_provider->expires_on) + compact_string_size(auth_provider->expiry)
+        + compact_string_size(auth_provider->id_token) + compact_string_size(auth_provider->idp_certificate_authority_data)
+        + compact_string_size(auth_provider->idp_issuer_url) + compact_string_size(auth_provider->refresh_token);
+}
+
+static size_t compact_size(const kubeconfig_t * kubeconfig, int execs_count, int auth_providers_count)
+{
+    size_t size = compact_string_size(kubeconfig->apiVersion) + compact_string_size(kubeconfig->preferences) + compact_string_size(kubeconfig->kind);
+
+    size += COMPACT_ARRAY_SIZE(kubeconfig->contexts_count, sizeof(kubeconfig_compact_context_t));
+    size += COMPACT_ARRAY_SIZE(kubeconfig->clusters_count, sizeof(kubeconfig_compact_cluster_t));
+    size += COMPACT_ARRAY_SIZE(kubeconfig->users_count, sizeof(kubeconfig_compact_user_t));
+    size += COMPACT_ARRAY_SIZE(execs_count, sizeof(kubeconfig_compact_exec_t));
+    size += COMPACT_ARRAY_SIZE(auth_providers_count, sizeof(kubeconfig_compact_auth_provider_t));
+
+    for (int i = 0; i < kubeconfig->clusters_count; i++) {
+        const kubeconfig_property_t *cluster = kubeconfig->clusters[i];
+        if (cluster) {
+            size += compact_string_size(cluster->server) + compact_data_size(kubeconfig, cluster->certificate_authority_data);
+        }
+    }
+    for (int i = 0; i < kubeconfig->users_count; i++) {
+        const kubeconfig_property_t *user = kubeconfig->users[i];
+        if (!user) {
+            continue;
+        }
+        size += compact_string_size(user->token) + compact_data_size(kubeconfig, user->client_certificate_data) + compact_data_size(kubeconfig, user->client_key_data)
+            + compact_string_size(user->username) + compact_string_size(user->password);
+        if (user->exec) {
+            size += compact_exec_size(user->exec);
+        }
+        if (user->auth_provider) {
+            size += compact_auth_provider_size(user->auth_provider);
+        }
+    }
+    return size;
+}
+
+static int compact_copy_kubeconfig(compact_builder_t * builder, const kubeconfig_t * kubeconfig)
+{
+    kubeconfig_compact_t *compact = builder->compact;
+    int execs_count = 0;
+    int auth_providers_count = 0;
+
+    compact->data_decoded = kubeconfig->data_decoded;
+
+    for (int i = 0; i < kubeconfig->users_count; i++) {
+        if (kubeconfig->users[i] && kubeconfig->users[i]->exec) {
+            execs_count++;
+        }
+        if (kubeconfig->users[i] && kubeconfig->users[i]->auth_provider) {
+            auth_providers_count++;
+        }
+    }
+    if (0 != kubeconfig_arena_reserve(compact->arena, compact_size(kubeconfig, execs_count, auth_providers_count))) {
+        return -1;
+    }
+
+    if (!compact_copy(builder, &compact->apiVersion, kubeconfig->apiVersion, 0)
+        || !compact_copy(builder, &compact->preferences, kubeconfig->preferences, 0)
+        || !compact_copy(builder, &compact->kind, kubeconfig->kind, 0)
+        || !compact_copy(builder, &compact->current_context, kubeconfig->current_context, 1)) {
+        return -1;
+    }
+
+    compact->contexts = compact_array(compact, kubeconfig->contexts_count, sizeof(kubeconfig_compact_context_t));
+    compact->clusters = compact_array(compact, kubeconfig->clusters_count, sizeof(kubeconfig_compact_cluster_t));
+    compact->users = compact_array(compact, kubeconfig->users_count, sizeof(kubeconfig_compact_user_t));
+    compact->execs = compact_array(compact, execs_count, sizeof(kubeconfig_compact_exec_t));
+    compact->auth_providers = compact_array(compact, auth_providers_count, sizeof(kubeconfig_compact_auth_provider_t));
+    if ((kubeconfig->contexts_count > 0 && !compact->contexts) || (kubeconfig->clusters_count > 0 && !compact->clusters)
+        || (kubeconfig->users_count > 0 && !compact->users) || (execs_count > 0 && !compact->execs)
+        || (auth_providers_count > 0 && !compact->auth_providers)) {
+        return -1;
+    }
+
+    /* An entry the load left NULL stays empty. */
+    for (int i = 0; i < kubeconfig->contexts_count; i++) {
+        if (kubeconfig->contexts[i] && !compact_copy_context(builder, &compact->contexts[i], kubeconfig->contexts[i])) {
+            return -1;
+        }
+    }
+    compact->contexts_count = kubeconfig->contexts_count > 0 ? kubeconfig->contexts_count : 0;
+    for (int i = 0; i < kubeconfig->clusters_count; i++) {
+        if (kubeconfig->clusters[i] && !compact_copy_cluster(builder, &compact->clusters[i], kubeconfig->clusters[i])) {
+            return -1;
+        }
+    }
+    compact->clusters_count = kubeconfig->clusters_count > 0 ? kubeconfig->clusters_count : 0;
+    for (int i = 0; i < kubeconfig->users_count; i++) {
+        if (kubeconfig->users[i] && !compact_copy_user(builder, &compact->users[i], kubeconfig->users[i])) {
+            return -1;
+        }
+    }
+    compact->users_count = kubeconfig->users_count > 0 ? kubeconfig->users_count : 0;
+    return 0;
+}
+
+kubeconfig_compact_t *kubeconfig_compact_create(const kubeconfig_t * kubeconfig)
+{
+    static char fname[] = "kubeconfig_compact_create()";
+
+    compact_builder_t builder;
+    int rc = 0;
+
+    if (!kubeconfig) {
+        fprintf(stderr, "%s: The kubeconfig is null.\n", fname);
+        return NULL;
+    }
+
+    memset(&builder, 0, sizeof(builder));
+    builder.compact = kubeyaml_calloc(1, sizeof(kubeconfig_compact_t));
+    if (!builder.compact) {
+        fprintf(stderr, "%s: Cannot allocate memory for the compact kubeconfig.\n", fname);
+        return NULL;
+    }
+    builder.compact->arena = kubeconfig_arena_create();
+    builder.names = kubeconfig_strings_create();
+    if (!builder.compact->arena || !builder.names || 0 != compact_copy_kubeconfig(&builder, kubeconfig)) {
+        fprintf(stderr, "%s: Cannot allocate memory for the entries of the compact kubeconfig.\n", fname);
+        rc = -1;
+    }
+
+    /* The names stay, the table to find them does not. */
+    if (builder.compact->arena && builder.names) {
+        kubeconfig_arena_merge(builder.compact->arena, builder.names->arena);
+    }
+    kubeconfig_strings_release(builder.names);
+    if (0 != rc) {
+        kubeconfig_compact_free(builder.compact);
+        return NULL;
+    }
+    return builder.compact;
+}
+
+void kubeconfig_compact_free(kubeconfig_compact_t * compact)
+{
+    if (!compact) {
+        return;
+    }
+
+    kubeconfig_arena_free(compact->arena);
+    compact->arena = NULL;
+
+    kubeyaml_free(compact);
+}
+
+kubeconfig_compact_t *kubeyaml_load_kubeconfig_compact(const char *fileName, const kubeyaml_load_options_t * options)
+{
+    static char fname[] = "kubeyaml_load_kubeconfig_compact()";
+
+    kubeyaml_load_options_t load_options;
+    kubeconfig_compact_t *compact = NULL;
+    kubeconfig_t *kubeconfig = NULL;
+
+    kubeconfig = kubeconfig_create();
+    if (!kubeconfig) {
+        fprintf(stderr, "%s: Cannot allocate memory for the kubeconfig.\n", fname);
+        return NULL;
+    }
+    if (fileName) {
+        kubeconfig->fileName = kubeyaml_strdup(fileName);
+        if (!kubeconfig->fileName) {
+            fprintf(stderr, "%s: Cannot allocate memory for the file name.\n", fname);
+            kubeconfig_free(kubeconfig);
+            return NULL;
+        }
+    }
+
+    if (options) {
+        memcpy(&load_options, options, sizeof(load_options));
+    } else {
+        memset(&load_options, 0, sizeof(load_options));
+    }
+    /* The kubeconfig is only a step to the compact one, freed at once. */
+    load_options.flags |= KUBEYAML_LOAD_ARENA;
+
+    if (0 != kubeyaml_load_kubeconfig_with_options(kubeconfig, &load_options)) {
+        fprintf(stderr, "%s: Cannot load the kubeconfig.\n", fname);
+        kubeconfig_free(kubeconfig);
+        return NULL;
+    }
+    compact = kubeconfig_compact_create(kubeconfig);
+    kubeconfig_free(kubeconfig);
+    return compact;
+}
+
+/*
+ * Adapter
+ */
+
+static void compact_expand_exec(kubeconfig_t * kubeconfig, kubeconfig_property_t * property, const kubeconfig_compact_exec_t * exec, int *rc)
+{
+    property->name = exec->name;
+    property->command = exec->command;
+    property->apiVersion = exec->apiVersion;
+    if (exec->envs_count > 0) {
+        property->envs = kubeconfig_alloc(kubeconfig, exec->envs_count * sizeof(keyValuePair_t *));
+        if (!property->envs) {
+            *rc = -1;
+            return;
+        }
+        for (int i = 0; i < exec->envs_count; i++) {
+            property->envs[i] = &exec->envs[i];
+        }
+        property->envs_count = exec->envs_count;
+    }
+    /* The model keeps the args as an array of strings too. */
+    property->args = exec->args;
+    property->args_count = exec->args_count;
+}
+
+static void compact_expand_auth_provider(kubeconfig_property_t * property, const kubeconfig_compact_auth_provider_t * auth_provider)
+{
+    property->name = auth_provider->name;
+    property->access_token = auth_provider->access_token;
+    property->client_id = auth_provider->client_id;
+    property->client_secret = auth_provider->client_secret;
+    property->cmd_path = auth_provider->cmd_path;
+    property->expires_on = auth_provider->expires_on;
+    property->expiry = auth_provider->expiry;
+    property->id_token = auth_provider->id_token;
+    property->idp_certificate_authority_data = auth_provider->idp_certificate_authority_data;
+    property->idp_issuer_url = auth_provider->idp_issuer_url;
+    property->refresh_token = auth_provider->refresh_token;
+}
+
+static void compact_expand_user(kubeconfig_t * kubeconfig, kubeconfig_property_t * property, const kubeconfig_compact_user_t * user, int *rc)
+{
+    property->name = user->name;
+    property->token = user->token;
+    property->client_certificate_data = user->client_certificate_data;
+    property->client_key_data = user->client_key_data;
+    property->username = user->username;
+    property->password = user->password;
+    property->insecure_skip_tls_verify = user->insecure_skip_tls_verify;
+    if (user->exec) {
+        property->exec = kubeconfig_property_alloc(kubeconfig, KUBECONFIG_PROPERTY_TYPE_USER_EXEC);
+        if (!property->exec) {
+            *rc = -1;
+            return;
+        }
+        compact_expand_exec(kubeconfig, property->exec, user->exec, rc);
+    }
+    if (user->auth_provider) {
+        property->auth_provider = kubeconfig_property_alloc(kubeconfig, KUBECONFIG_PROPERTY_TYPE_USER_AUTH_PROVIDER);
+        if (!property->auth_provider) {
+            *rc = -1;
+            return;
+        }
+        compact_expand_auth_provider(property->auth_provider, user->auth_provider);
+    }
+}
+
+kubeconfig_t *kubeconfig_compact_expand(const kubeconfig_compact_t * compact)
+{
+    static char fname[] = "kubeconfig_compact_expand()";
+
+    kubeconfig_t *kubeconfig = NULL;
+    int rc = 0;
+
+    if (!compact) {
+        fprintf(stderr, "%s: The compact kubeconfig is null.\n", fname);
+        return NULL;
+    }
+
+    kubeconfig = kubeconfig_create();
+    if (!kubeconfig) {
+        fprintf(stderr, "%s: Cannot allocate memory for the kubeconfig.\n", fname);
+        return NULL;
+    }
+    /* kubeconfig_free() then frees the properties with the arena, and leaves the strings alone. */
+    kubeconfig->arena = kubeconfig_arena_create();
+    if (!kubeconfig->arena) {
+        fprintf(stderr, "%s: Cannot allocate memory for the arena.\n", fname);
+        kubeconfig_free(kubeconfig);
+        return NULL;
+    }
+
+    kubeconfig->apiVersion = compact->apiVersion;
+    kubeconfig->preferences = compact->preferences;
+    kubeconfig->kind = compact->kind;
+    kubeconfig->current_context = compact->current_context;
+    kubeconfig->data_decoded = compact->data_decoded;
+
+    if (compact->contexts_count > 0) {
+        kubeconfig->contexts = kubeconfig_properties_alloc(kubeconfig, compact->contexts_count, KUBECONFIG_PROPERTY_TYPE_CONTEXT);
+        if (!kubeconfig->contexts) {
+            rc = -1;
+        }
+        for (int i = 0; 0 == rc && i < compact->contexts_count; i++) {
+            kubeconfig->contexts[i]->name = compact->contexts[i].name;
+            kubeconfig->contexts[i]->cluster = compact->contexts[i].cluster;
+            kubeconfig->contexts[i]->namespace = compact->contexts[i].namespace;
+            kubeconfig->contexts[i]->user = compact->contexts[i].user;
+        }
+        kubeconfig->contexts_count = compact->contexts_count;
+    }
+    if (0 == rc && compact->clusters_count > 0) {
+        kubeconfig->clusters = kubeconfig_properties_alloc(kubeconfig, compact->clusters_count, KUBECONFIG_PROPERTY_TYPE_CLUSTER);
+        if (!kubeconfig->clusters) {
+            rc = -1;
+        }
+        for (int i = 0; 0 == rc && i < compact->clusters_count; i++) {
+            kubeconfig->clusters[i]->name = compact->clusters[i].name;
+            kubeconfig->clusters[i]->server = compact->clusters[i].server;
+            kubeconfig->clusters[i]->certificate_authority_data = compact->clusters[i].certificate_authority_data;
+        }
+        kubeconfig->clusters_count = compact->clusters_count;
+    }
+    if (0 == rc && compact->users_count > 0) {
+        kubeconfig->users = kubeconfig_properties_alloc(kubeconfig, compact->users_count, KUBECONFIG_PROPERTY_TYPE_USER);
+        if (!kubeconfig->users) {
+            rc = -1;
+        }
+        for (int i = 0; 0 == rc && i < compact->users_count; i++) {
+            compact_expand_user(kubeconfig, kubeconfig->users[i], &compact->users[i], &rc);
+        }
+        kubeconfig->users_count = compact->users_count;
+    }
+
+    if (0 != rc) {
+        fprintf(stderr, "%s: Cannot allocate memory for the properties of the kubeconfig.\n", fname);
+        kubeconfig_free(kubeconfig);
+        return NULL;
+    }
+    return kubeconfig;
+}
+
+/*
+ * Lookup
+ */
+
+/* The entries of the arrays start with their name. */
+static const void *compact_find(const void *entries, int count, size_t size, const char *name)
+{
+    const char *entry = entries;
+
+    if (!name) {
+        return NULL;
+    }
+    for (int i = 0; i < count; i++, entry += size) {
+        const char *entry_name = *(char *const *) entry;
+        if (entry_name == name || (entry_name && 0 == strcmp(entry_name, name))) {
+            return entry;
+        }
+    }
+    return NULL;
+}
+
+const kubeconfig_compact_context_t *kubeconfig_compact_find_context(const kubeconfig_compact_t * compact, const char *name)
+{
+    return compact_find(compact->contexts, compact->contexts_count, sizeof(kubeconfig_compact_context_t), name);
+}
+
+const kubeconfig_compact_cluster_t *kubeconfig_compact_find_cluster(const kubeconfig_compact_t * compact, const char *name)
+{
+    return compact_find(compact->clusters, compact->clusters_count, sizeof(kubeconfig_compact_cluster_t), name);
+}
+
+const kubeconfig_compact_user_t *kubeconfig_compact_find_user(const kubeconfig_compact_t * compact, const char *name)
+{
+    return compact_find(compact->users, compact->users_count, sizeof(kubeconfig_compact_user_t), name);
+}
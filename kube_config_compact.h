@@ -0,0 +1,182 @@
+#ifndef _KUBE_CONFIG_COMPACT_H
+#define _KUBE_CONFIG_COMPACT_H
+
+#include "kube_config_model.h"
+#include "kube_config_yaml.h"
+
+#ifdef  __cplusplus
+extern "C" {
+#endif
+
+/*
+ * A compact kubeconfig holds the entries of a kubeconfig in an array per
+ * type, each entry a struct with the fields of its type only, instead of
+ * one kubeconfig_property_t sized for the largest type and allocated on
+ * its own behind an array of pointers. The exec and auth-provider entries
+ * of the users are in arrays of their own too.
+ *
+ * The arrays and the strings are allocated from a chunk of an arena sized
+ * for them, the strings packed without alignment. Each name is copied
+ * once, like with KUBEYAML_LOAD_INTERN: the cluster of a context and the
+ * name of the cluster are the same pointer. A compact kubeconfig is read
+ * only, it is built from a loaded kubeconfig and freed at once.
+ * kubeconfig_compact_expand() gives the functions that take a kubeconfig_t
+ * a view of it.
+ */
+
+    typedef struct kubeconfig_compact_context_t {
+        char *name;
+        char *cluster;
+        char *namespace;
+        char *user;
+    } kubeconfig_compact_context_t;
+
+    typedef struct kubeconfig_compact_cluster_t {
+        char *name;
+        char *server;
+        union {
+            char *certificate_authority_data;
+            kubeconfig_data_t *certificate_authority_data_decoded;      /* if compact->data_decoded */
+        };
+    } kubeconfig_compact_cluster_t;
+
+    typedef struct kubeconfig_compact_exec_t {
+        char *name;
+        char *command;
+        char *apiVersion;
+        keyValuePair_t *envs;
+        int envs_count;
+        char **args;
+        int args_count;
+    } kubeconfig_compact_exec_t;
+
+    typedef struct kubeconfig_compact_auth_provider_t {
+        char *name;
+        char *access_token;
+        char *client_id;
+        char *client_secret;
+        char *cmd_path;
+        char *expires_on;
+        char *expiry;
+        char *id_token;
+        char *idp_certificate_authority_data;
+        char *idp_issuer_url;
+        char *refresh_token;
+    } kubeconfig_compact_auth_provider_t;
+
+    typedef struct kubeconfig_compact_user_t {
+        char *name;
+        char *token;
+        union {
+            char *client_certificate_data;
+            kubeconfig_data_t *client_certificate_data_decoded; /* if compact->data_decoded */
+        };
+        union {
+            char *client_key_data;
+            kubeconfig_data_t *client_key_data_decoded; /* if compact->data_decoded */
+        };
+        char *username;
+        char *password;
+        kubeconfig_compact_exec_t *exec;        /* in compact->execs, NULL if none */
+        kubeconfig_compact_auth_provider_t *auth_provider;      /* in compact->auth_providers, NULL if none */
+        int insecure_skip_tls_verify;
+    } kubeconfig_compact_user_t;
+
+    typedef struct kubeconfig_compact_t {
+        char *apiVersion;
+        char *preferences;
+        char *kind;
+        char *current_context;
+        kubeconfig_compact_context_t *contexts;
+        int contexts_count;
+        kubeconfig_compact_cluster_t *clusters;
+        int clusters_count;
+        kubeconfig_compact_user_t *users;
+        int users_count;
+        kubeconfig_compact_exec_t *execs;
+        int execs_count;
+        kubeconfig_compact_auth_provider_t *auth_providers;
+        int auth_providers_count;
+        kubeconfig_arena_t *arena;      /* the arrays and the strings */
+        int data_decoded;       /* the *-data fields hold a kubeconfig_data_t, like in the kubeconfig copied */
+    } kubeconfig_compact_t;
+
+/*
+ * kubeconfig_compact_create
+ *
+ * Description:
+ *
+ * Copy a loaded kubeconfig into a compact kubeconfig. The kubeconfig is
+ * not changed and may be freed afterwards.
+ *
+ * Return:
+ *
+ *   The compact kubeconfig, to be freed by kubeconfig_compact_free(), or
+ *   NULL if the memory cannot be allocated.
+ *
+ * Parameter:
+ *
+ * IN:
+ * kubeconfig: loaded kubeconfig
+ *
+ */
+    kubeconfig_compact_t *kubeconfig_compact_create(const kubeconfig_t * kubeconfig);
+
+    void kubeconfig_compact_free(kubeconfig_compact_t * compact);
+
+/*
+ * kubeyaml_load_kubeconfig_compact
+ *
+ * Description:
+ *
+ * Load a kubeconfig like kubeyaml_load_kubeconfig_with_options() and
+ * return it compact. The kubeconfig is loaded with KUBEYAML_LOAD_ARENA
+ * and freed once it is copied.
+ *
+ * Return:
+ *
+ *   The compact kubeconfig, to be freed by kubeconfig_compact_free(), or
+ *   NULL if the load failed.
+ *
+ * Parameter:
+ *
+ * IN:
+ * fileName: kubernetes cluster configuration file name, unless the input is a buffer or a read handler of options
+ * options: input and loading mode, may be NULL
+ *
+ */
+    kubeconfig_compact_t *kubeyaml_load_kubeconfig_compact(const char *fileName, const kubeyaml_load_options_t * options);
+
+/*
+ * kubeconfig_compact_expand
+ *
+ * Description:
+ *
+ * Build a kubeconfig_t that views a compact kubeconfig, for the functions
+ * that take one and do not change it, e.g. kubeyaml_save_kubeconfig() or
+ * kubeyaml_query_run(). Its properties are allocated from an arena of its
+ * own, its strings are the ones of the compact kubeconfig.
+ * It must not be changed nor loaded into, and must be freed by
+ * kubeconfig_free() before the compact kubeconfig is.
+ *
+ * Return:
+ *
+ *   The kubeconfig, or NULL if the memory cannot be allocated.
+ *
+ * Parameter:
+ *
+ * IN:
+ * compact: compact kubeconfig
+ *
+ */
+    kubeconfig_t *kubeconfig_compact_expand(const kubeconfig_compact_t * compact);
+
+/* The entry with this name, NULL if there is none. An interned name is found by its pointer. */
+    const kubeconfig_compact_context_t *kubeconfig_compact_find_context(const kubeconfig_compact_t * compact, const char *name);
+    const kubeconfig_compact_cluster_t *kubeconfig_compact_find_cluster(const kubeconfig_compact_t * compact, const char *name);
+    const kubeconfig_compact_user_t *kubeconfig_compact_find_user(const kubeconfig_compact_t * compact, const char *name);
+
+#ifdef  __cplusplus
+}
+#endif
+#endif                          /* _KUBE_CONFIG_COMPACT_H */
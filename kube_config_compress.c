@@ -0,0 +1,268 @@
+#include <limits.h>
+#include <stdlib.h>
+#include <string.h>
+#include <zlib.h>
+#ifdef KUBEYAML_WITH_ZSTD
+#include <zstd.h>
+#endif
+#include "kube_config_compress.h"
+#include "kube_config_alloc.h"
+
+#define DECOMPRESS_CHUNK_SIZE (64 * 1024)
+
+static const unsigned char gzip_magic[] = { 0x1f, 0x8b };
+static const unsigned char zstd_magic[] = { 0x28, 0xb5, 0x2f, 0xfd };
+
+kubeconfig_compression_t kubeconfig_compression_detect(const void *buf, size_t len)
+{
+    if (len >= sizeof(gzip_magic) && 0 == memcmp(buf, gzip_magic, sizeof(gzip_magic))) {
+        return KUBECONFIG_COMPRESSION_GZIP;
+    }
+    if (len >= sizeof(zstd_magic) && 0 == memcmp(buf, zstd_magic, sizeof(zstd_magic))) {
+        return KUBECONFIG_COMPRESSION_ZSTD;
+    }
+    return KUBECONFIG_COMPRESSION_NONE;
+}
+
+static int decompress_create_stream(kubeconfig_decompress_t * decompress)
+{
+    static char fname[] = "decompress_create_stream()";
+
+    z_stream *zstream = NULL;
+
+    if (KUBECONFIG_COMPRESSION_GZIP == decompress->compression) {
+        zstream = kubeyaml_calloc(1, sizeof(z_stream));
+        if (!zstream) {
+            fprintf(stderr, "%s: Cannot allocate memory for the gzip stream.\n", fname);
+            return -1;
+        }
+        /* 16 + MAX_WBITS: a gzip header and trailer, not a zlib one. */
+        if (Z_OK != inflateInit2(zstream, 16 + MAX_WBITS)) {
+            fprintf(stderr, "%s: Cannot initialize the gzip stream.\n", fname);
+            kubeyaml_free(zstream);
+            return -1;
+        }
+        decompress->stream = zstream;
+    } else if (KUBECONFIG_COMPRESSION_ZSTD == decompress->compression) {
+#ifdef KUBEYAML_WITH_ZSTD
+        ZSTD_DStream *dstream = ZSTD_createDStream();
+        if (!dstream) {
+            fprintf(stderr, "%s: Cannot allocate memory for the zstd stream.\n", fname);
+            return -1;
+        }
+        ZSTD_initDStream(dstream);
+        decompress->stream = dstream;
+#else
+        fprintf(stderr, "%s: The kubeconfig is zstd-compressed, the library is built without KUBEYAML_WITH_ZSTD.\n", fname);
+        return -1;
+#endif
+    } else {
+        /* Uncompressed bytes are passed through. */
+        decompress->finished = 1;
+    }
+    return 0;
+}
+
+int kubeconfig_decompress_init_buffer(kubeconfig_decompress_t * decompress, kubeconfig_compression_t compression, const void *buf, size_t len)
+{
+    memset(decompress, 0, sizeof(kubeconfig_decompress_t));
+    decompress->compression = compression;
+    decompress->next = (const unsigned char *) buf;
+    decompress->available = len;
+    decompress->end = 1;
+
+    return decompress_create_stream(decompress);
+}
+
+int kubeconfig_decompress_init_file(kubeconfig_decompress_t * decompress, FILE * input, const unsigned char *head, size_t head_length)
+{
+    static char fname[] = "kubeconfig_decompress_init_file()";
+
+    memset(decompress, 0, sizeof(kubeconfig_decompress_t));
+    decompress->compression = kubeconfig_compression_detect(head, head_length);
+    decompress->input = input;
+
+    decompress->chunk = kubeyaml_malloc(DECOMPRESS_CHUNK_SIZE);
+    if (!decompress->chunk) {
+        fprintf(stderr, "%s: Cannot allocate memory for the read buffer.\n", fname);
+        return -1;
+    }
+    memcpy(decompress->chunk, head, head_length);
+    decompress->next = decompress->chunk;
+    decompress->available = head_length;
+
+    if (0 != decompress_create_stream(decompress)) {
+        kubeyaml_free(decompress->chunk);
+        decompress->chunk = NULL;
+        return -1;
+    }
+    return 0;
+}
+
+void kubeconfig_decompress_free(kubeconfig_decompress_t * decompress)
+{
+    if (decompress->stream) {
+        if (KUBECONFIG_COMPRESSION_GZIP == decompress->compression) {
+            inflateEnd((z_stream *) decompress->stream);
+            kubeyaml_free(decompress->stream);
+        }
+#ifdef KUBEYAML_WITH_ZSTD
+        if (KUBECONFIG_COMPRESSION_ZSTD == decompress->compression) {
+            ZSTD_freeDStream((ZSTD_DStream *) decompress->stream);
+        }
+#endif
+        decompress->stream = NULL;
+    }
+    if (decompress->chunk) {
+        kubeyaml_free(decompress->chunk);
+        decompress->chunk = NULL;
+    }
+}
+
+/* Read the next chunk of the file once the decoder has taken the previous one. */
+static int decompress_refill(kubeconfig_decompress_t * decompress)
+{
+    static char fname[] = "decompress_refill()";
+
+    size_t n = 0;
+
+    if (decompress->available || decompress->end) {
+        return 0;
+    }
+
+    n = fread(decompress->chunk, 1, DECOMPRESS_CHUNK_SIZE, decompress->input);
+    if (ferror(decompress->input)) {
+        fprintf(stderr, "%s: Cannot read the compressed kubeconfig.\n", fname);
+        return -1;
+    }
+    if (0 == n) {
+        decompress->end = 1;
+    }
+    decompress->next = decompress->chunk;
+    decompress->available = n;
+    return 0;
+}
+
+static int decompress_gzip(kubeconfig_decompress_t * decompress, unsigned char *buffer, size_t size, size_t *size_read)
+{
+    static char fname[] = "decompress_gzip()";
+
+    z_stream *zstream = (z_stream *) decompress->stream;
+    uInt avail_in = decompress->available > UINT_MAX ? UINT_MAX : (uInt) decompress->available;
+    uInt avail_out = size > UINT_MAX ? UINT_MAX : (uInt) size;
+    int rc = 0;
+
+    /* More input after the end of a member is the next member. */
+    if (decompress->finished) {
+        inflateReset(zstream);
+        decompress->finished = 0;
+    }
+
+    zstream->next_in = (Bytef *) decompress->next;
+    zstream->avail_in = avail_in;
+    zstream->next_out = buffer;
+    zstream->avail_out = avail_out;
+
+    rc = inflate(zstream, Z_NO_FLUSH);
+    if (Z_STREAM_END == rc) {
+        decompress->finished = 1;
+    } else if (Z_OK != rc && Z_BUF_ERROR != rc) {
+        fprintf(stderr, "%s: Cannot decompress the gzip input.[%s]\n", fname, zstream->msg ? zstream->msg : zError(rc));
+        return -1;
+    }
+
+    decompress->next += avail_in - zstream->avail_in;
+    decompress->available -= avail_in - zstream->avail_in;
+    *size_read = avail_out - zstream->avail_out;
+    return 0;
+}
+
+static int decompress_zstd(kubeconfig_decompress_t * decompress, unsigned char *buffer, size_t size, size_t *size_read)
+{
+#ifdef KUBEYAML_WITH_ZSTD
+    static char fname[] = "decompress_zstd()";
+
+    ZSTD_inBuffer in = { decompress->next, decompress->available, 0 };
+    ZSTD_outBuffer out = { buffer, size, 0 };
+    size_t rc = 0;
+
+    rc = ZSTD_decompressStream((ZSTD_DStream *) decompress->stream, &out, &in);
+    if (ZSTD_isError(rc)) {
+        fprintf(stderr, "%s: Cannot decompress the zstd input.[%s]\n", fname, ZSTD_getErrorName(rc));
+        return -1;
+    }
+    /* 0 once a frame is decoded and flushed. */
+    decompress->finished = (0 == rc);
+
+    decompress->next += in.pos;
+    decompress->available -= in.pos;
+    *size_read = out.pos;
+    return 0;
+#else
+    return -1;
+#endif
+}
+
+static int decompress_copy(kubeconfig_decompress_t * decompress, unsigned char *buffer, size_t size, size_t *size_read)
+{
+    static char fname[] = "decompress_copy()";
+
+    size_t n = 0;
+
+    if (decompress->available) {
+        n = decompress->available < size ? decompress->available : size;
+        memcpy(buffer, decompress->next, n);
+        decompress->next += n;
+        decompress->available -= n;
+    } else if (decompress->input) {
+        /* Past the head, the file is read straight into the buffer. */
+        n = fread(buffer, 1, size, decompress->input);
+        if (ferror(decompress->input)) {
+            fprintf(stderr, "%s: Cannot read the kubeconfig.\n", fname);
+            return -1;
+        }
+    }
+
+    *size_read = n;
+    return 0;
+}
+
+int kubeconfig_decompress_read(void *data, unsigned char *buffer, size_t size, size_t * size_read)
+{
+    static char fname[] = "kubeconfig_decompress_read()";
+
+    kubeconfig_decompress_t *decompress = (kubeconfig_decompress_t *) data;
+    int rc = 0;
+
+    *size_read = 0;
+
+    if (KUBECONFIG_COMPRESSION_NONE == decompress->compression) {
+        return (0 == decompress_copy(decompress, buffer, size, size_read));
+    }
+
+    /* A call may consume input without producing output, e.g. a gzip header. */
+    while (0 == *size_read) {
+        if (0 != decompress_refill(decompress)) {
+            return 0;
+        }
+        if (!decompress->available && decompress->finished) {
+            return 1;
+        }
+
+        if (KUBECONFIG_COMPRESSION_GZIP == decompress->compression) {
+            rc = decompress_gzip(decompress, buffer, size, size_read);
+        } else {
+            rc = decompress_zstd(decompress, buffer, size, size_read);
+        }
+        if (0 != rc) {
+            return 0;
+        }
+
+        /* The decoder holds no more output and waits for input that will not come. */
+        if (0 == *size_read && !decompress->available && decompress->end && !decompress->finished) {
+            fprintf(stderr, "%s: The compressed kubeconfig is truncated.\n", fname);
+            return 0;
+        }
+    }
+    return 1;
+}
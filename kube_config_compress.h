@@ -0,0 +1,115 @@
+#ifndef _KUBE_CONFIG_COMPRESS_H
+#define _KUBE_CONFIG_COMPRESS_H
+
+#include <stddef.h>
+#include <stdio.h>
+
+#ifdef  __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Streaming decompression of gzip and zstd compressed kubeconfigs. The
+ * decompressed text is produced as the parser reads it, through a read
+ * handler, and is never held as a whole. Concatenated gzip members and
+ * zstd frames are decompressed one after the other.
+ *
+ * zstd needs the library to be built with KUBEYAML_WITH_ZSTD and linked
+ * with libzstd, see the Makefile.
+ */
+
+    typedef enum kubeconfig_compression_t {
+        KUBECONFIG_COMPRESSION_NONE = 0,
+        KUBECONFIG_COMPRESSION_GZIP,
+        KUBECONFIG_COMPRESSION_ZSTD
+    } kubeconfig_compression_t;
+
+/* Bytes needed to recognize a compression format. */
+#define KUBECONFIG_COMPRESSION_MAGIC_SIZE 4
+
+    typedef struct kubeconfig_decompress_t {
+        kubeconfig_compression_t compression;
+        FILE *input;            /* compressed file, or NULL for a buffer */
+        const unsigned char *next;      /* compressed bytes not given to the decoder yet */
+        size_t available;
+        unsigned char *chunk;   /* read buffer of input */
+        int end;                /* no more bytes after next */
+        int finished;           /* the last member or frame is complete */
+        void *stream;           /* z_stream or ZSTD_DStream */
+    } kubeconfig_decompress_t;
+
+/*
+ * Return the compression of the data starting with the len bytes at buf,
+ * KUBECONFIG_COMPRESSION_NONE if it is not compressed or len is too short
+ * to tell.
+ */
+    kubeconfig_compression_t kubeconfig_compression_detect(const void *buf, size_t len);
+
+/*
+ * kubeconfig_decompress_init_buffer
+ *
+ * Description:
+ *
+ * Decompress the len bytes at buf, which must stay valid until the
+ * decompressor is freed.
+ *
+ * Return:
+ *
+ *   0     Success
+ *  -1     Failed, the compression is not supported or the memory cannot be allocated
+ *
+ * Parameter:
+ *
+ * IN:
+ * compression: compression of buf, see kubeconfig_compression_detect()
+ * buf: compressed data
+ * len: length of buf in bytes
+ *
+ * OUT:
+ * decompress: decompressor, to be freed by kubeconfig_decompress_free()
+ *
+ */
+    int kubeconfig_decompress_init_buffer(kubeconfig_decompress_t * decompress, kubeconfig_compression_t compression, const void *buf, size_t len);
+
+/*
+ * kubeconfig_decompress_init_file
+ *
+ * Description:
+ *
+ * Decompress the file input. The caller has already read its first
+ * head_length bytes to detect the compression, they are decompressed
+ * first. With KUBECONFIG_COMPRESSION_NONE, the bytes are returned as they
+ * are read, so that input does not need to be seekable.
+ *
+ * Return:
+ *
+ *   0     Success
+ *  -1     Failed, the compression is not supported or the memory cannot be allocated
+ *
+ * Parameter:
+ *
+ * IN:
+ * input: file opened for reading, the caller closes it after kubeconfig_decompress_free()
+ * head: bytes already read from input, at most KUBECONFIG_COMPRESSION_MAGIC_SIZE
+ * head_length: number of bytes in head
+ *
+ * OUT:
+ * decompress: decompressor, to be freed by kubeconfig_decompress_free()
+ *
+ */
+    int kubeconfig_decompress_init_file(kubeconfig_decompress_t * decompress, FILE * input, const unsigned char *head, size_t head_length);
+
+/*
+ * Read handler of the decompressed text, with the convention of
+ * kubeyaml_read_handler_t: return 1 on success and at the end of the text,
+ * where *size_read is 0, or 0 if the input is corrupted or truncated.
+ * data is the kubeconfig_decompress_t.
+ */
+    int kubeconfig_decompress_read(void *data, unsigned char *buffer, size_t size, size_t * size_read);
+
+    void kubeconfig_decompress_free(kubeconfig_decompress_t * decompress);
+
+#ifdef  __cplusplus
+}
+#endif
+#endif                          /* _KUBE_CONFIG_COMPRESS_H */
@@ -0,0 +1,1351 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "kube_config_index.h"
+#include "kube_config_scalar.h"
+#include "kube_config_alloc.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define KUBEYAML_INDEX_X86
+#endif
+
+#define INDEX_UNSUPPORTED KUBECONFIG_SCALAR_UNSUPPORTED
+#define INDEX_MAX_LEVELS 64
+
+/*
+ * Stage 1
+ *
+ * Collect the offsets of the structural characters (the line breaks, ':',
+ * '#' and the quotes) 64 bytes at a time, and reject the control and
+ * non-ASCII bytes the subset does not allow.
+ */
+
+typedef struct index_structurals_t {
+    uint32_t *offsets;
+    size_t count;
+    size_t capacity;
+} index_structurals_t;
+
+typedef int (*index_stage1_t)(const char *buf, size_t len, index_structurals_t * structurals);
+
+#define INDEX_IS_STRUCTURAL(c) ('\n' == (c) || '\r' == (c) || ':' == (c) || '#' == (c) || '\'' == (c) || '"' == (c))
+#define INDEX_IS_INVALID(c) (!KUBECONFIG_SCALAR_IS_TEXT(c) && '\n' != (c) && '\r' != (c))
+
+static int index_add_mask(index_structurals_t * structurals, size_t base, uint64_t mask)
+{
+    static char fname[] = "index_add_mask()";
+
+    size_t count = (size_t) __builtin_popcountll(mask);
+    uint32_t *offsets = NULL;
+    size_t capacity = 0;
+
+    if (structurals->count + count > structurals->capacity) {
+        capacity = structurals->capacity ? structurals->capacity * 2 : 256;
+        offsets = kubeyaml_realloc(structurals->offsets, capacity * sizeof(uint32_t));
+        if (!offsets) {
+            fprintf(stderr, "%s: Cannot allocate memory for the structural offsets.\n", fname);
+            return -1;
+        }
+        structurals->offsets = offsets;
+        structurals->capacity = capacity;
+    }
+
+    while (mask) {
+        structurals->offsets[structurals->count++] = (uint32_t) (base + (size_t) __builtin_ctzll(mask));
+        mask &= mask - 1;
+    }
+    return 0;
+}
+
+static int index_stage1_tail(const char *buf, size_t start, size_t len, index_structurals_t * structurals)
+{
+    uint64_t mask = 0;
+    size_t i = 0;
+    size_t j = 0;
+
+    for (i = start; i < len; i += 64) {
+        mask = 0;
+        for (j = 0; j < 64 && i + j < len; j++) {
+            if (INDEX_IS_INVALID(buf[i + j])) {
+                return INDEX_UNSUPPORTED;
+            }
+            if (INDEX_IS_STRUCTURAL(buf[i + j])) {
+                mask |= 1ULL << j;
+            }
+        }
+        if (index_add_mask(structurals, i, mask)) {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+static int index_stage1_generic(const char *buf, size_t len, index_structurals_t * structurals)
+{
+    return index_stage1_tail(buf, 0, len, structurals);
+}
+
+#ifdef KUBEYAML_INDEX_X86
+
+__attribute__ ((target("sse4.2")))
+static int index_stage1_sse42(const char *buf, size_t len, index_structurals_t * structurals)
+{
+    const __m128i structural = _mm_setr_epi8('\n', '\r', ':', '#', '\'', '"', 0, 0, 0, 0, 0, 0, 0, 0, 0, 0);
+    /* Control characters but tab, LF and CR, then DEL and the non-ASCII bytes. */
+    const __m128i invalid = _mm_setr_epi8(0x00, 0x08, 0x0B, 0x0C, 0x0E, 0x1F, 0x7F, (char) 0xFF, 0, 0, 0, 0, 0, 0, 0, 0);
+    __m128i chunk;
+    uint64_t mask = 0;
+    size_t i = 0;
+    int k = 0;
+
+    for (i = 0; i + 64 <= len; i += 64) {
+        mask = 0;
+        for (k = 0; k < 4; k++) {
+            chunk = _mm_loadu_si128((const __m128i *) (buf + i + 16 * k));
+            if (_mm_cmpestrc(invalid, 8, chunk, 16, _SIDD_UBYTE_OPS | _SIDD_CMP_RANGES)) {
+                return INDEX_UNSUPPORTED;
+            }
+            mask |= (uint64_t) (uint16_t) _mm_cvtsi128_si32(_mm_cmpestrm(structural, 6, chunk, 16, _SIDD_UBYTE_OPS | _SIDD_CMP_EQUAL_ANY | _SIDD_BIT_MASK)) << (16 * k);
+        }
+        if (index_add_mask(structurals, i, mask)) {
+            return -1;
+        }
+    }
+
+    return index_stage1_tail(buf, i, len, structurals);
+}
+
+__attribute__ ((target("avx2")))
+static int index_stage1_avx2(const char *buf, size_t len, index_structurals_t * structurals)
+{
+    const __m256i newline = _mm256_set1_epi8('\n');
+    const __m256i cr = _mm256_set1_epi8('\r');
+    const __m256i colon = _mm256_set1_epi8(':');
+    const __m256i hash = _mm256_set1_epi8('#');
+    const __m256i single_quote = _mm256_set1_epi8('\'');
+    const __m256i double_quote = _mm256_set1_epi8('"');
+    const __m256i space = _mm256_set1_epi8(' ');
+    const __m256i tab = _mm256_set1_epi8('\t');
+    const __m256i del = _mm256_set1_epi8(0x7F);
+    __m256i invalid = _mm256_setzero_si256();
+    __m256i chunk;
+    __m256i found;
+    uint64_t mask = 0;
+    size_t i = 0;
+    int k = 0;
+
+    for (i = 0; i + 64 <= len; i += 64) {
+        mask = 0;
+        for (k = 0; k < 2; k++) {
+            chunk = _mm256_loadu_si256((const __m256i *) (buf + i + 32 * k));
+            found = _mm256_or_si256(_mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(chunk, newline), _mm256_cmpeq_epi8(chunk, cr)), _mm256_cmpeq_epi8(chunk, colon)),
+                                    _mm256_or_si256(_mm256_cmpeq_epi8(chunk, hash), _mm256_or_si256(_mm256_cmpeq_epi8(chunk, single_quote), _mm256_cmpeq_epi8(chunk, double_quote))));
+            mask |= (uint64_t) (uint32_t) _mm256_movemask_epi8(found) << (32 * k);
+            /* The signed compare also catches the bytes above 0x7F. */
+            invalid = _mm256_or_si256(invalid, _mm256_andnot_si256(_mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(chunk, tab), _mm256_cmpeq_epi8(chunk, cr)), _mm256_cmpeq_epi8(chunk, newline)),
+                                                                   _mm256_cmpgt_epi8(space, chunk)));
+            invalid = _mm256_or_si256(invalid, _mm256_cmpeq_epi8(chunk, del));
+        }
+        if (index_add_mask(structurals, i, mask)) {
+            return -1;
+        }
+    }
+
+    if (!_mm256_testz_si256(invalid, invalid)) {
+        return INDEX_UNSUPPORTED;
+    }
+    return index_stage1_tail(buf, i, len, structurals);
+}
+
+#endif
+
+static index_stage1_t index_stage1_select(void)
+{
+#ifdef KUBEYAML_INDEX_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        return index_stage1_avx2;
+    }
+    if (__builtin_cpu_supports("sse4.2")) {
+        return index_stage1_sse42;
+    }
+#endif
+    return index_stage1_generic;
+}
+
+/*
+ * Stage 2
+ *
+ * Turn the structural offsets into one record per line, checking on the way
+ * that the lines and their indentation stay in the subset, with the same
+ * rules as the fast path of the loader.
+ */
+
+typedef struct index_level_t {
+    int indent;
+    int is_sequence;
+} index_level_t;
+
+typedef struct index_builder_t {
+    kubeyaml_index_t *index;
+    const uint32_t *structurals;
+    size_t structurals_count;
+    size_t cursor;              /* first structural not looked at on the current line */
+    uint32_t lines_capacity;
+    index_level_t levels[INDEX_MAX_LEVELS];
+    int levels_count;
+    int pending;                /* the last key or sequence entry waits for a value on the next lines */
+    int has_root;
+    int has_document_start;
+    char *scratch;              /* unescaped text of quoted scalars */
+    size_t scratch_size;
+} index_builder_t;
+
+static int index_open(index_builder_t * builder, int indent, int is_sequence)
+{
+    if (builder->levels_count == INDEX_MAX_LEVELS) {
+        return INDEX_UNSUPPORTED;
+    }
+    builder->levels[builder->levels_count].indent = indent;
+    builder->levels[builder->levels_count].is_sequence = is_sequence;
+    builder->levels_count++;
+    return 0;
+}
+
+static int index_indent(index_builder_t * builder, int indent, int is_sequence_entry)
+{
+    index_level_t *top = NULL;
+
+    while (builder->levels_count > 0 && builder->levels[builder->levels_count - 1].indent > indent) {
+        builder->pending = 0;
+        builder->levels_count--;
+    }
+
+    if (0 == builder->levels_count) {
+        /* A single root, and it is a mapping. */
+        if (builder->has_root || is_sequence_entry) {
+            return INDEX_UNSUPPORTED;
+        }
+        builder->has_root = 1;
+        return index_open(builder, indent, 0);
+    }
+
+    top = &builder->levels[builder->levels_count - 1];
+    if (top->indent < indent) {
+        if (!builder->pending) {
+            return INDEX_UNSUPPORTED;
+        }
+        builder->pending = 0;
+        return index_open(builder, indent, is_sequence_entry);
+    }
+
+    if (top->is_sequence == is_sequence_entry) {
+        builder->pending = 0;
+        return 0;
+    }
+
+    if (top->is_sequence) {
+        builder->pending = 0;
+        builder->levels_count--;
+        top = builder->levels_count > 0 ? &builder->levels[builder->levels_count - 1] : NULL;
+        if (!top || top->indent != indent || top->is_sequence) {
+            return INDEX_UNSUPPORTED;
+        }
+        return 0;
+    }
+
+    if (!builder->pending) {
+        return INDEX_UNSUPPORTED;
+    }
+    builder->pending = 0;
+    return index_open(builder, indent, 1);
+}
+
+/* Check a quoted scalar with the scanner of the fast path, *next is set after it like kubeconfig_scalar_scan() does. */
+static int index_quoted(index_builder_t * builder, uint32_t p, uint32_t eol, uint32_t * next)
+{
+    static char fname[] = "index_quoted()";
+
+    const char *buf = builder->index->buffer;
+    const char *value = NULL;
+    const char *end = NULL;
+    size_t length = 0;
+    char *scratch = NULL;
+    int rc = 0;
+
+    if (builder->scratch_size < eol - p) {
+        scratch = kubeyaml_realloc(builder->scratch, eol - p);
+        if (!scratch) {
+            fprintf(stderr, "%s: Cannot allocate memory for quoted scalars.\n", fname);
+            return -1;
+        }
+        builder->scratch = scratch;
+        builder->scratch_size = eol - p;
+    }
+
+    rc = kubeconfig_scalar_scan(buf + p, buf + eol, builder->scratch, &value, &length, &end);
+    if (rc) {
+        return rc;
+    }
+    *next = (uint32_t) (end - buf);
+
+    /* Skip the structurals inside the quotes. */
+    while (builder->cursor < builder->structurals_count && builder->structurals[builder->cursor] < *next) {
+        builder->cursor++;
+    }
+    return 0;
+}
+
+/*
+ * Find where the plain scalar starting at p ends from the structurals of
+ * the line: *next is set to the ':' of a key, to the blank before a
+ * comment or to the end of the line.
+ */
+static int index_plain(index_builder_t * builder, uint32_t p, uint32_t eol, uint32_t * next)
+{
+    const char *buf = builder->index->buffer;
+    uint32_t offset = 0;
+
+    if (kubeconfig_scalar_plain_start(buf + p, buf + eol)) {
+        return INDEX_UNSUPPORTED;
+    }
+
+    while (builder->cursor < builder->structurals_count && (offset = builder->structurals[builder->cursor]) < eol) {
+        builder->cursor++;
+        if (offset < p) {
+            continue;
+        }
+        if (':' == buf[offset] && (offset + 1 == eol || KUBECONFIG_SCALAR_IS_BLANK(buf[offset + 1]))) {
+            *next = offset;
+            return 0;
+        }
+        if ('#' == buf[offset] && offset > p && KUBECONFIG_SCALAR_IS_BLANK(buf[offset - 1])) {
+            *next = offset - 1;
+            return 0;
+        }
+    }
+
+    *next = eol;
+    return 0;
+}
+
+/* {} and [] are the only flow collections kubectl writes. */
+static int index_empty_collection(const char *buf, uint32_t p, uint32_t eol)
+{
+    char close = ('{' == buf[p]) ? '}' : ']';
+    uint32_t q = p + 1;
+
+    while (q < eol && ' ' == buf[q]) {
+        q++;
+    }
+    if (q == eol || close != buf[q] || !kubeconfig_scalar_rest_is_empty(buf + q + 1, buf + eol)) {
+        return INDEX_UNSUPPORTED;
+    }
+    return 0;
+}
+
+/* Check the value after "key:" or "- ", if any, and record where it starts. */
+static int index_value(index_builder_t * builder, kubeyaml_index_line_t * line, uint32_t p, uint32_t eol)
+{
+    const char *buf = builder->index->buffer;
+    uint32_t next = 0;
+    int rc = 0;
+
+    while (p < eol && KUBECONFIG_SCALAR_IS_BLANK(buf[p])) {
+        p++;
+    }
+    if (p == eol || '#' == buf[p]) {
+        builder->pending = 1;
+        return 0;
+    }
+
+    line->flags |= KUBEYAML_INDEX_LINE_VALUE;
+    line->value = p;
+
+    if ('{' == buf[p] || '[' == buf[p]) {
+        return index_empty_collection(buf, p, eol);
+    }
+
+    if ('"' == buf[p] || '\'' == buf[p]) {
+        rc = index_quoted(builder, p, eol, &next);
+    } else {
+        rc = index_plain(builder, p, eol, &next);
+    }
+    if (rc) {
+        return rc;
+    }
+    if (next < eol && ':' == buf[next]) {
+        return INDEX_UNSUPPORTED;
+    }
+    return kubeconfig_scalar_rest_is_empty(buf + next, buf + eol) ? 0 : INDEX_UNSUPPORTED;
+}
+
+static int index_add_line(index_builder_t * builder, const kubeyaml_index_line_t * line)
+{
+    static char fname[] = "index_add_line()";
+
+    kubeyaml_index_t *index = builder->index;
+    kubeyaml_index_line_t *lines = NULL;
+    uint32_t capacity = 0;
+
+    if (index->lines_count == builder->lines_capacity) {
+        capacity = builder->lines_capacity ? builder->lines_capacity * 2 : 64;
+        lines = kubeyaml_realloc(index->lines, capacity * sizeof(kubeyaml_index_line_t));
+        if (!lines) {
+            fprintf(stderr, "%s: Cannot allocate memory for the index lines.\n", fname);
+            return -1;
+        }
+        index->lines = lines;
+        builder->lines_capacity = capacity;
+    }
+    index->lines[index->lines_count++] = *line;
+    return 0;
+}
+
+static int index_line(index_builder_t * builder, uint32_t start, uint32_t eol)
+{
+    const char *buf = builder->index->buffer;
+    kubeyaml_index_line_t line;
+    uint32_t p = start;
+    uint32_t next = 0;
+    int rc = 0;
+
+    while (p < eol && ' ' == buf[p]) {
+        p++;
+    }
+    if (p == eol || '#' == buf[p]) {
+        return 0;
+    }
+    if ('\t' == buf[p] || p - start > UINT16_MAX) {
+        return INDEX_UNSUPPORTED;
+    }
+
+    if (p == start) {
+        if ('%' == buf[p]) {
+            return INDEX_UNSUPPORTED;
+        }
+        if (eol - p >= 3 && (0 == memcmp(buf + p, "---", 3) || 0 == memcmp(buf + p, "...", 3)) && (eol - p == 3 || KUBECONFIG_SCALAR_IS_BLANK(buf[p + 3]))) {
+            if ('.' == buf[p] || builder->has_root || builder->has_document_start || !kubeconfig_scalar_rest_is_empty(buf + p + 3, buf + eol)) {
+                return INDEX_UNSUPPORTED;
+            }
+            builder->has_document_start = 1;
+            return 0;
+        }
+    }
+
+    memset(&line, 0, sizeof(line));
+    line.indent = (uint16_t) (p - start);
+    line.end = eol;
+
+    if ('-' == buf[p] && (p + 1 == eol || ' ' == buf[p + 1])) {
+        line.flags |= KUBEYAML_INDEX_LINE_ENTRY;
+        p++;
+        while (p < eol && ' ' == buf[p]) {
+            p++;
+        }
+        if (p - start > UINT16_MAX || (p < eol && ('\t' == buf[p] || ('-' == buf[p] && (p + 1 == eol || ' ' == buf[p + 1]))))) {
+            return INDEX_UNSUPPORTED;
+        }
+    }
+    line.content = p;
+    line.column = (uint16_t) (p - start);
+
+    rc = index_indent(builder, line.indent, line.flags & KUBEYAML_INDEX_LINE_ENTRY);
+    if (rc) {
+        return rc;
+    }
+
+    if (p == eol || '#' == buf[p] || '{' == buf[p] || '[' == buf[p]) {
+        if (!(line.flags & KUBEYAML_INDEX_LINE_ENTRY)) {
+            return INDEX_UNSUPPORTED;
+        }
+        rc = index_value(builder, &line, p, eol);
+        if (rc) {
+            return rc;
+        }
+        return index_add_line(builder, &line);
+    }
+
+    if ('"' == buf[p] || '\'' == buf[p]) {
+        rc = index_quoted(builder, p, eol, &next);
+    } else {
+        rc = index_plain(builder, p, eol, &next);
+    }
+    if (rc) {
+        return rc;
+    }
+
+    if (next == eol || ':' != buf[next]) {
+        /* A scalar is only allowed as a sequence entry, a mapping wants a key here. */
+        if (!(line.flags & KUBEYAML_INDEX_LINE_ENTRY) || !kubeconfig_scalar_rest_is_empty(buf + next, buf + eol)) {
+            return INDEX_UNSUPPORTED;
+        }
+        line.flags |= KUBEYAML_INDEX_LINE_VALUE;
+        line.value = p;
+        return index_add_line(builder, &line);
+    }
+
+    /* "- key: value" starts a mapping inside the sequence entry, its keys are aligned on this one. */
+    if (line.flags & KUBEYAML_INDEX_LINE_ENTRY) {
+        rc = index_open(builder, line.column, 0);
+        if (rc) {
+            return rc;
+        }
+    }
+
+    line.flags |= KUBEYAML_INDEX_LINE_KEY;
+    line.colon = next;
+    rc = index_value(builder, &line, next + 1, eol);
+    if (rc) {
+        return rc;
+    }
+    return index_add_line(builder, &line);
+}
+
+static int index_stage2(index_builder_t * builder)
+{
+    const char *buf = builder->index->buffer;
+    uint32_t length = (uint32_t) builder->index->length;
+    uint32_t start = 0;
+    uint32_t eol = 0;
+    size_t i = 0;
+    int rc = 0;
+
+    while (start < length) {
+        /* The next line break is the next '\n' structural, a CR alone is a line break for libyaml but not here. */
+        for (i = builder->cursor; i < builder->structurals_count && '\n' != buf[builder->structurals[i]]; i++) {
+            if ('\r' == buf[builder->structurals[i]] && builder->structurals[i] + 1 < length && '\n' != buf[builder->structurals[i] + 1]) {
+                return INDEX_UNSUPPORTED;
+            }
+        }
+        eol = (i < builder->structurals_count) ? builder->structurals[i] : length;
+
+        rc = index_line(builder, start, (eol > start && '\r' == buf[eol - 1]) ? eol - 1 : eol);
+        if (rc) {
+            return rc;
+        }
+
+        builder->cursor = i + 1;
+        start = eol + 1;
+    }
+    return 0;
+}
+
+/* Link every line to the first following line that is not more indented, so lookups can jump over nested lines. */
+static int index_link(kubeyaml_index_t * index)
+{
+    static char fname[] = "index_link()";
+
+    uint32_t *stack = NULL;
+    uint32_t stack_count = 0;
+    uint32_t i = 0;
+
+    if (0 == index->lines_count) {
+        return 0;
+    }
+
+    stack = kubeyaml_calloc(index->lines_count, sizeof(uint32_t));
+    if (!stack) {
+        fprintf(stderr, "%s: Cannot allocate memory for the index.\n", fname);
+        return -1;
+    }
+
+    for (i = 0; i < index->lines_count; i++) {
+        while (stack_count > 0 && index->lines[stack[stack_count - 1]].indent >= index->lines[i].indent) {
+            index->lines[stack[--stack_count]].next = i;
+        }
+        stack[stack_count++] = i;
+    }
+    while (stack_count > 0) {
+        index->lines[stack[--stack_count]].next = index->lines_count;
+    }
+
+    kubeyaml_free(stack);
+    return 0;
+}
+
+static int index_build(kubeyaml_index_t * index)
+{
+    index_stage1_t stage1 = index_stage1_select();
+    index_structurals_t structurals;
+    index_builder_t builder;
+    int rc = 0;
+
+    if (index->length >= UINT32_MAX) {
+        return INDEX_UNSUPPORTED;
+    }
+
+    memset(&structurals, 0, sizeof(structurals));
+    rc = stage1(index->buffer, index->length, &structurals);
+
+    if (0 == rc) {
+        memset(&builder, 0, sizeof(builder));
+        builder.index = index;
+        builder.structurals = structurals.offsets;
+        builder.structurals_count = structurals.count;
+
+        rc = index_stage2(&builder);
+
+        if (builder.scratch) {
+            kubeyaml_free(builder.scratch);
+        }
+    }
+
+    if (structurals.offsets) {
+        kubeyaml_free(structurals.offsets);
+    }
+
+    if (0 == rc) {
+        rc = index_link(index);
+    }
+    return rc;
+}
+
+static kubeyaml_index_t *index_create(const char *buffer, size_t length, int mapped, int quiet)
+{
+    static char fname[] = "kubeyaml_index_create()";
+
+    kubeyaml_index_t *index = NULL;
+    int rc = 0;
+
+    index = kubeyaml_calloc(1, sizeof(kubeyaml_index_t));
+    if (!index) {
+        fprintf(stderr, "%s: Cannot allocate memory for the index.\n", fname);
+        return NULL;
+    }
+    index->buffer = buffer;
+    index->length = length;
+    index->mapped = mapped;
+
+    rc = index_build(index);
+    if (0 != rc) {
+        if (INDEX_UNSUPPORTED == rc && !quiet) {
+            fprintf(stderr, "%s: The input is not in the YAML subset the index supports.\n", fname);
+        }
+        kubeyaml_index_free(index);
+        return NULL;
+    }
+
+    return index;
+}
+
+kubeyaml_index_t *kubeyaml_index_create(const char *buffer, size_t length)
+{
+    static char fname[] = "kubeyaml_index_create()";
+
+    if (!buffer) {
+        fprintf(stderr, "%s: The buffer is null.\n", fname);
+        return NULL;
+    }
+
+    return index_create(buffer, length, 0, 0);
+}
+
+kubeyaml_index_t *kubeyaml_index_try_create(const char *buffer, size_t length)
+{
+    if (!buffer) {
+        return NULL;
+    }
+    return index_create(buffer, length, 0, 1);
+}
+
+kubeyaml_index_t *kubeyaml_index_create_from_file(const char *fileName)
+{
+    static char fname[] = "kubeyaml_index_create_from_file()";
+
+    struct stat st;
+    void *map = NULL;
+    size_t size = 0;
+    int fd = -1;
+
+    if (!fileName) {
+        fprintf(stderr, "%s: The file name is null.\n", fname);
+        return NULL;
+    }
+
+    fd = open(fileName, O_RDONLY);
+    if (-1 == fd) {
+        fprintf(stderr, "%s: Cannot open the file %s.[%s]\n", fname, fileName, strerror(errno));
+        return NULL;
+    }
+    if (-1 == fstat(fd, &st)) {
+        fprintf(stderr, "%s: Cannot stat the file %s.[%s]\n", fname, fileName, strerror(errno));
+        close(fd);
+        return NULL;
+    }
+    if (!S_ISREG(st.st_mode)) {
+        fprintf(stderr, "%s: %s is not a regular file.\n", fname, fileName);
+        close(fd);
+        return NULL;
+    }
+
+    size = (size_t) st.st_size;
+    if (0 == size) {
+        close(fd);
+        return index_create("", 0, 0, 0);
+    }
+
+    map = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (MAP_FAILED == map) {
+        fprintf(stderr, "%s: Cannot map the file %s.[%s]\n", fname, fileName, strerror(errno));
+        close(fd);
+        return NULL;
+    }
+    close(fd);
+
+    return index_create((const char *) map, size, 1, 0);
+}
+
+void kubeyaml_index_free(kubeyaml_index_t * index)
+{
+    if (!index) {
+        return;
+    }
+
+    if (index->mapped) {
+        munmap((void *) index->buffer, index->length);
+    }
+    if (index->lines) {
+        kubeyaml_free(index->lines);
+    }
+
+    kubeyaml_free(index);
+}
+
+/*
+ * Lookups
+ */
+
+typedef enum index_node_type_t {
+    INDEX_NODE_NONE = 0,        /* nothing at the path */
+    INDEX_NODE_NULL,            /* a key or an entry without value */
+    INDEX_NODE_SCALAR,
+    INDEX_NODE_MAPPING,
+    INDEX_NODE_SEQUENCE
+} index_node_type_t;
+
+typedef struct index_node_t {
+    index_node_type_t type;
+    uint32_t line;              /* SCALAR: line of the value */
+    uint32_t first;             /* MAPPING, SEQUENCE: lines of the collection, the first one may be the "- key:" of its entry */
+    uint32_t end;
+} index_node_t;
+
+static void index_node_collection(const kubeyaml_index_t * index, index_node_t * node, uint32_t first, uint32_t end)
+{
+    node->first = first;
+    node->end = end;
+    if (first == end) {
+        node->type = INDEX_NODE_NULL;
+    } else if (index->lines[first].flags & KUBEYAML_INDEX_LINE_ENTRY) {
+        node->type = INDEX_NODE_SEQUENCE;
+    } else {
+        node->type = INDEX_NODE_MAPPING;
+    }
+}
+
+/* The value on the line of a key or an entry. */
+static void index_node_inline(const kubeyaml_index_t * index, index_node_t * node, uint32_t line)
+{
+    char c = index->buffer[index->lines[line].value];
+
+    node->line = line;
+    node->first = node->end = 0;
+    if ('{' == c) {
+        node->type = INDEX_NODE_MAPPING;
+    } else if ('[' == c) {
+        node->type = INDEX_NODE_SEQUENCE;
+    } else {
+        node->type = INDEX_NODE_SCALAR;
+    }
+}
+
+static void index_key_value(const kubeyaml_index_t * index, uint32_t line, index_node_t * node)
+{
+    const kubeyaml_index_line_t *lines = index->lines;
+    uint32_t column = lines[line].column;
+    uint32_t first = line + 1;
+    uint32_t j = first;
+
+    if (lines[line].flags & KUBEYAML_INDEX_LINE_VALUE) {
+        index_node_inline(index, node, line);
+        return;
+    }
+
+    if (j < index->lines_count && (lines[j].flags & KUBEYAML_INDEX_LINE_ENTRY) && lines[j].indent == column) {
+        /* A sequence written at the level of its key */
+        while (j < index->lines_count && (lines[j].flags & KUBEYAML_INDEX_LINE_ENTRY) && lines[j].indent == column) {
+            j = lines[j].next;
+        }
+    } else {
+        while (j < index->lines_count && lines[j].indent > column) {
+            j = lines[j].next;
+        }
+    }
+    index_node_collection(index, node, first, j);
+}
+
+static void index_entry_value(const kubeyaml_index_t * index, uint32_t line, index_node_t * node)
+{
+    const kubeyaml_index_line_t *lines = index->lines;
+
+    if (lines[line].flags & KUBEYAML_INDEX_LINE_KEY) {
+        node->type = INDEX_NODE_MAPPING;
+        node->first = line;
+        node->end = lines[line].next;
+    } else if (lines[line].flags & KUBEYAML_INDEX_LINE_VALUE) {
+        index_node_inline(index, node, line);
+    } else {
+        index_node_collection(index, node, line + 1, lines[line].next);
+    }
+}
+
+/* Decode the scalar in [p, eol), the result is NUL-terminated and must be freed. */
+static char *index_scalar_dup(const char *p, const char *eol)
+{
+    static char fname[] = "index_scalar_dup()";
+
+    const char *value = NULL;
+    const char *next = NULL;
+    size_t length = 0;
+    char *scratch = NULL;
+    char *copy = NULL;
+
+    scratch = kubeyaml_malloc((size_t) (eol - p) + 1);
+    if (!scratch) {
+        fprintf(stderr, "%s: Cannot allocate memory for the scalar.\n", fname);
+        return NULL;
+    }
+
+    /* The line was checked when the index was built. */
+    kubeconfig_scalar_scan(p, eol, scratch, &value, &length, &next);
+
+    if (value == scratch) {
+        scratch[length] = '\0';
+        return scratch;
+    }
+    copy = kubeyaml_strndup(value, length);
+    if (!copy) {
+        fprintf(stderr, "%s: Cannot allocate memory for the scalar.\n", fname);
+    }
+    kubeyaml_free(scratch);
+    return copy;
+}
+
+static int index_key_equals(const kubeyaml_index_t * index, uint32_t line, const char *key, size_t key_length)
+{
+    const kubeyaml_index_line_t *l = &index->lines[line];
+    const char *p = index->buffer + l->content;
+    const char *colon = index->buffer + l->colon;
+    char *decoded = NULL;
+    int equals = 0;
+
+    if ('"' != *p && '\'' != *p) {
+        while (colon > p && KUBECONFIG_SCALAR_IS_BLANK(colon[-1])) {
+            colon--;
+        }
+        return ((size_t) (colon - p) == key_length && 0 == memcmp(p, key, key_length));
+    }
+
+    decoded = index_scalar_dup(p, index->buffer + l->end);
+    if (!decoded) {
+        return 0;
+    }
+    equals = (strlen(decoded) == key_length && 0 == memcmp(decoded, key, key_length));
+    kubeyaml_free(decoded);
+    return equals;
+}
+
+/* First line after the value of the key on line. */
+static uint32_t index_key_end(const kubeyaml_index_t * index, uint32_t line)
+{
+    index_node_t node;
+
+    if (index->lines[line].flags & KUBEYAML_INDEX_LINE_VALUE) {
+        return line + 1;
+    }
+    index_key_value(index, line, &node);
+    return node.end;
+}
+
+/* The lines of the keys of a mapping, the first one may be on the line of its sequence entry. */
+static int index_mapping_is_key(const kubeyaml_index_t * index, const index_node_t * mapping, uint32_t line)
+{
+    if (line == mapping->first) {
+        return (index->lines[line].flags & KUBEYAML_INDEX_LINE_KEY) ? 1 : 0;
+    }
+    return (index->lines[line].flags & (KUBEYAML_INDEX_LINE_ENTRY | KUBEYAML_INDEX_LINE_KEY)) == KUBEYAML_INDEX_LINE_KEY;
+}
+
+static uint32_t index_mapping_next(const kubeyaml_index_t * index, uint32_t line)
+{
+    if (index->lines[line].flags & KUBEYAML_INDEX_LINE_ENTRY) {
+        /* The next key follows the value of the first one, not the whole entry. */
+        return index_key_end(index, line);
+    }
+    return index->lines[line].next;
+}
+
+/* Later keys override earlier ones, like when the kubeconfig is loaded. */
+static void index_mapping_get(const kubeyaml_index_t * index, const index_node_t * mapping, const char *key, size_t key_length, index_node_t * node)
+{
+    uint32_t found = UINT32_MAX;
+
+    node->type = INDEX_NODE_NONE;
+
+    for (uint32_t j = mapping->first; j < mapping->end; j = index_mapping_next(index, j)) {
+        if (index_mapping_is_key(index, mapping, j) && index_key_equals(index, j, key, key_length)) {
+            found = j;
+        }
+    }
+
+    if (UINT32_MAX != found) {
+        index_key_value(index, found, node);
+    }
+}
+
+static int index_scalar_equals(const kubeyaml_index_t * index, const index_node_t * node, const char *value, size_t value_length)
+{
+    const kubeyaml_index_line_t *l = NULL;
+    char *decoded = NULL;
+    int equals = 0;
+
+    if (INDEX_NODE_NULL == node->type) {
+        return (0 == value_length);
+    }
+    if (INDEX_NODE_SCALAR != node->type) {
+        return 0;
+    }
+
+    l = &index->lines[node->line];
+    decoded = index_scalar_dup(index->buffer + l->value, index->buffer + l->end);
+    if (!decoded) {
+        return 0;
+    }
+    equals = (strlen(decoded) == value_length && 0 == memcmp(decoded, value, value_length));
+    kubeyaml_free(decoded);
+    return equals;
+}
+
+/* "[i]" selects the i-th entry, "[key=value]" the first entry with this key and value. */
+static int index_sequence_get(const kubeyaml_index_t * index, const index_node_t * sequence, const char *selector, size_t selector_length, index_node_t * node)
+{
+    static char fname[] = "index_sequence_get()";
+
+    const char *equal = memchr(selector, '=', selector_length);
+    index_node_t value;
+    long position = 0;
+    char *end = NULL;
+    uint32_t j = 0;
+
+    node->type = INDEX_NODE_NONE;
+
+    if (!equal) {
+        position = strtol(selector, &end, 10);
+        if (0 == selector_length || end != selector + selector_length || position < 0) {
+            fprintf(stderr, "%s: The sequence index %.*s is invalid.\n", fname, (int) selector_length, selector);
+            return -1;
+        }
+    }
+
+    for (j = sequence->first; j < sequence->end; j = index->lines[j].next) {
+        if (!equal) {
+            if (0 == position--) {
+                index_entry_value(index, j, node);
+                return 0;
+            }
+            continue;
+        }
+
+        index_entry_value(index, j, node);
+        if (INDEX_NODE_MAPPING == node->type) {
+            index_mapping_get(index, node, selector, (size_t) (equal - selector), &value);
+            if (index_scalar_equals(index, &value, equal + 1, selector_length - (size_t) (equal - selector) - 1)) {
+                return 0;
+            }
+        }
+    }
+
+    node->type = INDEX_NODE_NONE;
+    return 0;
+}
+
+/* Find path from root, the whole document if root is NULL. */
+static int index_find(const kubeyaml_index_t * index, const index_node_t * root, const char *path, index_node_t * node)
+{
+    static char fname[] = "index_find()";
+
+    const char *p = path;
+    const char *key = NULL;
+    const char *close = NULL;
+    index_node_t parent;
+    int rc = 0;
+
+    if (!index || !path) {
+        fprintf(stderr, "%s: The index or the path is null.\n", fname);
+        return -1;
+    }
+
+    if (root) {
+        *node = *root;
+    } else {
+        node->type = INDEX_NODE_MAPPING;
+        node->first = 0;
+        node->end = index->lines_count;
+    }
+
+    while (*p) {
+        key = p;
+        while (*p && '.' != *p && '[' != *p) {
+            p++;
+        }
+        if (p == key) {
+            fprintf(stderr, "%s: The path %s is invalid.\n", fname, path);
+            return -1;
+        }
+
+        parent = *node;
+        if (INDEX_NODE_MAPPING != parent.type) {
+            node->type = INDEX_NODE_NONE;
+            return 0;
+        }
+        index_mapping_get(index, &parent, key, (size_t) (p - key), node);
+
+        while ('[' == *p) {
+            close = strchr(p, ']');
+            if (!close) {
+                fprintf(stderr, "%s: The path %s is invalid.\n", fname, path);
+                return -1;
+            }
+            parent = *node;
+            if (INDEX_NODE_SEQUENCE != parent.type) {
+                node->type = INDEX_NODE_NONE;
+                return 0;
+            }
+            rc = index_sequence_get(index, &parent, p + 1, (size_t) (close - p - 1), node);
+            if (rc) {
+                return rc;
+            }
+            p = close + 1;
+        }
+
+        if ('.' == *p) {
+            p++;
+            if (!*p) {
+                fprintf(stderr, "%s: The path %s is invalid.\n", fname, path);
+                return -1;
+            }
+        } else if (*p) {
+            fprintf(stderr, "%s: The path %s is invalid.\n", fname, path);
+            return -1;
+        }
+    }
+
+    return 0;
+}
+
+static int index_get_string(const kubeyaml_index_t * index, const index_node_t * root, const char *path, char **value)
+{
+    static char fname[] = "kubeyaml_index_get_string()";
+
+    const kubeyaml_index_line_t *line = NULL;
+    index_node_t node;
+    int rc = 0;
+
+    if (!value) {
+        fprintf(stderr, "%s: The value is null.\n", fname);
+        return -1;
+    }
+    *value = NULL;
+
+    rc = index_find(index, root, path, &node);
+    if (rc) {
+        return rc;
+    }
+
+    switch (node.type) {
+    case INDEX_NODE_NONE:
+        return 0;
+    case INDEX_NODE_NULL:
+        /* A key without value is loaded as an empty string. */
+        *value = kubeyaml_strdup("");
+        break;
+    case INDEX_NODE_SCALAR:
+        line = &index->lines[node.line];
+        *value = index_scalar_dup(index->buffer + line->value, index->buffer + line->end);
+        break;
+    default:
+        fprintf(stderr, "%s: %s is not a scalar.\n", fname, path);
+        return -1;
+    }
+
+    if (!*value) {
+        fprintf(stderr, "%s: Cannot allocate memory for the value of %s.\n", fname, path);
+        return -1;
+    }
+    return 0;
+}
+
+int kubeyaml_index_get_string(const kubeyaml_index_t * index, const char *path, char **value)
+{
+    return index_get_string(index, NULL, path, value);
+}
+
+int kubeyaml_index_get_view(const kubeyaml_index_t * index, const char *path, const char **value, size_t *length)
+{
+    static char fname[] = "kubeyaml_index_get_view()";
+
+    const kubeyaml_index_line_t *line = NULL;
+    const char *p = NULL;
+    const char *eol = NULL;
+    const char *q = NULL;
+    const char *next = NULL;
+    index_node_t node;
+    int rc = 0;
+
+    if (!value || !length) {
+        fprintf(stderr, "%s: The value is null.\n", fname);
+        return -1;
+    }
+    *value = NULL;
+    *length = 0;
+
+    rc = index_find(index, NULL, path, &node);
+    if (rc) {
+        return rc;
+    }
+
+    switch (node.type) {
+    case INDEX_NODE_NONE:
+        return 0;
+    case INDEX_NODE_NULL:
+        *value = "";
+        return 0;
+    case INDEX_NODE_SCALAR:
+        break;
+    default:
+        fprintf(stderr, "%s: %s is not a scalar.\n", fname, path);
+        return -1;
+    }
+
+    line = &index->lines[node.line];
+    p = index->buffer + line->value;
+    eol = index->buffer + line->end;
+    if ('"' == *p || '\'' == *p) {
+        /* The line was checked when the index was built, the closing quote is there. */
+        q = memchr(p + 1, *p, (size_t) (eol - p - 1));
+        if (('"' == *p && memchr(p + 1, '\\', (size_t) (q - p - 1))) || ('\'' == *p && q + 1 < eol && '\'' == q[1])) {
+            return INDEX_UNSUPPORTED;
+        }
+        *value = p + 1;
+        *length = (size_t) (q - p - 1);
+        return 0;
+    }
+
+    /* A plain scalar is returned in place, the scratch buffer is not used. */
+    kubeconfig_scalar_scan(p, eol, NULL, value, length, &next);
+    return 0;
+}
+
+/* kubectl writes "users: null" for an empty list. */
+static int index_scalar_is_null(const kubeyaml_index_t * index, const kubeyaml_index_line_t * line)
+{
+    static const char *const nulls[] = { "null", "Null", "NULL", "~" };
+
+    size_t length = line->end - line->value;
+
+    while (length > 0 && (' ' == index->buffer[line->value + length - 1] || '\t' == index->buffer[line->value + length - 1])) {
+        length--;
+    }
+    for (int i = 0; i < 4; i++) {
+        if (strlen(nulls[i]) == length && 0 == memcmp(index->buffer + line->value, nulls[i], length)) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+int kubeyaml_index_get_count(const kubeyaml_index_t * index, const char *path, int *count)
+{
+    static char fname[] = "kubeyaml_index_get_count()";
+
+    index_node_t node;
+    uint32_t j = 0;
+    int rc = 0;
+
+    if (!count) {
+        fprintf(stderr, "%s: The count is null.\n", fname);
+        return -1;
+    }
+    *count = 0;
+
+    rc = index_find(index, NULL, path, &node);
+    if (rc) {
+        return rc;
+    }
+
+    if (INDEX_NODE_SCALAR == node.type && index_scalar_is_null(index, &index->lines[node.line])) {
+        return 0;
+    }
+
+    switch (node.type) {
+    case INDEX_NODE_NONE:
+    case INDEX_NODE_NULL:
+        return 0;
+    case INDEX_NODE_SEQUENCE:
+        for (j = node.first; j < node.end; j = index->lines[j].next) {
+            (*count)++;
+        }
+        return 0;
+    default:
+        fprintf(stderr, "%s: %s is not a sequence.\n", fname, path);
+        return -1;
+    }
+}
+
+/* Offset of the start of the line, the indentation is made of spaces only. */
+static size_t index_line_start(const kubeyaml_index_t * index, uint32_t line)
+{
+    if (line >= index->lines_count) {
+        return index->length;
+    }
+    return index->lines[line].content - index->lines[line].column;
+}
+
+int kubeyaml_index_get_entries(const kubeyaml_index_t * index, const char *path, kubeyaml_index_entry_t ** entries, int *count)
+{
+    static char fname[] = "kubeyaml_index_get_entries()";
+
+    kubeyaml_index_entry_t *found = NULL;
+    index_node_t node;
+    uint32_t j = 0;
+    int rc = 0;
+
+    if (!entries || !count) {
+        fprintf(stderr, "%s: The entries or the count is null.\n", fname);
+        return -1;
+    }
+    *entries = NULL;
+
+    rc = kubeyaml_index_get_count(index, path, count);
+    if (rc || 0 == *count) {
+        return rc;
+    }
+    index_find(index, NULL, path, &node);
+
+    found = kubeyaml_calloc(*count, sizeof(kubeyaml_index_entry_t));
+    if (!found) {
+        fprintf(stderr, "%s: Cannot allocate memory for the entries of %s.\n", fname, path);
+        *count = 0;
+        return -1;
+    }
+
+    j = node.first;
+    for (int i = 0; i < *count; i++, j = index->lines[j].next) {
+        found[i].line = j;
+        found[i].offset = index_line_start(index, j);
+        found[i].length = index_line_start(index, index->lines[j].next) - found[i].offset;
+    }
+
+    *entries = found;
+    return 0;
+}
+
+int kubeyaml_index_entry_get_string(const kubeyaml_index_t * index, const kubeyaml_index_entry_t * entry, const char *path, char **value)
+{
+    static char fname[] = "kubeyaml_index_entry_get_string()";
+
+    index_node_t root;
+
+    if (!index || !entry || entry->line >= index->lines_count || !(index->lines[entry->line].flags & KUBEYAML_INDEX_LINE_ENTRY)) {
+        fprintf(stderr, "%s: The entry is invalid.\n", fname);
+        return -1;
+    }
+
+    index_entry_value(index, entry->line, &root);
+    return index_get_string(index, &root, path, value);
+}
+
+static int index_strings_append(char ***p_values, int *p_count, char *value)
+{
+    char **values = NULL;
+
+    if (!value) {
+        return -1;
+    }
+    values = kubeyaml_realloc(*p_values, (*p_count + 1) * sizeof(char *));
+    if (!values) {
+        kubeyaml_free(value);
+        return -1;
+    }
+    values[(*p_count)++] = value;
+    *p_values = values;
+    return 0;
+}
+
+static int index_mapping_collect(const kubeyaml_index_t * index, const index_node_t * mapping, const char *key, size_t key_length, char ***values, int *count)
+{
+    const kubeyaml_index_line_t *line = NULL;
+    index_node_t value;
+    int rc = 0;
+
+    for (uint32_t j = mapping->first; j < mapping->end && 0 == rc; j = index_mapping_next(index, j)) {
+        if (!index_mapping_is_key(index, mapping, j)) {
+            continue;
+        }
+        index_key_value(index, j, &value);
+        if (INDEX_NODE_MAPPING == value.type && value.first < value.end) {
+            rc = index_mapping_collect(index, &value, key, key_length, values, count);
+        } else if (INDEX_NODE_NULL == value.type && index_key_equals(index, j, key, key_length)) {
+            /* A key without value is loaded as an empty string. */
+            rc = index_strings_append(values, count, kubeyaml_strdup(""));
+        } else if (INDEX_NODE_SCALAR == value.type && index_key_equals(index, j, key, key_length)) {
+            line = &index->lines[value.line];
+            rc = index_strings_append(values, count, index_scalar_dup(index->buffer + line->value, index->buffer + line->end));
+        }
+    }
+    return rc;
+}
+
+int kubeyaml_index_entry_get_strings(const kubeyaml_index_t * index, const kubeyaml_index_entry_t * entry, const char *key, char ***values, int *count)
+{
+    static char fname[] = "kubeyaml_index_entry_get_strings()";
+
+    index_node_t root;
+    int rc = 0;
+
+    if (!values || !count) {
+        fprintf(stderr, "%s: The values or the count is null.\n", fname);
+        return -1;
+    }
+    *values = NULL;
+    *count = 0;
+
+    if (!index || !entry || !key || entry->line >= index->lines_count || !(index->lines[entry->line].flags & KUBEYAML_INDEX_LINE_ENTRY)) {
+        fprintf(stderr, "%s: The entry is invalid.\n", fname);
+        return -1;
+    }
+
+    index_entry_value(index, entry->line, &root);
+    if (INDEX_NODE_MAPPING != root.type) {
+        return 0;
+    }
+
+    rc = index_mapping_collect(index, &root, key, strlen(key), values, count);
+    if (rc) {
+        fprintf(stderr, "%s: Cannot allocate memory for the values of %s.\n", fname, key);
+        for (int i = 0; i < *count; i++) {
+            kubeyaml_free((*values)[i]);
+        }
+        kubeyaml_free(*values);
+        *values = NULL;
+        *count = 0;
+    }
+    return rc;
+}
@@ -0,0 +1,269 @@
+#ifndef _KUBE_CONFIG_INDEX_H
+#define _KUBE_CONFIG_INDEX_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef  __cplusplus
+extern "C" {
+#endif
+
+/*
+ * The kubeconfig index answers single-field lookups on a kubeconfig without
+ * loading all of it into a kubeconfig_t.
+ *
+ * A first pass over the bytes, using SSE4.2 or AVX2 when the CPU has them,
+ * collects the offsets of the line breaks, colons, comments and quotes. A
+ * second pass turns them into one record per line with its indentation, the
+ * position of its key and value, and the next line that is not nested in
+ * it. A lookup then only decodes the keys along its path and the scalar it
+ * returns, and jumps over the sub-trees it does not need.
+ *
+ * Like the fast path of kubeyaml_load_kubeconfig(), the index handles the
+ * YAML subset kubectl writes: block mappings and sequences, single-line
+ * plain or quoted scalars, comments and the empty collections {} and [].
+ * kubeyaml_index_create() fails on any other input, which can still be
+ * loaded with kubeyaml_load_kubeconfig().
+ */
+
+#define KUBEYAML_INDEX_LINE_ENTRY   0x0001      /* the line starts a sequence entry "- " */
+#define KUBEYAML_INDEX_LINE_KEY     0x0002      /* the line has a mapping key */
+#define KUBEYAML_INDEX_LINE_VALUE   0x0004      /* a scalar, {} or [] follows on the line */
+
+    typedef struct kubeyaml_index_line_t {
+        uint32_t content;       /* offset of the key or the value, after "- " on a sequence entry */
+        uint32_t colon;         /* offset of the ':' after the key */
+        uint32_t value;         /* offset of the value on the line */
+        uint32_t end;           /* offset of the end of the line, CR excluded */
+        uint32_t next;          /* first following line that is not nested in this one */
+        uint16_t indent;        /* column of the line, the "-" of a sequence entry */
+        uint16_t column;        /* column of the content */
+        uint16_t flags;         /* KUBEYAML_INDEX_LINE_* */
+    } kubeyaml_index_line_t;
+
+    typedef struct kubeyaml_index_t {
+        const char *buffer;
+        size_t length;
+        int mapped;             /* buffer is a mapping of the file, owned by the index */
+        kubeyaml_index_line_t *lines;
+        uint32_t lines_count;
+    } kubeyaml_index_t;
+
+/*
+ * kubeyaml_index_create
+ *
+ * Description:
+ *
+ * Index a kubeconfig held in memory. The buffer is not copied, it must
+ * stay valid and unchanged until the index is freed.
+ *
+ * Return:
+ *
+ *   The index, or NULL if the buffer is not in the YAML subset the index
+ *   handles or the memory cannot be allocated.
+ *
+ * Parameter:
+ *
+ * IN:
+ * buffer: kubeconfig yaml text, it does not need to be NUL-terminated
+ * length: number of bytes in buffer
+ *
+ */
+    kubeyaml_index_t *kubeyaml_index_create(const char *buffer, size_t length);
+
+/*
+ * Like kubeyaml_index_create(), without an error message when the buffer
+ * is not in the subset, for callers that parse it another way then.
+ */
+    kubeyaml_index_t *kubeyaml_index_try_create(const char *buffer, size_t length);
+
+/*
+ * kubeyaml_index_create_from_file
+ *
+ * Description:
+ *
+ * Map the kubeconfig file and index it. The mapping is kept until the
+ * index is freed.
+ *
+ * Return:
+ *
+ *   The index, or NULL if the file cannot be mapped, is not in the YAML
+ *   subset the index handles or the memory cannot be allocated.
+ *
+ * Parameter:
+ *
+ * IN:
+ * fileName: kubernetes cluster configuration file name
+ *
+ */
+    kubeyaml_index_t *kubeyaml_index_create_from_file(const char *fileName);
+
+    void kubeyaml_index_free(kubeyaml_index_t * index);
+
+/*
+ * kubeyaml_index_get_string
+ *
+ * Description:
+ *
+ * Get the scalar at path, e.g. "current-context",
+ * "users[1].user.token", "users[name=admin].user.exec.args[0]" or
+ * "clusters[name=prod].cluster.server".
+ *
+ * A path is a list of mapping keys separated by '.', each key may be
+ * followed by "[i]" to select the i-th entry of a sequence, or by
+ * "[key=value]" to select the first entry of a sequence that is a mapping
+ * with this key and value.
+ *
+ * Return:
+ *
+ *   0     Success, *value is NULL if there is nothing at path
+ *  -1     Failed, the path is invalid or does not lead to a scalar
+ *
+ * Parameter:
+ *
+ * IN:
+ * index: kubeconfig index
+ * path: path of the scalar
+ *
+ * OUT:
+ * value: copy of the scalar, the caller needs to free it
+ *
+ */
+    int kubeyaml_index_get_string(const kubeyaml_index_t * index, const char *path, char **value);
+
+/*
+ * kubeyaml_index_get_view
+ *
+ * Description:
+ *
+ * Like kubeyaml_index_get_string() without copying the scalar: *value
+ * points into the buffer of the index and is not NUL-terminated.
+ *
+ * Return:
+ *
+ *   0     Success, *value is NULL if there is nothing at path
+ *   1     The scalar is quoted with escapes, it is not in the buffer as is
+ *  -1     Failed, the path is invalid or does not lead to a scalar
+ *
+ * Parameter:
+ *
+ * IN:
+ * index: kubeconfig index
+ * path: path of the scalar, see kubeyaml_index_get_string()
+ *
+ * OUT:
+ * value: start of the scalar in the buffer
+ * length: length of the scalar
+ *
+ */
+    int kubeyaml_index_get_view(const kubeyaml_index_t * index, const char *path, const char **value, size_t *length);
+
+/*
+ * kubeyaml_index_get_count
+ *
+ * Description:
+ *
+ * Get the number of entries of the sequence at path, e.g. "users" or
+ * "users[name=admin].user.exec.env".
+ *
+ * Return:
+ *
+ *   0     Success, *count is 0 if there is nothing at path
+ *  -1     Failed, the path is invalid or does not lead to a sequence
+ *
+ * Parameter:
+ *
+ * IN:
+ * index: kubeconfig index
+ * path: path of the sequence, see kubeyaml_index_get_string()
+ *
+ * OUT:
+ * count: number of entries
+ *
+ */
+    int kubeyaml_index_get_count(const kubeyaml_index_t * index, const char *path, int *count);
+
+/*
+ * An entry of a sequence as a range of the buffer: it starts at the
+ * beginning of the line of its "-" and ends at the beginning of the line
+ * of the next entry, or of the first line after the sequence.
+ */
+    typedef struct kubeyaml_index_entry_t {
+        size_t offset;
+        size_t length;
+        uint32_t line;          /* line of the "-" */
+    } kubeyaml_index_entry_t;
+
+/*
+ * kubeyaml_index_get_entries
+ *
+ * Description:
+ *
+ * Get the entries of the sequence at path, e.g. "users", in the order of
+ * the buffer.
+ *
+ * Return:
+ *
+ *   0     Success, *entries is NULL and *count is 0 if there is nothing at path
+ *  -1     Failed, the path is invalid or does not lead to a sequence
+ *
+ * Parameter:
+ *
+ * IN:
+ * index: kubeconfig index
+ * path: path of the sequence, see kubeyaml_index_get_string()
+ *
+ * OUT:
+ * entries: array of *count entries, the caller needs to free it
+ * count: number of entries
+ *
+ */
+    int kubeyaml_index_get_entries(const kubeyaml_index_t * index, const char *path, kubeyaml_index_entry_t ** entries, int *count);
+
+/*
+ * kubeyaml_index_entry_get_string
+ *
+ * Description:
+ *
+ * Like kubeyaml_index_get_string() with a path starting at a sequence
+ * entry, e.g. "name" or "context.cluster" for an entry of "contexts".
+ *
+ */
+    int kubeyaml_index_entry_get_string(const kubeyaml_index_t * index, const kubeyaml_index_entry_t * entry, const char *path, char **value);
+
+/*
+ * kubeyaml_index_entry_get_strings
+ *
+ * Description:
+ *
+ * Get the scalars of key in the mapping of a sequence entry and in the
+ * mappings nested in it, in the order of the buffer. Sequences are not
+ * searched. A key without value gives an empty string.
+ *
+ * The loader fills a property from every mapping nested in its entry, e.g.
+ * the "cluster" mapping of a cluster, so these are all the values a field
+ * of the property may get.
+ *
+ * Return:
+ *
+ *   0     Success, *values is NULL and *count is 0 if key is not found
+ *  -1     Failed
+ *
+ * Parameter:
+ *
+ * IN:
+ * index: kubeconfig index
+ * entry: entry of a sequence, see kubeyaml_index_get_entries()
+ * key: mapping key, e.g. "name"
+ *
+ * OUT:
+ * values: copies of the *count scalars, the caller needs to free them and the array
+ * count: number of values
+ *
+ */
+    int kubeyaml_index_entry_get_strings(const kubeyaml_index_t * index, const kubeyaml_index_entry_t * entry, const char *key, char ***values, int *count);
+
+#ifdef  __cplusplus
+}
+#endif
+#endif                          /* _KUBE_CONFIG_INDEX_H */
@@ -0,0 +1,122 @@
+#include <string.h>
+#include "kube_config_intern.h"
+#include "kube_config_alloc.h"
+
+#define STRINGS_INITIAL_CAPACITY 64
+
+kubeconfig_strings_t *kubeconfig_strings_create()
+{
+    kubeconfig_strings_t *strings = kubeyaml_calloc(1, sizeof(kubeconfig_strings_t));
+    if (!strings) {
+        return NULL;
+    }
+    strings->arena = kubeconfig_arena_create();
+    strings->slots = kubeyaml_calloc(STRINGS_INITIAL_CAPACITY, sizeof(kubeconfig_strings_slot_t));
+    if (!strings->arena || !strings->slots) {
+        kubeconfig_arena_free(strings->arena);
+        kubeyaml_free(strings->slots);
+        kubeyaml_free(strings);
+        return NULL;
+    }
+    strings->capacity = STRINGS_INITIAL_CAPACITY;
+    strings->refs = 1;
+    return strings;
+}
+
+kubeconfig_strings_t *kubeconfig_strings_ref(kubeconfig_strings_t * strings)
+{
+    if (strings) {
+        strings->refs++;
+    }
+    return strings;
+}
+
+void kubeconfig_strings_release(kubeconfig_strings_t * strings)
+{
+    if (!strings || --strings->refs > 0) {
+        return;
+    }
+    kubeconfig_arena_free(strings->arena);
+    kubeyaml_free(strings->slots);
+    kubeyaml_free(strings);
+}
+
+/* FNV-1a */
+static uint32_t strings_hash(const char *string, size_t length)
+{
+    uint32_t hash = 2166136261u;
+
+    for (size_t i = 0; i < length; i++) {
+        hash ^= (unsigned char) string[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+static int strings_grow(kubeconfig_strings_t * strings)
+{
+    kubeconfig_strings_slot_t *slots = NULL;
+    size_t capacity = strings->capacity * 2;
+    size_t mask = capacity - 1;
+    size_t j = 0;
+
+    slots = kubeyaml_calloc(capacity, sizeof(kubeconfig_strings_slot_t));
+    if (!slots) {
+        return -1;
+    }
+    for (size_t i = 0; i < strings->capacity; i++) {
+        if (strings->slots[i].string) {
+            for (j = strings->slots[i].hash & mask; slots[j].string; j = (j + 1) & mask) {
+            }
+            slots[j] = strings->slots[i];
+        }
+    }
+    kubeyaml_free(strings->slots);
+    strings->slots = slots;
+    strings->capacity = capacity;
+    return 0;
+}
+
+char *kubeconfig_strings_intern(kubeconfig_strings_t * strings, const char *string, size_t length)
+{
+    kubeconfig_strings_slot_t *slot = NULL;
+    uint32_t hash = 0;
+    char *copy = NULL;
+    size_t mask = 0;
+    size_t i = 0;
+
+    /* Too long to be a name, it gets a copy of its own. */
+    if (length > UINT32_MAX) {
+        return kubeconfig_arena_strndup(strings->arena, string, length);
+    }
+
+    /* At most 3/4 full, so that a probe ends on a free slot. */
+    if ((strings->count + 1) * 4 > strings->capacity * 3 && 0 != strings_grow(strings)) {
+        return NULL;
+    }
+
+    hash = strings_hash(string, length);
+    mask = strings->capacity - 1;
+    for (i = hash & mask; strings->slots[i].string; i = (i + 1) & mask) {
+        slot = &strings->slots[i];
+        if (slot->hash == hash && slot->length == length && 0 == memcmp(slot->string, string, length)) {
+            return (char *) slot->string;
+        }
+    }
+
+    copy = kubeconfig_arena_strndup(strings->arena, string, length);
+    if (!copy) {
+        return NULL;
+    }
+    slot = &strings->slots[i];
+    slot->string = copy;
+    slot->hash = hash;
+    slot->length = (uint32_t) length;
+    strings->count++;
+    return copy;
+}
+
+int kubeconfig_strings_owns(const kubeconfig_strings_t * strings, const void *ptr)
+{
+    return strings ? kubeconfig_arena_owns(strings->arena, ptr) : 0;
+}
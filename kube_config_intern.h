@@ -0,0 +1,58 @@
+#ifndef _KUBE_CONFIG_INTERN_H
+#define _KUBE_CONFIG_INTERN_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "kube_config_arena.h"
+
+#ifdef  __cplusplus
+extern "C" {
+#endif
+
+/*
+ * An interning table keeps one copy of each string put into it. The names
+ * of a kubeconfig loaded with KUBEYAML_LOAD_INTERN are interned: the
+ * cluster of a context and the name of the cluster are then the same
+ * pointer, and comparing them is comparing the pointers.
+ *
+ * The copies are allocated from an arena of the table and freed with it,
+ * they must not be freed one by one. A table is shared by the kubeconfigs
+ * that hold a reference to it and freed with the last one.
+ */
+
+    typedef struct kubeconfig_strings_slot_t {
+        const char *string;     /* NULL if the slot is free */
+        uint32_t hash;
+        uint32_t length;
+    } kubeconfig_strings_slot_t;
+
+    typedef struct kubeconfig_strings_t {
+        kubeconfig_arena_t *arena;      /* the copies */
+        kubeconfig_strings_slot_t *slots;       /* open addressing, capacity is a power of 2 */
+        size_t capacity;
+        size_t count;
+        int refs;
+    } kubeconfig_strings_t;
+
+    kubeconfig_strings_t *kubeconfig_strings_create();
+
+/* Take a reference to strings, which may be NULL. */
+    kubeconfig_strings_t *kubeconfig_strings_ref(kubeconfig_strings_t * strings);
+
+/* Drop a reference to strings, the table is freed with the last one. */
+    void kubeconfig_strings_release(kubeconfig_strings_t * strings);
+
+/*
+ * Return the copy of the length bytes at string in the table, adding it if
+ * there is none yet. string does not need to be NUL-terminated, the copy is.
+ * NULL if the memory cannot be allocated.
+ */
+    char *kubeconfig_strings_intern(kubeconfig_strings_t * strings, const char *string, size_t length);
+
+/* 1 if ptr is a copy held by the table, 0 otherwise. strings may be NULL. */
+    int kubeconfig_strings_owns(const kubeconfig_strings_t * strings, const void *ptr);
+
+#ifdef  __cplusplus
+}
+#endif
+#endif                          /* _KUBE_CONFIG_INTERN_H */
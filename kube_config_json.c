@@ -0,0 +1,550 @@
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "kube_config_json.h"
+#include "kube_config_keys.h"
+#include "kube_config_scalar.h"
+#include "kube_config_alloc.h"
+
+#define JSON_MAX_LEVELS 64
+
+/*
+ * Strings
+ *
+ * Tokens and certificates are long base64 strings, the scan for the end of
+ * a string only stops on the bytes that need a closer look: the quote, the
+ * backslash, and the control, DEL or non-ASCII bytes. It is the span of the
+ * quoted scalars of the fast path, see kube_config_scalar.c.
+ */
+
+const char *kubeconfig_json_string_end(const char *p, const char *end, int *escaped)
+{
+    const char *q = p + 1;
+
+    *escaped = 0;
+    for (;;) {
+        q = kubeconfig_scalar_span(q, end, '"', '\\');
+        if (q == end) {
+            return NULL;
+        }
+        if ('"' == *q) {
+            return q;
+        }
+        if ('\\' != *q || q + 1 == end || !KUBECONFIG_SCALAR_IS_TEXT(q[1]) || '\t' == q[1]) {
+            return NULL;
+        }
+        /* The escape itself is checked when the string is unescaped. */
+        *escaped = 1;
+        q += 2;
+    }
+}
+
+static int json_number(const char *p, const char *end)
+{
+    if (p < end && '-' == *p) {
+        p++;
+    }
+    if (p == end || !isdigit((unsigned char) *p)) {
+        return 0;
+    }
+    if ('0' == *p) {
+        p++;
+    } else {
+        while (p < end && isdigit((unsigned char) *p)) {
+            p++;
+        }
+    }
+    if (p < end && '.' == *p) {
+        if (++p == end || !isdigit((unsigned char) *p)) {
+            return 0;
+        }
+        while (p < end && isdigit((unsigned char) *p)) {
+            p++;
+        }
+    }
+    if (p < end && ('e' == *p || 'E' == *p)) {
+        if (++p < end && ('+' == *p || '-' == *p)) {
+            p++;
+        }
+        if (p == end || !isdigit((unsigned char) *p)) {
+            return 0;
+        }
+        while (p < end && isdigit((unsigned char) *p)) {
+            p++;
+        }
+    }
+    return (p == end);
+}
+
+const char *kubeconfig_json_literal_end(const char *p, const char *end)
+{
+    const char *q = p;
+    size_t length = 0;
+
+    while (q < end && (isalnum((unsigned char) *q) || '-' == *q || '+' == *q || '.' == *q)) {
+        q++;
+    }
+    length = (size_t) (q - p);
+
+    if ((4 == length && (0 == memcmp(p, "true", 4) || 0 == memcmp(p, "null", 4))) || (5 == length && 0 == memcmp(p, "false", 5)) || (length && json_number(p, q))) {
+        return q;
+    }
+    return NULL;
+}
+
+/*
+ * ExecCredential
+ *
+ * A recursive descent over the members of the objects. The members the
+ * ExecCredential_t has no field for are only checked, so that invalid JSON
+ * is still left to libyaml and gives the same error.
+ */
+
+typedef struct json_parser_t {
+    const char *p;
+    const char *end;
+    int depth;
+    char *scratch;              /* unescaped text of strings with escapes */
+    size_t scratch_size;
+} json_parser_t;
+
+/* key may be in the scratch buffer, it is only valid until the value is scanned. */
+typedef int (*json_member_t)(json_parser_t * parser, const char *key, size_t length, void *data);
+
+static void json_space(json_parser_t * parser)
+{
+    while (parser->p < parser->end && KUBECONFIG_JSON_IS_SPACE(*parser->p)) {
+        parser->p++;
+    }
+}
+
+static int json_string(json_parser_t * parser, const char **value, size_t *length)
+{
+    const char *q = NULL;
+    const char *next = NULL;
+    char *scratch = NULL;
+    int escaped = 0;
+
+    q = kubeconfig_json_string_end(parser->p, parser->end, &escaped);
+    if (!q) {
+        return KUBECONFIG_JSON_UNSUPPORTED;
+    }
+
+    if (escaped) {
+        /* The unescaped text is never longer than the quoted one. */
+        if (parser->scratch_size < (size_t) (q + 1 - parser->p)) {
+            scratch = kubeyaml_realloc(parser->scratch, (size_t) (q + 1 - parser->p));
+            if (!scratch) {
+                return KUBECONFIG_JSON_UNSUPPORTED;
+            }
+            parser->scratch = scratch;
+            parser->scratch_size = (size_t) (q + 1 - parser->p);
+        }
+        if (kubeconfig_scalar_scan(parser->p, q + 1, parser->scratch, value, length, &next)) {
+            return KUBECONFIG_JSON_UNSUPPORTED;
+        }
+    } else {
+        *value = parser->p + 1;
+        *length = (size_t) (q - parser->p - 1);
+    }
+    parser->p = q + 1;
+    return 0;
+}
+
+/* A string, true, false, null or a number, as the text libyaml gives for it. */
+static int json_scalar(json_parser_t * parser, const char **value, size_t *length)
+{
+    const char *q = NULL;
+
+    if ('"' == *parser->p) {
+        return json_string(parser, value, length);
+    }
+    q = kubeconfig_json_literal_end(parser->p, parser->end);
+    if (!q) {
+        return KUBECONFIG_JSON_UNSUPPORTED;
+    }
+    *value = parser->p;
+    *length = (size_t) (q - parser->p);
+    parser->p = q;
+    return 0;
+}
+
+static int json_members(json_parser_t * parser, json_member_t member, void *data);
+
+static int json_skip_member(json_parser_t * parser, const char *key, size_t length, void *data);
+
+/* Check and skip the value at parser->p. */
+static int json_skip(json_parser_t * parser)
+{
+    const char *value = NULL;
+    size_t length = 0;
+
+    if ('{' == *parser->p) {
+        return json_members(parser, json_skip_member, NULL);
+    }
+    if ('[' != *parser->p) {
+        return json_scalar(parser, &value, &length);
+    }
+
+    if (++parser->depth > JSON_MAX_LEVELS) {
+        return KUBECONFIG_JSON_UNSUPPORTED;
+    }
+    parser->p++;
+    json_space(parser);
+    if (parser->p < parser->end && ']' == *parser->p) {
+        parser->p++;
+        parser->depth--;
+        return 0;
+    }
+    for (;;) {
+        if (parser->p == parser->end || json_skip(parser)) {
+            return KUBECONFIG_JSON_UNSUPPORTED;
+        }
+        json_space(parser);
+        if (parser->p == parser->end) {
+            return KUBECONFIG_JSON_UNSUPPORTED;
+        }
+        if (']' == *parser->p) {
+            parser->p++;
+            parser->depth--;
+            return 0;
+        }
+        if (',' != *parser->p) {
+            return KUBECONFIG_JSON_UNSUPPORTED;
+        }
+        parser->p++;
+        json_space(parser);
+    }
+}
+
+static int json_skip_member(json_parser_t * parser, const char *key, size_t length, void *data)
+{
+    return json_skip(parser);
+}
+
+/*
+ * Walk the members of the object at parser->p. member is called with
+ * parser->p on the value of each member, and must consume it.
+ */
+static int json_members(json_parser_t * parser, json_member_t member, void *data)
+{
+    const char *key = NULL;
+    size_t length = 0;
+    int rc = 0;
+
+    if (++parser->depth > JSON_MAX_LEVELS) {
+        return KUBECONFIG_JSON_UNSUPPORTED;
+    }
+    parser->p++;
+    json_space(parser);
+    if (parser->p < parser->end && '}' == *parser->p) {
+        parser->p++;
+        parser->depth--;
+        return 0;
+    }
+    for (;;) {
+        if (parser->p == parser->end || '"' != *parser->p) {
+            return KUBECONFIG_JSON_UNSUPPORTED;
+        }
+        rc = json_string(parser, &key, &length);
+        if (rc) {
+            return rc;
+        }
+        json_space(parser);
+        if (parser->p == parser->end || ':' != *parser->p) {
+            return KUBECONFIG_JSON_UNSUPPORTED;
+        }
+        parser->p++;
+        json_space(parser);
+        if (parser->p == parser->end) {
+            return KUBECONFIG_JSON_UNSUPPORTED;
+        }
+        rc = member(parser, key, length, data);
+        if (rc) {
+            return rc;
+        }
+        json_space(parser);
+        if (parser->p == parser->end) {
+            return KUBECONFIG_JSON_UNSUPPORTED;
+        }
+        if ('}' == *parser->p) {
+            parser->p++;
+            parser->depth--;
+            return 0;
+        }
+        if (',' != *parser->p) {
+            return KUBECONFIG_JSON_UNSUPPORTED;
+        }
+        parser->p++;
+        json_space(parser);
+    }
+}
+
+/* Set *p_string to a copy of the scalar at parser->p, a collection is skipped. */
+static int json_set_string(json_parser_t * parser, char **p_string, int *is_set)
+{
+    static char fname[] = "kubeconfig_json_parse_exec_credential()";
+
+    const char *value = NULL;
+    size_t length = 0;
+    char *string = NULL;
+    int rc = 0;
+
+    *is_set = 0;
+    if ('{' == *parser->p || '[' == *parser->p) {
+        return json_skip(parser);
+    }
+
+    rc = json_scalar(parser, &value, &length);
+    if (rc) {
+        return rc;
+    }
+    string = kubeyaml_strndup(value, length);
+    if (!string) {
+        fprintf(stderr, "%s: Cannot allocate memory for the exec credential.\n", fname);
+        return -1;
+    }
+    if (*p_string) {
+        kubeyaml_free(*p_string);
+    }
+    *p_string = string;
+    *is_set = 1;
+    return 0;
+}
+
+static int json_status_member(json_parser_t * parser, const char *key, size_t length, void *data)
+{
+    ExecCredential_status_t *status = data;
+    int is_set = 0;
+    int rc = 0;
+
+    switch (kubeconfig_key_lookup(key, length)) {
+    case KUBECONFIG_KEY_TOKEN:
+        rc = json_set_string(parser, &status->token, &is_set);
+        if (is_set) {
+            status->type = EXEC_CREDENTIAL_TYPE_TOKEN;
+        }
+        return rc;
+    case KUBECONFIG_KEY_CLIENT_CERTIFICATE_DATA2:
+        rc = json_set_string(parser, &status->clientCertificateData, &is_set);
+        if (is_set) {
+            status->type = EXEC_CREDENTIAL_TYPE_CLIENT_CERT;
+        }
+        return rc;
+    case KUBECONFIG_KEY_CLIENT_KEY_DATA2:
+        rc = json_set_string(parser, &status->clientKeyData, &is_set);
+        if (is_set) {
+            status->type = EXEC_CREDENTIAL_TYPE_CLIENT_CERT;
+        }
+        return rc;
+    default:
+        return json_skip(parser);
+    }
+}
+
+static int json_exec_credential_member(json_parser_t * parser, const char *key, size_t length, void *data)
+{
+    static char fname[] = "kubeconfig_json_parse_exec_credential()";
+
+    ExecCredential_t *exec_credential = data;
+    ExecCredential_status_t *status = NULL;
+    int is_set = 0;
+    int rc = 0;
+
+    switch (kubeconfig_key_lookup(key, length)) {
+    case KUBECONFIG_KEY_APIVERSION:
+        return json_set_string(parser, &exec_credential->apiVersion, &is_set);
+    case KUBECONFIG_KEY_KIND:
+        return json_set_string(parser, &exec_credential->kind, &is_set);
+    case KUBECONFIG_KEY_STATUS:
+        if ('[' == *parser->p) {
+            /* Not an object, leave it to libyaml. */
+            return KUBECONFIG_JSON_UNSUPPORTED;
+        }
+        if ('{' != *parser->p) {
+            return json_skip(parser);
+        }
+        status = exec_credential_status_create();
+        if (!status) {
+            fprintf(stderr, "%s: Cannot allocate memory for kubeconfig exec credential status.\n", fname);
+            return -1;
+        }
+        rc = json_members(parser, json_status_member, status);
+        if (rc) {
+            exec_credential_status_free(status);
+            return rc;
+        }
+        if (exec_credential->status) {
+            exec_credential_status_free(exec_credential->status);
+        }
+        exec_credential->status = status;
+        return 0;
+    default:
+        return json_skip(parser);
+    }
+}
+
+static void json_move_string(char **to, char **from)
+{
+    if (*from) {
+        if (*to) {
+            kubeyaml_free(*to);
+        }
+        *to = *from;
+        *from = NULL;
+    }
+}
+
+int kubeconfig_json_parse_exec_credential_with_scratch(ExecCredential_t * exec_credential, const char *buf, size_t len, char **scratch, size_t *scratch_size)
+{
+    json_parser_t parser;
+    ExecCredential_t parsed;
+    int rc = 0;
+
+    memset(&parser, 0, sizeof(parser));
+    parser.p = buf;
+    parser.end = buf + len;
+    parser.scratch = *scratch;
+    parser.scratch_size = *scratch_size;
+    memset(&parsed, 0, sizeof(parsed));
+
+    json_space(&parser);
+    if (parser.p == parser.end || '{' != *parser.p) {
+        return KUBECONFIG_JSON_UNSUPPORTED;
+    }
+    rc = json_members(&parser, json_exec_credential_member, &parsed);
+    if (0 == rc) {
+        /* Only blanks may follow the object. */
+        json_space(&parser);
+        if (parser.p != parser.end) {
+            rc = KUBECONFIG_JSON_UNSUPPORTED;
+        }
+    }
+
+    if (0 == rc) {
+        json_move_string(&exec_credential->apiVersion, &parsed.apiVersion);
+        json_move_string(&exec_credential->kind, &parsed.kind);
+        if (parsed.status) {
+            if (exec_credential->status) {
+                exec_credential_status_free(exec_credential->status);
+            }
+            exec_credential->status = parsed.status;
+            parsed.status = NULL;
+        }
+    }
+
+    *scratch = parser.scratch;
+    *scratch_size = parser.scratch_size;
+    if (parsed.apiVersion) {
+        kubeyaml_free(parsed.apiVersion);
+    }
+    if (parsed.kind) {
+        kubeyaml_free(parsed.kind);
+    }
+    if (parsed.status) {
+        exec_credential_status_free(parsed.status);
+    }
+    return rc;
+}
+
+int kubeconfig_json_parse_exec_credential(ExecCredential_t * exec_credential, const char *buf, size_t len)
+{
+    char *scratch = NULL;
+    size_t scratch_size = 0;
+    int rc = 0;
+
+    rc = kubeconfig_json_parse_exec_credential_with_scratch(exec_credential, buf, len, &scratch, &scratch_size);
+    if (scratch) {
+        kubeyaml_free(scratch);
+    }
+    return rc;
+}
+
+/*
+ * Member lookup
+ */
+
+typedef struct json_view_t {
+    const char *const *keys;
+    int keys_count;
+    int level;                  /* number of keys matched by the enclosing objects */
+    const char *value;
+    size_t length;
+} json_view_t;
+
+static int json_view_member(json_parser_t * parser, const char *key, size_t length, void *data)
+{
+    json_view_t *view = data;
+    const char *value = NULL;
+    size_t value_length = 0;
+    int rc = 0;
+
+    if (strlen(view->keys[view->level]) != length || 0 != memcmp(view->keys[view->level], key, length)) {
+        return json_skip(parser);
+    }
+
+    if (view->level + 1 < view->keys_count) {
+        if ('{' != *parser->p) {
+            return json_skip(parser);
+        }
+        view->level++;
+        rc = json_members(parser, json_view_member, view);
+        view->level--;
+        return rc;
+    }
+
+    if ('"' != *parser->p) {
+        return KUBECONFIG_JSON_UNSUPPORTED;
+    }
+    rc = json_string(parser, &value, &value_length);
+    if (rc) {
+        return rc;
+    }
+    if (value == parser->scratch) {
+        /* Unescaped, not a view of the input. */
+        return KUBECONFIG_JSON_UNSUPPORTED;
+    }
+    /* Like libyaml, the last one of duplicate keys wins. */
+    view->value = value;
+    view->length = value_length;
+    return 0;
+}
+
+int kubeconfig_json_get_view(const char *buf, size_t len, const char *const *keys, int keys_count, const char **value, size_t *length)
+{
+    json_parser_t parser;
+    json_view_t view;
+    int rc = 0;
+
+    *value = NULL;
+    *length = 0;
+
+    memset(&parser, 0, sizeof(parser));
+    parser.p = buf;
+    parser.end = buf + len;
+    memset(&view, 0, sizeof(view));
+    view.keys = keys;
+    view.keys_count = keys_count;
+
+    json_space(&parser);
+    if (keys_count < 1 || parser.p == parser.end || '{' != *parser.p) {
+        return KUBECONFIG_JSON_UNSUPPORTED;
+    }
+    rc = json_members(&parser, json_view_member, &view);
+    if (0 == rc) {
+        json_space(&parser);
+        if (parser.p != parser.end) {
+            rc = KUBECONFIG_JSON_UNSUPPORTED;
+        }
+    }
+    if (parser.scratch) {
+        kubeyaml_free(parser.scratch);
+    }
+
+    if (0 == rc) {
+        *value = view.value;
+        *length = view.length;
+    }
+    return rc;
+}
@@ -0,0 +1,70 @@
+#ifndef _KUBE_CONFIG_JSON_H
+#define _KUBE_CONFIG_JSON_H
+
+#include <stddef.h>
+#include "kube_config_model.h"
+#include "kube_config_scalar.h"
+
+#ifdef  __cplusplus
+extern "C" {
+#endif
+
+/*
+ * JSON written by kubectl and the exec plugins. The functions return
+ * KUBECONFIG_JSON_UNSUPPORTED for input they do not handle (invalid JSON,
+ * tabs, control or non-ASCII characters ...), the caller then leaves the
+ * input to libyaml, which reads JSON as YAML flow collections.
+ */
+
+#define KUBECONFIG_JSON_UNSUPPORTED KUBECONFIG_SCALAR_UNSUPPORTED
+
+#define KUBECONFIG_JSON_IS_SPACE(c) (' ' == (c) || '\n' == (c) || '\r' == (c))
+
+/*
+ * Find the closing quote of the string whose opening quote is at p, 16 or
+ * 32 bytes at a time when the CPU supports it. *escaped is set if the
+ * string has a backslash escape.
+ *
+ * Return the closing quote, or NULL if the string is not closed before end
+ * or has a control, DEL or non-ASCII byte.
+ */
+    const char *kubeconfig_json_string_end(const char *p, const char *end, int *escaped);
+
+/*
+ * Return the end of the true, false, null or number at p, or NULL if there
+ * is none.
+ */
+    const char *kubeconfig_json_literal_end(const char *p, const char *end);
+
+/*
+ * Fill exec_credential from the ExecCredential JSON an exec plugin prints:
+ * apiVersion, kind, and the token or the client certificate and key of the
+ * status. Other fields are checked and skipped.
+ *
+ * Return 0 on success, -1 if the memory cannot be allocated, or
+ * KUBECONFIG_JSON_UNSUPPORTED with exec_credential unchanged.
+ */
+    int kubeconfig_json_parse_exec_credential(ExecCredential_t * exec_credential, const char *buf, size_t len);
+
+/*
+ * Like kubeconfig_json_parse_exec_credential(), unescaping strings into
+ * *scratch, a buffer of *scratch_size bytes that is grown as needed and
+ * kept for the caller to reuse and free.
+ */
+    int kubeconfig_json_parse_exec_credential_with_scratch(ExecCredential_t * exec_credential, const char *buf, size_t len, char **scratch, size_t *scratch_size);
+
+/*
+ * Find the string member at keys[0], keys[1] ... of the nested objects of
+ * the JSON text in buf, e.g. "data", "value" in a Secret. *value points
+ * into buf and is not NUL-terminated, or is NULL if there is no such
+ * member.
+ *
+ * Return 0 on success, or KUBECONFIG_JSON_UNSUPPORTED if the text is not
+ * handled or the member is not a string, or has escapes.
+ */
+    int kubeconfig_json_get_view(const char *buf, size_t len, const char *const *keys, int keys_count, const char **value, size_t *length);
+
+#ifdef  __cplusplus
+}
+#endif
+#endif                          /* _KUBE_CONFIG_JSON_H */
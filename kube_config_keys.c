@@ -0,0 +1,197 @@
+#include <string.h>
+#include "kube_config_keys.h"
+
+#define KEY_MATCH(key, literal, id) (0 == memcmp((key), (literal), sizeof(literal) - 1) ? (id) : KUBECONFIG_KEY_UNKNOWN)
+
+kubeconfig_key_t kubeconfig_key_lookup(const char *key, size_t length)
+{
+    /* Within each length the byte switched on is different for every key. */
+    switch (length) {
+    case 3:
+        return KEY_MATCH(key, KEY_USER_EXEC_ENV, KUBECONFIG_KEY_USER_EXEC_ENV);
+    case 4:
+        switch (key[0]) {
+        case 'a':
+            return KEY_MATCH(key, KEY_USER_EXEC_ARGS, KUBECONFIG_KEY_USER_EXEC_ARGS);
+        case 'e':
+            return KEY_MATCH(key, KEY_USER_EXEC, KUBECONFIG_KEY_USER_EXEC);
+        case 'k':
+            return KEY_MATCH(key, KEY_KIND, KUBECONFIG_KEY_KIND);
+        case 'n':
+            return KEY_MATCH(key, KEY_NAME, KUBECONFIG_KEY_NAME);
+        case 'u':
+            return KEY_MATCH(key, KEY_USER, KUBECONFIG_KEY_USER);
+        }
+        break;
+    case 5:
+        switch (key[0]) {
+        case 't':
+            return KEY_MATCH(key, KEY_TOKEN, KUBECONFIG_KEY_TOKEN);
+        case 'u':
+            return KEY_MATCH(key, KEY_USERS, KUBECONFIG_KEY_USERS);
+        case 'v':
+            return KEY_MATCH(key, KEY_USER_EXEC_ENV_VALUE, KUBECONFIG_KEY_USER_EXEC_ENV_VALUE);
+        }
+        break;
+    case 6:
+        switch (key[1]) {
+        case 'o':
+            return KEY_MATCH(key, KEY_USER_AUTH_PROVIDER_CONFIG, KUBECONFIG_KEY_USER_AUTH_PROVIDER_CONFIG);
+        case 'x':
+            return KEY_MATCH(key, KEY_USER_AUTH_PROVIDER_CONFIG_EXPIRY, KUBECONFIG_KEY_USER_AUTH_PROVIDER_CONFIG_EXPIRY);
+        case 'e':
+            return KEY_MATCH(key, KEY_SERVER, KUBECONFIG_KEY_SERVER);
+        case 't':
+            return KEY_MATCH(key, KEY_STAUTS, KUBECONFIG_KEY_STATUS);
+        }
+        break;
+    case 7:
+        switch (key[3]) {
+        case 's':
+            return KEY_MATCH(key, KEY_CLUSTER, KUBECONFIG_KEY_CLUSTER);
+        case 't':
+            return KEY_MATCH(key, KEY_CONTEXT, KUBECONFIG_KEY_CONTEXT);
+        case 'm':
+            return KEY_MATCH(key, KEY_USER_EXEC_COMMAND, KUBECONFIG_KEY_USER_EXEC_COMMAND);
+        }
+        break;
+    case 8:
+        switch (key[2]) {
+        case 'u':
+            return KEY_MATCH(key, KEY_CLUSTERS, KUBECONFIG_KEY_CLUSTERS);
+        case 'n':
+            return KEY_MATCH(key, KEY_CONTEXTS, KUBECONFIG_KEY_CONTEXTS);
+        case 'd':
+            return KEY_MATCH(key, KEY_USER_AUTH_PROVIDER_CONFIG_CMD_PATH, KUBECONFIG_KEY_USER_AUTH_PROVIDER_CONFIG_CMD_PATH);
+        case '-':
+            return KEY_MATCH(key, KEY_USER_AUTH_PROVIDER_CONFIG_ID_TOKEN, KUBECONFIG_KEY_USER_AUTH_PROVIDER_CONFIG_ID_TOKEN);
+        }
+        break;
+    case 9:
+        switch (key[0]) {
+        case 'n':
+            return KEY_MATCH(key, KEY_NAMESPACE, KUBECONFIG_KEY_NAMESPACE);
+        case 'c':
+            return KEY_MATCH(key, KEY_USER_AUTH_PROVIDER_CONFIG_CLIENT_ID, KUBECONFIG_KEY_USER_AUTH_PROVIDER_CONFIG_CLIENT_ID);
+        }
+        break;
+    case 10:
+        switch (key[0]) {
+        case 'a':
+            return KEY_MATCH(key, KEY_APIVERSION, KUBECONFIG_KEY_APIVERSION);
+        case 'e':
+            return KEY_MATCH(key, KEY_USER_AUTH_PROVIDER_CONFIG_EXPIRES_ON, KUBECONFIG_KEY_USER_AUTH_PROVIDER_CONFIG_EXPIRES_ON);
+        }
+        break;
+    case 11:
+        return KEY_MATCH(key, KEY_PREFERENCES, KUBECONFIG_KEY_PREFERENCES);
+    case 12:
+        return KEY_MATCH(key, KEY_USER_AUTH_PROVIDER_CONFIG_ACCESS_TOKEN, KUBECONFIG_KEY_USER_AUTH_PROVIDER_CONFIG_ACCESS_TOKEN);
+    case 13:
+        switch (key[6]) {
+        case 'r':
+            return KEY_MATCH(key, KEY_USER_AUTH_PROVIDER, KUBECONFIG_KEY_USER_AUTH_PROVIDER);
+        case '-':
+            return KEY_MATCH(key, KEY_USER_AUTH_PROVIDER_CONFIG_CLIENT_SECRET, KUBECONFIG_KEY_USER_AUTH_PROVIDER_CONFIG_CLIENT_SECRET);
+        case 'h':
+            return KEY_MATCH(key, KEY_USER_AUTH_PROVIDER_CONFIG_REFRESH_TOKEN, KUBECONFIG_KEY_USER_AUTH_PROVIDER_CONFIG_REFRESH_TOKEN);
+        case 'K':
+            return KEY_MATCH(key, KEY_CLIENT_KEY_DATA2, KUBECONFIG_KEY_CLIENT_KEY_DATA2);
+        }
+        break;
+    case 14:
+        return KEY_MATCH(key, KEY_USER_AUTH_PROVIDER_CONFIG_IDP_ISSUE_URL, KUBECONFIG_KEY_USER_AUTH_PROVIDER_CONFIG_IDP_ISSUER_URL);
+    case 15:
+        switch (key[1]) {
+        case 'u':
+            return KEY_MATCH(key, KEY_CURRENT_CONTEXT, KUBECONFIG_KEY_CURRENT_CONTEXT);
+        case 'l':
+            return KEY_MATCH(key, KEY_CLIENT_KEY_DATA, KUBECONFIG_KEY_CLIENT_KEY_DATA);
+        }
+        break;
+    case 21:
+        return KEY_MATCH(key, KEY_CLIENT_CERTIFICATE_DATA2, KUBECONFIG_KEY_CLIENT_CERTIFICATE_DATA2);
+    case 23:
+        return KEY_MATCH(key, KEY_CLIENT_CERTIFICATE_DATA, KUBECONFIG_KEY_CLIENT_CERTIFICATE_DATA);
+    case 26:
+        return KEY_MATCH(key, KEY_CERTIFICATE_AUTHORITY_DATA, KUBECONFIG_KEY_CERTIFICATE_AUTHORITY_DATA);
+    case 30:
+        return KEY_MATCH(key, KEY_USER_AUTH_PROVIDER_CONFIG_IDP_CERTIFICATE_AUTHORITY_DATA, KUBECONFIG_KEY_USER_AUTH_PROVIDER_CONFIG_IDP_CERTIFICATE_AUTHORITY_DATA);
+    }
+
+    return KUBECONFIG_KEY_UNKNOWN;
+}
+
+#define TOP_STRING(member) { KUBECONFIG_FIELD_STRING, offsetof(kubeconfig_t, member), 0, 0, 0, 0 }
+#define TOP_INTERNED_STRING(member) { KUBECONFIG_FIELD_STRING, offsetof(kubeconfig_t, member), 0, 0, 1, 0 }
+#define TOP_PROPERTIES(member, type) { KUBECONFIG_FIELD_PROPERTIES, offsetof(kubeconfig_t, member), offsetof(kubeconfig_t, member##_count), type, 0, 0 }
+#define PROPERTY_STRING(member) { KUBECONFIG_FIELD_STRING, offsetof(kubeconfig_property_t, member), 0, 0, 0, 0 }
+#define PROPERTY_INTERNED_STRING(member) { KUBECONFIG_FIELD_STRING, offsetof(kubeconfig_property_t, member), 0, 0, 1, 0 }
+#define PROPERTY_DATA_STRING(member) { KUBECONFIG_FIELD_STRING, offsetof(kubeconfig_property_t, member), 0, 0, 0, 1 }
+#define PROPERTY_SUB_PROPERTY(member, type) { KUBECONFIG_FIELD_SUB_PROPERTY, offsetof(kubeconfig_property_t, member), 0, type, 0, 0 }
+#define PROPERTY_STRINGS(member) { KUBECONFIG_FIELD_STRINGS, offsetof(kubeconfig_property_t, member), offsetof(kubeconfig_property_t, member##_count), 0, 0, 0 }
+#define PROPERTY_PAIRS(member) { KUBECONFIG_FIELD_PAIRS, offsetof(kubeconfig_property_t, member), offsetof(kubeconfig_property_t, member##_count), 0, 0, 0 }
+
+static const kubeconfig_field_t kubeconfig_no_field = { KUBECONFIG_FIELD_NONE, 0, 0, 0, 0, 0 };
+
+static const kubeconfig_field_t kubeconfig_top_fields[KUBECONFIG_KEY_COUNT] = {
+    [KUBECONFIG_KEY_APIVERSION] = TOP_STRING(apiVersion),
+    [KUBECONFIG_KEY_KIND] = TOP_STRING(kind),
+    [KUBECONFIG_KEY_CURRENT_CONTEXT] = TOP_INTERNED_STRING(current_context),
+    [KUBECONFIG_KEY_CLUSTERS] = TOP_PROPERTIES(clusters, KUBECONFIG_PROPERTY_TYPE_CLUSTER),
+    [KUBECONFIG_KEY_CONTEXTS] = TOP_PROPERTIES(contexts, KUBECONFIG_PROPERTY_TYPE_CONTEXT),
+    [KUBECONFIG_KEY_USERS] = TOP_PROPERTIES(users, KUBECONFIG_PROPERTY_TYPE_USER),
+};
+
+static const kubeconfig_field_t kubeconfig_property_fields[KUBECONFIG_PROPERTY_TYPE_USER_AUTH_PROVIDER + 1][KUBECONFIG_KEY_COUNT] = {
+    [KUBECONFIG_PROPERTY_TYPE_CONTEXT] = {
+        [KUBECONFIG_KEY_NAME] = PROPERTY_INTERNED_STRING(name),
+        [KUBECONFIG_KEY_CLUSTER] = PROPERTY_INTERNED_STRING(cluster),
+        [KUBECONFIG_KEY_NAMESPACE] = PROPERTY_INTERNED_STRING(namespace),
+        [KUBECONFIG_KEY_USER] = PROPERTY_INTERNED_STRING(user),
+    },
+    [KUBECONFIG_PROPERTY_TYPE_CLUSTER] = {
+        [KUBECONFIG_KEY_NAME] = PROPERTY_INTERNED_STRING(name),
+        [KUBECONFIG_KEY_CERTIFICATE_AUTHORITY_DATA] = PROPERTY_DATA_STRING(certificate_authority_data),
+        [KUBECONFIG_KEY_SERVER] = PROPERTY_STRING(server),
+    },
+    [KUBECONFIG_PROPERTY_TYPE_USER] = {
+        [KUBECONFIG_KEY_NAME] = PROPERTY_INTERNED_STRING(name),
+        [KUBECONFIG_KEY_CLIENT_CERTIFICATE_DATA] = PROPERTY_DATA_STRING(client_certificate_data),
+        [KUBECONFIG_KEY_CLIENT_KEY_DATA] = PROPERTY_DATA_STRING(client_key_data),
+        [KUBECONFIG_KEY_USER_EXEC] = PROPERTY_SUB_PROPERTY(exec, KUBECONFIG_PROPERTY_TYPE_USER_EXEC),
+        [KUBECONFIG_KEY_USER_AUTH_PROVIDER] = PROPERTY_SUB_PROPERTY(auth_provider, KUBECONFIG_PROPERTY_TYPE_USER_AUTH_PROVIDER),
+    },
+    [KUBECONFIG_PROPERTY_TYPE_USER_EXEC] = {
+        [KUBECONFIG_KEY_NAME] = PROPERTY_STRING(name),
+        [KUBECONFIG_KEY_APIVERSION] = PROPERTY_INTERNED_STRING(apiVersion),
+        [KUBECONFIG_KEY_USER_EXEC_COMMAND] = PROPERTY_INTERNED_STRING(command),
+        [KUBECONFIG_KEY_USER_EXEC_ENV] = PROPERTY_PAIRS(envs),
+        [KUBECONFIG_KEY_USER_EXEC_ARGS] = PROPERTY_STRINGS(args),
+    },
+    [KUBECONFIG_PROPERTY_TYPE_USER_AUTH_PROVIDER] = {
+        [KUBECONFIG_KEY_NAME] = PROPERTY_INTERNED_STRING(name),
+        [KUBECONFIG_KEY_USER_AUTH_PROVIDER_CONFIG_CLIENT_ID] = PROPERTY_STRING(client_id),
+        [KUBECONFIG_KEY_USER_AUTH_PROVIDER_CONFIG_CLIENT_SECRET] = PROPERTY_STRING(client_secret),
+        [KUBECONFIG_KEY_USER_AUTH_PROVIDER_CONFIG_ID_TOKEN] = PROPERTY_STRING(id_token),
+        [KUBECONFIG_KEY_USER_AUTH_PROVIDER_CONFIG_IDP_CERTIFICATE_AUTHORITY_DATA] = PROPERTY_STRING(idp_certificate_authority_data),
+        [KUBECONFIG_KEY_USER_AUTH_PROVIDER_CONFIG_IDP_ISSUER_URL] = PROPERTY_STRING(idp_issuer_url),
+        [KUBECONFIG_KEY_USER_AUTH_PROVIDER_CONFIG_REFRESH_TOKEN] = PROPERTY_STRING(refresh_token),
+    },
+};
+
+const kubeconfig_field_t *kubeconfig_top_field_lookup(kubeconfig_key_t key)
+{
+    if (key <= KUBECONFIG_KEY_UNKNOWN || key >= KUBECONFIG_KEY_COUNT) {
+        return &kubeconfig_no_field;
+    }
+    return &kubeconfig_top_fields[key];
+}
+
+const kubeconfig_field_t *kubeconfig_property_field_lookup(kubeconfig_property_type_t type, kubeconfig_key_t key)
+{
+    if (type < KUBECONFIG_PROPERTY_TYPE_CONTEXT || type > KUBECONFIG_PROPERTY_TYPE_USER_AUTH_PROVIDER || key <= KUBECONFIG_KEY_UNKNOWN || key >= KUBECONFIG_KEY_COUNT) {
+        return &kubeconfig_no_field;
+    }
+    return &kubeconfig_property_fields[type][key];
+}
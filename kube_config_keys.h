@@ -0,0 +1,136 @@
+#ifndef _KUBE_CONFIG_KEYS_H
+#define _KUBE_CONFIG_KEYS_H
+
+#include <stddef.h>
+#include "kube_config_model.h"
+
+#ifdef  __cplusplus
+extern "C" {
+#endif
+
+/* Keys of the kubeconfig and exec credential documents. */
+
+#define KEY_APIVERSION "apiVersion"
+#define KEY_KIND "kind"
+#define KEY_CURRENT_CONTEXT "current-context"
+#define KEY_PREFERENCES "preferences"
+#define KEY_CLUSTERS "clusters"
+#define KEY_CLUSTER "cluster"
+#define KEY_CONTEXTS "contexts"
+#define KEY_CONTEXT "context"
+#define KEY_NAMESPACE "namespace"
+#define KEY_USERS "users"
+#define KEY_USER "user"
+#define KEY_NAME "name"
+#define KEY_USER_EXEC "exec"
+#define KEY_USER_EXEC_COMMAND "command"
+#define KEY_USER_EXEC_ENV "env"
+#define KEY_USER_EXEC_ENV_KEY "name"
+#define KEY_USER_EXEC_ENV_VALUE "value"
+#define KEY_USER_EXEC_ARGS "args"
+#define KEY_USER_AUTH_PROVIDER "auth-provider"
+#define KEY_USER_AUTH_PROVIDER_CONFIG "config"
+#define KEY_USER_AUTH_PROVIDER_CONFIG_ACCESS_TOKEN "access-token"
+#define KEY_USER_AUTH_PROVIDER_CONFIG_CLIENT_ID "client-id"
+#define KEY_USER_AUTH_PROVIDER_CONFIG_CLIENT_SECRET "client-secret"
+#define KEY_USER_AUTH_PROVIDER_CONFIG_CMD_PATH "cmd-path"
+#define KEY_USER_AUTH_PROVIDER_CONFIG_EXPIRES_ON "expires-on"
+#define KEY_USER_AUTH_PROVIDER_CONFIG_EXPIRY "expiry"
+#define KEY_USER_AUTH_PROVIDER_CONFIG_ID_TOKEN "id-token"
+#define KEY_USER_AUTH_PROVIDER_CONFIG_IDP_CERTIFICATE_AUTHORITY_DATA "idp-certificate-authority-data"
+#define KEY_USER_AUTH_PROVIDER_CONFIG_IDP_ISSUE_URL "idp-issuer-url"
+#define KEY_USER_AUTH_PROVIDER_CONFIG_REFRESH_TOKEN "refresh-token"
+#define KEY_CERTIFICATE_AUTHORITY_DATA "certificate-authority-data"
+#define KEY_SERVER "server"
+#define KEY_CLIENT_CERTIFICATE_DATA "client-certificate-data"
+#define KEY_CLIENT_KEY_DATA "client-key-data"
+#define KEY_STAUTS "status"
+#define KEY_TOKEN "token"
+#define KEY_CLIENT_CERTIFICATE_DATA2 "clientCertificateData"
+#define KEY_CLIENT_KEY_DATA2 "clientKeyData"
+
+/*
+ * Every key above has an id, kubeconfig_key_lookup() resolves a key to its id
+ * with a switch on the length and one distinguishing byte followed by a
+ * single memcmp(), instead of comparing the key against each name in turn.
+ */
+    typedef enum kubeconfig_key_t {
+        KUBECONFIG_KEY_UNKNOWN = 0,
+        KUBECONFIG_KEY_APIVERSION,
+        KUBECONFIG_KEY_KIND,
+        KUBECONFIG_KEY_CURRENT_CONTEXT,
+        KUBECONFIG_KEY_PREFERENCES,
+        KUBECONFIG_KEY_CLUSTERS,
+        KUBECONFIG_KEY_CLUSTER,
+        KUBECONFIG_KEY_CONTEXTS,
+        KUBECONFIG_KEY_CONTEXT,
+        KUBECONFIG_KEY_NAMESPACE,
+        KUBECONFIG_KEY_USERS,
+        KUBECONFIG_KEY_USER,
+        KUBECONFIG_KEY_NAME,
+        KUBECONFIG_KEY_USER_EXEC,
+        KUBECONFIG_KEY_USER_EXEC_COMMAND,
+        KUBECONFIG_KEY_USER_EXEC_ENV,
+        KUBECONFIG_KEY_USER_EXEC_ENV_VALUE,
+        KUBECONFIG_KEY_USER_EXEC_ARGS,
+        KUBECONFIG_KEY_USER_AUTH_PROVIDER,
+        KUBECONFIG_KEY_USER_AUTH_PROVIDER_CONFIG,
+        KUBECONFIG_KEY_USER_AUTH_PROVIDER_CONFIG_ACCESS_TOKEN,
+        KUBECONFIG_KEY_USER_AUTH_PROVIDER_CONFIG_CLIENT_ID,
+        KUBECONFIG_KEY_USER_AUTH_PROVIDER_CONFIG_CLIENT_SECRET,
+        KUBECONFIG_KEY_USER_AUTH_PROVIDER_CONFIG_CMD_PATH,
+        KUBECONFIG_KEY_USER_AUTH_PROVIDER_CONFIG_EXPIRES_ON,
+        KUBECONFIG_KEY_USER_AUTH_PROVIDER_CONFIG_EXPIRY,
+        KUBECONFIG_KEY_USER_AUTH_PROVIDER_CONFIG_ID_TOKEN,
+        KUBECONFIG_KEY_USER_AUTH_PROVIDER_CONFIG_IDP_CERTIFICATE_AUTHORITY_DATA,
+        KUBECONFIG_KEY_USER_AUTH_PROVIDER_CONFIG_IDP_ISSUER_URL,
+        KUBECONFIG_KEY_USER_AUTH_PROVIDER_CONFIG_REFRESH_TOKEN,
+        KUBECONFIG_KEY_CERTIFICATE_AUTHORITY_DATA,
+        KUBECONFIG_KEY_SERVER,
+        KUBECONFIG_KEY_CLIENT_CERTIFICATE_DATA,
+        KUBECONFIG_KEY_CLIENT_KEY_DATA,
+        KUBECONFIG_KEY_STATUS,
+        KUBECONFIG_KEY_TOKEN,
+        KUBECONFIG_KEY_CLIENT_CERTIFICATE_DATA2,
+        KUBECONFIG_KEY_CLIENT_KEY_DATA2,
+        KUBECONFIG_KEY_COUNT,
+        KUBECONFIG_KEY_USER_EXEC_ENV_KEY = KUBECONFIG_KEY_NAME
+    } kubeconfig_key_t;
+
+    kubeconfig_key_t kubeconfig_key_lookup(const char *key, size_t length);
+
+/*
+ * A field descriptor tells where the value of a key is stored, so a key id
+ * resolves to its member in one table lookup.
+ */
+    typedef enum kubeconfig_field_kind_t {
+        KUBECONFIG_FIELD_NONE = 0,      /* the key is not stored */
+        KUBECONFIG_FIELD_STRING,        /* char * member */
+        KUBECONFIG_FIELD_SUB_PROPERTY,  /* kubeconfig_property_t * member (user exec, auth provider) */
+        KUBECONFIG_FIELD_STRINGS,       /* char ** member with an item count (exec args) */
+        KUBECONFIG_FIELD_PAIRS, /* keyValuePair_t ** member with an item count (exec env) */
+        KUBECONFIG_FIELD_PROPERTIES,    /* kubeconfig_property_t ** member with an item count (clusters, contexts, users) */
+        KUBECONFIG_FIELD_SKIPPED        /* the projection of the load skips the value, see kube_config_projection.h */
+    } kubeconfig_field_kind_t;
+
+    typedef struct kubeconfig_field_t {
+        kubeconfig_field_kind_t kind;
+        size_t offset;          /* offset of the member holding the value */
+        size_t count_offset;    /* offset of the int item count of STRINGS, PAIRS and PROPERTIES */
+        kubeconfig_property_type_t property_type;       /* type of SUB_PROPERTY and PROPERTIES */
+        int interned;           /* a STRING that is interned by KUBEYAML_LOAD_INTERN: names and values repeated across entries */
+        int data;               /* a STRING of base64 that KUBEYAML_LOAD_DECODE_DATA replaces with a kubeconfig_data_t */
+    } kubeconfig_field_t;
+
+#define KUBECONFIG_FIELD_MEMBER(object, offset, type) ((type *) ((char *) (object) + (offset)))
+
+/* Field of a key in the top mapping of a kubeconfig_t. Never NULL. */
+    const kubeconfig_field_t *kubeconfig_top_field_lookup(kubeconfig_key_t key);
+
+/* Field of a key in a kubeconfig_property_t of the given type. Never NULL. */
+    const kubeconfig_field_t *kubeconfig_property_field_lookup(kubeconfig_property_type_t type, kubeconfig_key_t key);
+
+#ifdef  __cplusplus
+}
+#endif
+#endif                          /* _KUBE_CONFIG_KEYS_H */
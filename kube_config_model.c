@@ -1,20 +1,92 @@
 #include "kube_config_model.h"
+#include "kube_config_alloc.h"
+#include <stdint.h>
 #include <stdlib.h>
+#include <sys/mman.h>
 
-void kubeconfig_free_string_list(char **string_list, int count)
+void kubeconfig_string_free(const kubeconfig_t * kubeconfig, char *string)
+{
+    if (kubeconfig && kubeconfig->buffer) {
+        uintptr_t address = (uintptr_t) string;
+        uintptr_t buffer = (uintptr_t) kubeconfig->buffer;
+        if (address >= buffer && address - buffer < kubeconfig->buffer_size) {
+            return;             /* a view into the retained input buffer */
+        }
+    }
+    if (kubeconfig && kubeconfig_strings_owns(kubeconfig->strings, string)) {
+        return;                 /* shared by the kubeconfig, freed with its table */
+    }
+    kubeconfig_memory_release(kubeconfig, string);
+}
+
+void kubeconfig_memory_release(const kubeconfig_t * kubeconfig, void *ptr)
+{
+    if (kubeconfig && kubeconfig_arena_owns(kubeconfig->arena, ptr)) {
+        return;                 /* freed with the arena */
+    }
+    kubeyaml_free(ptr);
+}
+
+void *kubeconfig_alloc(kubeconfig_t * kubeconfig, size_t size)
+{
+    if (kubeconfig && kubeconfig->arena) {
+        return kubeconfig_arena_alloc(kubeconfig->arena, size);
+    }
+    return kubeyaml_calloc(1, size);
+}
+
+void *kubeconfig_realloc(kubeconfig_t * kubeconfig, void *ptr, size_t old_size, size_t size)
+{
+    if (kubeconfig && kubeconfig->arena) {
+        return kubeconfig_arena_realloc(kubeconfig->arena, ptr, old_size, size);
+    }
+    return kubeyaml_realloc(ptr, size);
+}
+
+char *kubeconfig_strndup(kubeconfig_t * kubeconfig, const char *string, size_t length)
+{
+    if (kubeconfig && kubeconfig->arena) {
+        return kubeconfig_arena_strndup(kubeconfig->arena, string, length);
+    }
+    return kubeyaml_strndup(string, length);
+}
+
+char *kubeconfig_intern(kubeconfig_t * kubeconfig, const char *string, size_t length)
+{
+    if (kubeconfig && kubeconfig->strings) {
+        return kubeconfig_strings_intern(kubeconfig->strings, string, length);
+    }
+    return kubeconfig_strndup(kubeconfig, string, length);
+}
+
+kubeconfig_property_t *kubeconfig_property_alloc(kubeconfig_t * kubeconfig, kubeconfig_property_type_t type)
+{
+    kubeconfig_property_t *property = kubeconfig_alloc(kubeconfig, sizeof(kubeconfig_property_t));
+    if (property) {
+        property->type = type;
+    }
+    return property;
+}
+
+void kubeconfig_string_list_release(const kubeconfig_t * kubeconfig, char **string_list, int count)
 {
     if (string_list && count > 0) {
         for (int i = 0; i < count; i++) {
             if (string_list[i]) {
-                free(string_list[i]);
+                kubeconfig_string_free(kubeconfig, string_list[i]);
                 string_list[i] = NULL;
             }
         }
-        free(string_list);
+        kubeconfig_memory_release(kubeconfig, string_list);
     }
 }
 
-void kubeconfig_free_string_map_list(keyValuePair_t ** map_list, int count)
+void kubeconfig_free_string_list(char **string_list, int count)
+{
+    kubeconfig_string_list_release(NULL, string_list, count);
+}
+
+void kubeconfig_string_map_list_release(const kubeconfig_t * kubeconfig, keyValuePair_t ** map_list, int count)
 {
     if (map_list && count > 0) {
         keyValuePair_t *pair = NULL;
@@ -22,108 +94,113 @@ void kubeconfig_free_string_map_list(keyValuePair_t ** map_list, int count)
             pair = map_list[i];
             if (pair) {
                 if (pair->key) {
-                    free(pair->key);
+                    kubeconfig_string_free(kubeconfig, pair->key);
                     pair->key = NULL;
                 }
                 if (pair->value) {
-                    free(pair->value);
+                    kubeconfig_string_free(kubeconfig, pair->value);
                     pair->value = NULL;
                 }
-                free(pair);
+                kubeconfig_memory_release(kubeconfig, pair);
                 pair = NULL;
             }
         }
-        free(map_list);
+        kubeconfig_memory_release(kubeconfig, map_list);
     }
 }
 
+void kubeconfig_free_string_map_list(keyValuePair_t ** map_list, int count)
+{
+    kubeconfig_string_map_list_release(NULL, map_list, count);
+}
+
 kubeconfig_property_t *kubeconfig_property_create(kubeconfig_property_type_t type)
 {
-    kubeconfig_property_t *property = calloc(1, sizeof(kubeconfig_property_t));
+    kubeconfig_property_t *property = kubeyaml_calloc(1, sizeof(kubeconfig_property_t));
     property->type = type;
     return property;
 }
 
-void kubeconfig_property_free(kubeconfig_property_t * property)
+void kubeconfig_property_release(const kubeconfig_t * kubeconfig, kubeconfig_property_t * property)
 {
     if (!property) {
         return;
     }
 
     if (property->name) {
-        free(property->name);
+        kubeconfig_string_free(kubeconfig, property->name);
         property->name = NULL;
     }
 
     if (KUBECONFIG_PROPERTY_TYPE_CLUSTER == property->type) {
         if (property->server) {
-            free(property->server);
+            kubeconfig_string_free(kubeconfig, property->server);
             property->server = NULL;
         }
         if (property->certificate_authority_data) {
-            free(property->certificate_authority_data);
+            kubeconfig_string_free(kubeconfig, property->certificate_authority_data);
             property->certificate_authority_data = NULL;
         }
     }
 
     if (KUBECONFIG_PROPERTY_TYPE_USER == property->type) {
         if (property->client_certificate_data) {
-            free(property->client_certificate_data);
+            kubeconfig_string_free(kubeconfig, property->client_certificate_data);
             property->client_certificate_data = NULL;
         }
         if (property->client_key_data) {
-            free(property->client_key_data);
+            kubeconfig_string_free(kubeconfig, property->client_key_data);
             property->client_key_data = NULL;
         }
         if (property->username) {
-            free(property->username);
+            kubeconfig_string_free(kubeconfig, property->username);
             property->username = NULL;
         }
         if (property->password) {
-            free(property->password);
+            kubeconfig_string_free(kubeconfig, property->password);
             property->password = NULL;
         }
         if (property->auth_provider) {
-            kubeconfig_property_free(property->auth_provider);
+            kubeconfig_property_release(kubeconfig, property->auth_provider);
             property->auth_provider = NULL;
         }
         if (property->exec) {
-            kubeconfig_property_free(property->exec);
+            kubeconfig_property_release(kubeconfig, property->exec);
             property->exec = NULL;
         }
     }
 
     if (KUBECONFIG_PROPERTY_TYPE_CONTEXT == property->type) {
         if (property->cluster) {
-            free(property->cluster);
+            kubeconfig_string_free(kubeconfig, property->cluster);
             property->cluster = NULL;
         }
         if (property->namespace) {
-            free(property->namespace);
+            kubeconfig_string_free(kubeconfig, property->namespace);
             property->namespace = NULL;
         }
         if (property->user) {
-            free(property->user);
+            kubeconfig_string_free(kubeconfig, property->user);
             property->user = NULL;
         }
     }
 
     if (KUBECONFIG_PROPERTY_TYPE_USER_EXEC == property->type) {
         if (property->command) {
-            free(property->command);
+            kubeconfig_string_free(kubeconfig, property->command);
             property->command = NULL;
         }
         if (property->apiVersion) {
-            free(property->apiVersion);
+            kubeconfig_string_free(kubeconfig, property->apiVersion);
             property->apiVersion = NULL;
         }
         if (property->envs && property->envs_count > 0) {
-            kubeconfig_free_string_map_list(property->envs, property->envs_count);
+            kubeconfig_string_map_list_release(kubeconfig, property->envs, property->envs_count);
             property->envs = NULL;
             property->envs_count = 0;
         }
         if (property->args && property->args_count > 0) {
-            kubeconfig_free_string_list(property->args, property->args_count);
+            kubeconfig_string_list_release(kubeconfig, property->args, property->args_count);
             property->args = NULL;
             property->args_count = 0;
         }
@@ -131,53 +208,58 @@ void kubeconfig_property_free(kubeconfig_property_t * property)
 
     if (KUBECONFIG_PROPERTY_TYPE_USER_AUTH_PROVIDER == property->type) {
         if (property->id_token) {
-            free(property->id_token);
+            kubeconfig_string_free(kubeconfig, property->id_token);
             property->id_token = NULL;
         }
         if (property->cmd_path) {
-            free(property->cmd_path);
+            kubeconfig_string_free(kubeconfig, property->cmd_path);
             property->cmd_path = NULL;
         }
         if (property->access_token) {
-            free(property->access_token);
+            kubeconfig_string_free(kubeconfig, property->access_token);
             property->access_token = NULL;
         }
         if (property->expires_on) {
-            free(property->expires_on);
+            kubeconfig_string_free(kubeconfig, property->expires_on);
             property->expires_on = NULL;
         }
         if (property->expiry) {
-            free(property->expiry);
+            kubeconfig_string_free(kubeconfig, property->expiry);
             property->expiry = NULL;
         }
         if (property->idp_certificate_authority_data) {
-            free(property->idp_certificate_authority_data);
+            kubeconfig_string_free(kubeconfig, property->idp_certificate_authority_data);
             property->idp_certificate_authority_data = NULL;
         }
         if (property->client_id) {
-            free(property->client_id);
+            kubeconfig_string_free(kubeconfig, property->client_id);
             property->client_id = NULL;
         }
         if (property->client_secret) {
-            free(property->client_secret);
+            kubeconfig_string_free(kubeconfig, property->client_secret);
             property->client_secret = NULL;
         }
         if (property->idp_issuer_url) {
-            free(property->idp_issuer_url);
+            kubeconfig_string_free(kubeconfig, property->idp_issuer_url);
             property->idp_issuer_url = NULL;
         }
         if (property->refresh_token) {
-            free(property->refresh_token);
+            kubeconfig_string_free(kubeconfig, property->refresh_token);
             property->refresh_token = NULL;
         }
     }
 
-    free(property);
+    kubeconfig_memory_release(kubeconfig, property);
+}
+
+void kubeconfig_property_free(kubeconfig_property_t * property)
+{
+    kubeconfig_property_release(NULL, property);
 }
 
 kubeconfig_property_t **kubeconfig_properties_create(int contexts_count, kubeconfig_property_type_t type)
 {
-    kubeconfig_property_t **properties = (kubeconfig_property_t **) calloc(contexts_count, sizeof(kubeconfig_property_t *));
+    kubeconfig_property_t **properties = (kubeconfig_property_t **) kubeyaml_calloc(contexts_count, sizeof(kubeconfig_property_t *));
     int i = 0;
     for (i = 0; i < contexts_count; i++) {
         properties[i] = kubeconfig_property_create(type);
@@ -185,7 +267,25 @@ kubeconfig_property_t **kubeconfig_properties_create(int contexts_count, kubecon
     return properties;
 }
 
-void kubeconfig_properties_free(kubeconfig_property_t ** properties, int properties_count)
+kubeconfig_property_t **kubeconfig_properties_alloc(kubeconfig_t * kubeconfig, int properties_count, kubeconfig_property_type_t type)
+{
+    kubeconfig_property_t **properties = kubeconfig_alloc(kubeconfig, properties_count * sizeof(kubeconfig_property_t *));
+    int i = 0;
+
+    if (!properties) {
+        return NULL;
+    }
+    for (i = 0; i < properties_count; i++) {
+        properties[i] = kubeconfig_property_alloc(kubeconfig, type);
+        if (!properties[i]) {
+            kubeconfig_properties_release(kubeconfig, properties, i);
+            return NULL;
+        }
+    }
+    return properties;
+}
+
+void kubeconfig_properties_release(const kubeconfig_t * kubeconfig, kubeconfig_property_t ** properties, int properties_count)
 {
     if (!properties) {
         return;
@@ -193,16 +293,21 @@ void kubeconfig_properties_free(kubeconfig_property_t ** properties, int propert
 
     for (int i = 0; i < properties_count; i++) {
         if (properties[i]) {
-            kubeconfig_property_free(properties[i]);
+            kubeconfig_property_release(kubeconfig, properties[i]);
             properties[i] = NULL;
         }
     }
-    free(properties);
+    kubeconfig_memory_release(kubeconfig, properties);
+}
+
+void kubeconfig_properties_free(kubeconfig_property_t ** properties, int properties_count)
+{
+    kubeconfig_properties_release(NULL, properties, properties_count);
 }
 
 kubeconfig_t *kubeconfig_create()
 {
-    kubeconfig_t *config = calloc(1, sizeof(kubeconfig_t));
+    kubeconfig_t *config = kubeyaml_calloc(1, sizeof(kubeconfig_t));
     return config;
 }
 
@@ -213,44 +318,75 @@ void kubeconfig_free(kubeconfig_t * kubeconfig)
     }
 
     if (kubeconfig->fileName) {
-        free(kubeconfig->fileName);
+        kubeyaml_free(kubeconfig->fileName);
         kubeconfig->fileName = NULL;
     }
+    if (kubeconfig->arena) {
+        /* The entries are all in the arena, there is nothing to walk. */
+        kubeconfig_arena_free(kubeconfig->arena);
+        kubeconfig->arena = NULL;
+        kubeconfig->apiVersion = kubeconfig->kind = kubeconfig->preferences = kubeconfig->current_context = NULL;
+        kubeconfig->clusters = kubeconfig->users = kubeconfig->contexts = NULL;
+    }
     if (kubeconfig->apiVersion) {
-        free(kubeconfig->apiVersion);
+        kubeconfig_string_free(kubeconfig, kubeconfig->apiVersion);
         kubeconfig->apiVersion = NULL;
     }
     if (kubeconfig->kind) {
-        free(kubeconfig->kind);
+        kubeconfig_string_free(kubeconfig, kubeconfig->kind);
         kubeconfig->kind = NULL;
     }
     if (kubeconfig->preferences) {
-        free(kubeconfig->preferences);
+        kubeconfig_string_free(kubeconfig, kubeconfig->preferences);
         kubeconfig->preferences = NULL;
     }
     if (kubeconfig->current_context) {
-        free(kubeconfig->current_context);
+        kubeconfig_string_free(kubeconfig, kubeconfig->current_context);
         kubeconfig->current_context = NULL;
     }
     if (kubeconfig->clusters) {
-        kubeconfig_properties_free(kubeconfig->clusters, kubeconfig->clusters_count);
+        kubeconfig_properties_release(kubeconfig, kubeconfig->clusters, kubeconfig->clusters_count);
         kubeconfig->clusters = NULL;
     }
     if (kubeconfig->users) {
-        kubeconfig_properties_free(kubeconfig->users, kubeconfig->users_count);
+        kubeconfig_properties_release(kubeconfig, kubeconfig->users, kubeconfig->users_count);
         kubeconfig->users = NULL;
     }
     if (kubeconfig->contexts) {
-        kubeconfig_properties_free(kubeconfig->contexts, kubeconfig->contexts_count);
+        kubeconfig_properties_release(kubeconfig, kubeconfig->contexts, kubeconfig->contexts_count);
         kubeconfig->contexts = NULL;
     }
+    if (kubeconfig->strings) {
+        kubeconfig_strings_release(kubeconfig->strings);
+        kubeconfig->strings = NULL;
+    }
+    if (kubeconfig->buffer) {
+        if (KUBECONFIG_BUFFER_HEAP == kubeconfig->buffer_type) {
+            kubeyaml_free(kubeconfig->buffer);
+        } else if (KUBECONFIG_BUFFER_MAPPED == kubeconfig->buffer_type) {
+            munmap(kubeconfig->buffer, kubeconfig->buffer_size);
+        }
+        kubeconfig->buffer = NULL;
+    }
 
-    free(kubeconfig);
+    kubeyaml_free(kubeconfig);
+}
+
+void kubeconfig_list_free(kubeconfig_t ** kubeconfigs, int count)
+{
+    if (!kubeconfigs) {
+        return;
+    }
+
+    for (int i = 0; i < count; i++) {
+        kubeconfig_free(kubeconfigs[i]);
+    }
+    kubeyaml_free(kubeconfigs);
 }
 
 ExecCredential_status_t *exec_credential_status_create()
 {
-    ExecCredential_status_t *exec_credential_status = calloc(1, sizeof(ExecCredential_status_t));
+    ExecCredential_status_t *exec_credential_status = kubeyaml_calloc(1, sizeof(ExecCredential_status_t));
     return exec_credential_status;
 }
 
@@ -261,24 +397,24 @@ void exec_credential_status_free(ExecCredential_status_t * exec_credential_statu
     }
 
     if (exec_credential_status->token) {
-        free(exec_credential_status->token);
+        kubeyaml_free(exec_credential_status->token);
         exec_credential_status->token = NULL;
     }
     if (exec_credential_status->clientCertificateData) {
-        free(exec_credential_status->clientCertificateData);
+        kubeyaml_free(exec_credential_status->clientCertificateData);
         exec_credential_status->clientCertificateData = NULL;
     }
     if (exec_credential_status->clientKeyData) {
-        free(exec_credential_status->clientKeyData);
+        kubeyaml_free(exec_credential_status->clientKeyData);
         exec_credential_status->clientKeyData = NULL;
     }
 
-    free(exec_credential_status);
+    kubeyaml_free(exec_credential_status);
 }
 
 ExecCredential_t *exec_credential_create()
 {
-    ExecCredential_t *exec_credential = calloc(1, sizeof(ExecCredential_t));
+    ExecCredential_t *exec_credential = kubeyaml_calloc(1, sizeof(ExecCredential_t));
     return exec_credential;
 }
 
@@ -289,11 +425,11 @@ void exec_credential_free(ExecCredential_t * exec_credential)
     }
 
     if (exec_credential->apiVersion) {
-        free(exec_credential->apiVersion);
+        kubeyaml_free(exec_credential->apiVersion);
         exec_credential->apiVersion = NULL;
     }
     if (exec_credential->kind) {
-        free(exec_credential->kind);
+        kubeyaml_free(exec_credential->kind);
         exec_credential->kind = NULL;
     }
     if (exec_credential->status) {
@@ -301,5 +437,5 @@ void exec_credential_free(ExecCredential_t * exec_credential)
         exec_credential->status = NULL;
     }
 
-    free(exec_credential);
+    kubeyaml_free(exec_credential);
 }
@@ -1,7 +1,11 @@
 #ifndef _KUBE_CONFIG_MODEL_H
 #define _KUBE_CONFIG_MODEL_H
 
+#include <stddef.h>
 #include "keyValuePair.h"
+#include "kube_config_alloc.h"
+#include "kube_config_arena.h"
+#include "kube_config_intern.h"
 
 #ifdef  __cplusplus
 extern "C" {
@@ -39,6 +43,16 @@ extern "C" {
         KUBECONFIG_PROPERTY_TYPE_USER_AUTH_PROVIDER
     } kubeconfig_property_type_t;
 
+/*
+ * The bytes of a *-data field of a kubeconfig loaded with
+ * KUBEYAML_LOAD_DECODE_DATA, followed by a NUL that length does not count.
+ * It is one allocation, freed like the string it replaces.
+ */
+    typedef struct kubeconfig_data_t {
+        size_t length;
+        unsigned char data[];
+    } kubeconfig_data_t;
+
     typedef struct kubeconfig_property_t {
         kubeconfig_property_type_t type;
         char *name;
@@ -50,12 +64,21 @@ extern "C" {
             };
             struct {            /* cluster */
                 char *server;
-                char *certificate_authority_data;
+                union {
+                    char *certificate_authority_data;
+                    kubeconfig_data_t *certificate_authority_data_decoded;      /* if kubeconfig->data_decoded */
+                };
             };
             struct {            /* user */
                 char *token;
-                char *client_certificate_data;
-                char *client_key_data;
+                union {
+                    char *client_certificate_data;
+                    kubeconfig_data_t *client_certificate_data_decoded; /* if kubeconfig->data_decoded */
+                };
+                union {
+                    char *client_key_data;
+                    kubeconfig_data_t *client_key_data_decoded; /* if kubeconfig->data_decoded */
+                };
                 struct kubeconfig_property_t *auth_provider;
                 struct kubeconfig_property_t *exec;
                 int insecure_skip_tls_verify;
@@ -85,6 +108,13 @@ extern "C" {
         };
     } kubeconfig_property_t;
 
+    typedef enum kubeconfig_buffer_type_t {
+        KUBECONFIG_BUFFER_NONE = 0,
+        KUBECONFIG_BUFFER_BORROWED,     /* owned by the caller, it must outlive the kubeconfig */
+        KUBECONFIG_BUFFER_HEAP, /* freed with the kubeconfig */
+        KUBECONFIG_BUFFER_MAPPED        /* unmapped with the kubeconfig */
+    } kubeconfig_buffer_type_t;
+
     typedef struct kubeconfig_t {
         char *fileName;
         char *apiVersion;
@@ -97,6 +127,12 @@ extern "C" {
         int clusters_count;
         kubeconfig_property_t **users;
         int users_count;
+        char *buffer;           /* input kept by KUBEYAML_LOAD_ZERO_COPY, strings may point into it */
+        size_t buffer_size;
+        kubeconfig_buffer_type_t buffer_type;
+        kubeconfig_arena_t *arena;      /* set by KUBEYAML_LOAD_ARENA, the strings, properties and arrays are allocated from it */
+        kubeconfig_strings_t *strings;  /* set by KUBEYAML_LOAD_INTERN, the names are interned in it */
+        int data_decoded;       /* set by KUBEYAML_LOAD_DECODE_DATA, the *-data fields hold a kubeconfig_data_t */
     } kubeconfig_t;
 
     ExecCredential_t *exec_credential_create();
@@ -105,6 +141,9 @@ extern "C" {
     ExecCredential_status_t *exec_credential_status_create();
     void exec_credential_status_free(ExecCredential_status_t *);
 
+    void kubeconfig_free_string_list(char **string_list, int count);
+    void kubeconfig_free_string_map_list(keyValuePair_t ** map_list, int count);
+
     kubeconfig_property_t *kubeconfig_property_create(kubeconfig_property_type_t type);
     void kubeconfig_property_free(kubeconfig_property_t * property);
 
@@ -113,6 +152,41 @@ extern "C" {
 
     kubeconfig_t *kubeconfig_create();
     void kubeconfig_free(kubeconfig_t * kubeconfig);
+    void kubeconfig_list_free(kubeconfig_t ** kubeconfigs, int count);
+
+/*
+ * The release functions free like the ones above, but leave alone the
+ * strings of kubeconfig that are views into its retained buffer or
+ * interned in its table of strings.
+ * kubeconfig may be NULL when there is no such buffer.
+ */
+    void kubeconfig_string_free(const kubeconfig_t * kubeconfig, char *string);
+    void kubeconfig_string_list_release(const kubeconfig_t * kubeconfig, char **string_list, int count);
+    void kubeconfig_string_map_list_release(const kubeconfig_t * kubeconfig, keyValuePair_t ** map_list, int count);
+    void kubeconfig_property_release(const kubeconfig_t * kubeconfig, kubeconfig_property_t * property);
+    void kubeconfig_properties_release(const kubeconfig_t * kubeconfig, kubeconfig_property_t ** properties, int properties_count);
+
+/*
+ * Allocate the strings, properties and arrays of kubeconfig from its arena,
+ * or with kubeyaml_malloc() when it has none or kubeconfig is NULL. Like calloc(),
+ * kubeconfig_alloc() and kubeconfig_property_alloc() set the memory to
+ * zero. kubeconfig_memory_release() frees what kubeconfig_alloc() and
+ * kubeconfig_realloc() return, memory of the arena is only freed with the
+ * arena.
+ *
+ * kubeconfig_free() frees a kubeconfig with an arena at once, without
+ * walking its entries: a string or property set in it by the caller must
+ * be allocated by these functions.
+ */
+    void *kubeconfig_alloc(kubeconfig_t * kubeconfig, size_t size);
+    void *kubeconfig_realloc(kubeconfig_t * kubeconfig, void *ptr, size_t old_size, size_t size);
+    char *kubeconfig_strndup(kubeconfig_t * kubeconfig, const char *string, size_t length);
+
+/* Like kubeconfig_strndup(), but return the interned copy when kubeconfig has a table of strings. */
+    char *kubeconfig_intern(kubeconfig_t * kubeconfig, const char *string, size_t length);
+    kubeconfig_property_t *kubeconfig_property_alloc(kubeconfig_t * kubeconfig, kubeconfig_property_type_t type);
+    kubeconfig_property_t **kubeconfig_properties_alloc(kubeconfig_t * kubeconfig, int properties_count, kubeconfig_property_type_t type);
+    void kubeconfig_memory_release(const kubeconfig_t * kubeconfig, void *ptr);
 
 #ifdef  __cplusplus
 }
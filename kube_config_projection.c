@@ -0,0 +1,181 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "kube_config_projection.h"
+#include "kube_config_yaml.h"
+#include "kube_config_alloc.h"
+
+static const kubeconfig_field_t kubeconfig_skipped_field = { KUBECONFIG_FIELD_SKIPPED, 0, 0, 0, 0, 0 };
+
+static unsigned int projection_skip_mask(kubeconfig_key_t key)
+{
+    switch (key) {
+    case KUBECONFIG_KEY_USER_AUTH_PROVIDER:
+        return KUBEYAML_SKIP_AUTH_PROVIDER;
+    case KUBECONFIG_KEY_USER_EXEC:
+        return KUBEYAML_SKIP_EXEC;
+    case KUBECONFIG_KEY_CERTIFICATE_AUTHORITY_DATA:
+    case KUBECONFIG_KEY_CLIENT_CERTIFICATE_DATA:
+    case KUBECONFIG_KEY_CLIENT_KEY_DATA:
+    case KUBECONFIG_KEY_USER_AUTH_PROVIDER_CONFIG_IDP_CERTIFICATE_AUTHORITY_DATA:
+        return KUBEYAML_SKIP_DATA;
+    default:
+        return 0;
+    }
+}
+
+const kubeconfig_field_t *kubeconfig_projection_field_lookup(const kubeconfig_projection_t * projection, kubeconfig_property_type_t type, kubeconfig_key_t key)
+{
+    const kubeconfig_field_t *field = kubeconfig_property_field_lookup(type, key);
+
+    if (projection && (projection->skip_fields & projection_skip_mask(key)) && KUBECONFIG_FIELD_NONE != field->kind) {
+        return &kubeconfig_skipped_field;
+    }
+    return field;
+}
+
+int kubeconfig_projection_has_context(const kubeconfig_projection_t * projection, const char *current_context, const char *name)
+{
+    if (!projection || !projection->select) {
+        return 1;
+    }
+    if (!name) {
+        return 0;
+    }
+
+    /* The same pointer when the kubeconfig interns its names. */
+    if (projection->current_context && current_context && (name == current_context || 0 == strcmp(name, current_context))) {
+        return 1;
+    }
+    for (int i = 0; i < projection->contexts_count; i++) {
+        if (projection->contexts[i] && 0 == strcmp(name, projection->contexts[i])) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+static int references_append(char ***p_names, int *p_count, const char *name, int borrowed)
+{
+    static char fname[] = "kubeconfig_references_add()";
+
+    char **names = NULL;
+
+    if (!name || kubeconfig_references_has(*p_names, *p_count, name)) {
+        return 0;
+    }
+
+    names = kubeyaml_realloc(*p_names, (*p_count + 1) * sizeof(char *));
+    if (!names) {
+        fprintf(stderr, "%s: Cannot allocate memory for the references.\n", fname);
+        return -1;
+    }
+    *p_names = names;
+
+    names[*p_count] = borrowed ? (char *) name : kubeyaml_strdup(name);
+    if (!names[*p_count]) {
+        fprintf(stderr, "%s: Cannot allocate memory for the reference %s.\n", fname, name);
+        return -1;
+    }
+    (*p_count)++;
+
+    return 0;
+}
+
+int kubeconfig_references_add(kubeconfig_references_t * references, const char *cluster, const char *user)
+{
+    if (0 != references_append(&references->clusters, &references->clusters_count, cluster, references->borrowed)) {
+        return -1;
+    }
+    return references_append(&references->users, &references->users_count, user, references->borrowed);
+}
+
+int kubeconfig_references_has(char *const *names, int count, const char *name)
+{
+    if (!name) {
+        return 0;
+    }
+    for (int i = 0; i < count; i++) {
+        if (names[i] == name || 0 == strcmp(names[i], name)) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+void kubeconfig_references_clear(kubeconfig_references_t * references)
+{
+    if (references->borrowed) {
+        kubeyaml_free(references->clusters);
+        kubeyaml_free(references->users);
+    } else {
+        kubeconfig_free_string_list(references->clusters, references->clusters_count);
+        kubeconfig_free_string_list(references->users, references->users_count);
+    }
+    memset(references, 0, sizeof(kubeconfig_references_t));
+}
+
+/* Keep the selected contexts, or with references the clusters and users they refer to. */
+static void projection_filter(kubeconfig_t * kubeconfig, kubeconfig_property_t *** p_properties, int *p_count, const kubeconfig_projection_t * projection, const kubeconfig_references_t * references)
+{
+    kubeconfig_property_t **properties = *p_properties;
+    kubeconfig_property_t *property = NULL;
+    int kept = 0;
+    int keep = 0;
+
+    if (!properties) {
+        return;
+    }
+
+    for (int i = 0; i < *p_count; i++) {
+        property = properties[i];
+        if (!property) {
+            continue;
+        }
+        if (!references) {
+            keep = kubeconfig_projection_has_context(projection, kubeconfig->current_context, property->name);
+        } else if (KUBECONFIG_PROPERTY_TYPE_CLUSTER == property->type) {
+            keep = kubeconfig_references_has(references->clusters, references->clusters_count, property->name);
+        } else {
+            keep = kubeconfig_references_has(references->users, references->users_count, property->name);
+        }
+
+        if (keep) {
+            properties[kept++] = property;
+        } else {
+            kubeconfig_property_release(kubeconfig, property);
+        }
+    }
+
+    if (0 == kept) {
+        kubeconfig_memory_release(kubeconfig, properties);
+        *p_properties = NULL;
+    }
+    *p_count = kept;
+}
+
+int kubeconfig_projection_apply(kubeconfig_t * kubeconfig, const kubeconfig_projection_t * projection)
+{
+    kubeconfig_references_t references;
+    int rc = 0;
+
+    if (!projection || !projection->select) {
+        return 0;
+    }
+
+    projection_filter(kubeconfig, &kubeconfig->contexts, &kubeconfig->contexts_count, projection, NULL);
+
+    /* The contexts kept outlive the references, their names are borrowed: interned, they are found by pointer. */
+    memset(&references, 0, sizeof(references));
+    references.borrowed = 1;
+    for (int i = 0; i < kubeconfig->contexts_count && 0 == rc; i++) {
+        rc = kubeconfig_references_add(&references, kubeconfig->contexts[i]->cluster, kubeconfig->contexts[i]->user);
+    }
+    if (0 == rc) {
+        projection_filter(kubeconfig, &kubeconfig->clusters, &kubeconfig->clusters_count, projection, &references);
+        projection_filter(kubeconfig, &kubeconfig->users, &kubeconfig->users_count, projection, &references);
+    }
+
+    kubeconfig_references_clear(&references);
+    return rc;
+}
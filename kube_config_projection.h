@@ -0,0 +1,71 @@
+#ifndef _KUBE_CONFIG_PROJECTION_H
+#define _KUBE_CONFIG_PROJECTION_H
+
+#include <stddef.h>
+#include "kube_config_model.h"
+#include "kube_config_keys.h"
+
+#ifdef  __cplusplus
+extern "C" {
+#endif
+
+/*
+ * A projection limits what a load fills in the kubeconfig: the contexts
+ * selected by name or as the current context with the clusters and users
+ * they refer to, and the fields not masked by KUBEYAML_SKIP_*.
+ *
+ * The loaders skip the entries and fields left out as early as they can,
+ * without copying them. kubeconfig_projection_apply() then removes what is
+ * still left out, so every loader gives the same result.
+ *
+ * With visit, the builder passes each entry of clusters, contexts and
+ * users to it once the entry is complete and frees it, the kubeconfig
+ * only keeps its top-level scalars. Only the builder supports it, the
+ * loaders must stream parser events to it.
+ */
+
+    typedef struct kubeconfig_projection_t {
+        unsigned int skip_fields;       /* KUBEYAML_SKIP_* */
+        int select;             /* only the selected contexts, their clusters and their users are loaded */
+        int current_context;    /* the current context is selected */
+        const char *const *contexts;    /* names of the other selected contexts */
+        int contexts_count;
+        int (*visit) (void *data, const kubeconfig_property_t * property);      /* takes the entries instead of the kubeconfig, see kubeyaml_foreach() */
+        void *visit_data;
+    } kubeconfig_projection_t;
+
+/* Names of the clusters and users the selected contexts refer to. */
+    typedef struct kubeconfig_references_t {
+        char **clusters;
+        int clusters_count;
+        char **users;
+        int users_count;
+        int borrowed;           /* the names are not copied, they must outlive the references */
+    } kubeconfig_references_t;
+
+/*
+ * Field of key in a property of the given type like
+ * kubeconfig_property_field_lookup(), of kind KUBECONFIG_FIELD_SKIPPED if the
+ * projection skips it. projection may be NULL. Never NULL.
+ */
+    const kubeconfig_field_t *kubeconfig_projection_field_lookup(const kubeconfig_projection_t * projection, kubeconfig_property_type_t type, kubeconfig_key_t key);
+
+/* current_context is the current context of the kubeconfig, or NULL. */
+    int kubeconfig_projection_has_context(const kubeconfig_projection_t * projection, const char *current_context, const char *name);
+
+/* cluster and user may be NULL, they are copied unless references->borrowed is set. */
+    int kubeconfig_references_add(kubeconfig_references_t * references, const char *cluster, const char *user);
+/* A borrowed name interned by KUBEYAML_LOAD_INTERN is found by its pointer. */
+    int kubeconfig_references_has(char *const *names, int count, const char *name);
+    void kubeconfig_references_clear(kubeconfig_references_t * references);
+
+/*
+ * Remove the contexts the projection does not select and the clusters and
+ * users they do not refer to.
+ */
+    int kubeconfig_projection_apply(kubeconfig_t * kubeconfig, const kubeconfig_projection_t * projection);
+
+#ifdef  __cplusplus
+}
+#endif
+#endif                          /* _KUBE_CONFIG_PROJECTION_H */
@@ -0,0 +1,430 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "kube_config_query.h"
+#include "kube_config_keys.h"
+#include "kube_config_alloc.h"
+
+/* What the path leads to after each of its steps. */
+typedef enum query_state_t {
+    QUERY_STATE_NONE = 0,       /* nothing the kubeconfig loads */
+    QUERY_STATE_TOP,
+    QUERY_STATE_PROPERTY,
+    QUERY_STATE_PROPERTIES,
+    QUERY_STATE_STRINGS,
+    QUERY_STATE_PAIRS,
+    QUERY_STATE_PAIR,
+    QUERY_STATE_STRING
+} query_state_t;
+
+typedef enum query_op_type_t {
+    QUERY_OP_MEMBER = 1,        /* member of the current object */
+    QUERY_OP_POSITION,          /* i-th item of the current list */
+    QUERY_OP_MATCH              /* item of the current list whose string member equals value */
+} query_op_type_t;
+
+typedef struct query_op_t {
+    query_op_type_t type;
+    kubeconfig_field_kind_t kind;       /* MEMBER */
+    size_t offset;              /* MEMBER: the member, MATCH: the string member of the items */
+    size_t count_offset;        /* MEMBER of a list */
+    long position;              /* POSITION */
+    const char *value;          /* MATCH, in the path of the query */
+    size_t value_length;
+    int hint;                   /* MATCH: position of the last match */
+    int data;                   /* MEMBER and MATCH: a *-data string member, a kubeconfig_data_t if the kubeconfig is decoded */
+} query_op_t;
+
+struct kubeyaml_query_t {
+    char *path;
+    char *values;               /* copy of the path, the values of the selections are NUL-terminated in it */
+    query_op_t *ops;
+    int ops_count;
+    query_state_t state;        /* after the last step, NONE if the query never finds anything in a kubeconfig_t */
+    int data;                   /* the STRING found is a *-data field */
+};
+
+static const kubeconfig_field_t query_pair_key = { KUBECONFIG_FIELD_STRING, offsetof(keyValuePair_t, key), 0, 0, 0, 0 };
+static const kubeconfig_field_t query_pair_value = { KUBECONFIG_FIELD_STRING, offsetof(keyValuePair_t, value), 0, 0, 0, 0 };
+static const kubeconfig_field_t query_no_field = { KUBECONFIG_FIELD_NONE, 0, 0, 0, 0, 0 };
+
+/*
+ * Compilation
+ */
+
+static query_op_t *query_add_op(kubeyaml_query_t * query, query_op_type_t type)
+{
+    query_op_t *op = &query->ops[query->ops_count++];
+
+    memset(op, 0, sizeof(query_op_t));
+    op->type = type;
+    return op;
+}
+
+static const kubeconfig_field_t *query_pair_field(const char *key, size_t key_length)
+{
+    if (4 == key_length && 0 == memcmp(key, KEY_USER_EXEC_ENV_KEY, 4)) {
+        return &query_pair_key;
+    } else if (5 == key_length && 0 == memcmp(key, KEY_USER_EXEC_ENV_VALUE, 5)) {
+        return &query_pair_value;
+    }
+    return &query_no_field;
+}
+
+static query_state_t query_member_state(kubeyaml_query_t * query, const kubeconfig_field_t * field, kubeconfig_property_type_t * p_type)
+{
+    query_op_t *op = NULL;
+
+    if (KUBECONFIG_FIELD_NONE == field->kind) {
+        return QUERY_STATE_NONE;
+    }
+
+    op = query_add_op(query, QUERY_OP_MEMBER);
+    op->kind = field->kind;
+    op->offset = field->offset;
+    op->count_offset = field->count_offset;
+    op->data = field->data;
+
+    switch (field->kind) {
+    case KUBECONFIG_FIELD_STRING:
+        return QUERY_STATE_STRING;
+    case KUBECONFIG_FIELD_SUB_PROPERTY:
+        *p_type = field->property_type;
+        return QUERY_STATE_PROPERTY;
+    case KUBECONFIG_FIELD_STRINGS:
+        return QUERY_STATE_STRINGS;
+    case KUBECONFIG_FIELD_PAIRS:
+        return QUERY_STATE_PAIRS;
+    case KUBECONFIG_FIELD_PROPERTIES:
+        *p_type = field->property_type;
+        return QUERY_STATE_PROPERTIES;
+    default:
+        return QUERY_STATE_NONE;
+    }
+}
+
+/* A mapping key, is_last if nothing follows it in the path. */
+static query_state_t query_compile_key(kubeyaml_query_t * query, query_state_t state, const char *key, size_t key_length, int is_last, kubeconfig_property_type_t * p_type)
+{
+    const kubeconfig_field_t *field = NULL;
+
+    switch (state) {
+    case QUERY_STATE_TOP:
+        return query_member_state(query, kubeconfig_top_field_lookup(kubeconfig_key_lookup(key, key_length)), p_type);
+    case QUERY_STATE_PROPERTY:
+        field = kubeconfig_property_field_lookup(*p_type, kubeconfig_key_lookup(key, key_length));
+        if (KUBECONFIG_FIELD_NONE == field->kind && !is_last) {
+            /* A mapping nested in the entry, e.g. "cluster", fills the same property. */
+            return QUERY_STATE_PROPERTY;
+        }
+        return query_member_state(query, field, p_type);
+    case QUERY_STATE_PAIR:
+        return query_member_state(query, query_pair_field(key, key_length), p_type);
+    default:
+        return QUERY_STATE_NONE;
+    }
+}
+
+/* "[i]" or "[key=value]" after the key, *p_state is the state after it. */
+static int query_compile_selector(kubeyaml_query_t * query, query_state_t * p_state, const char *selector, size_t selector_length, kubeconfig_property_type_t type)
+{
+    static char fname[] = "kubeyaml_query_compile()";
+
+    const char *equal = memchr(selector, '=', selector_length);
+    const kubeconfig_field_t *field = NULL;
+    query_state_t state = *p_state;
+    query_op_t *op = NULL;
+    long position = 0;
+    char *end = NULL;
+
+    *p_state = QUERY_STATE_NONE;
+
+    if (!equal) {
+        position = strtol(selector, &end, 10);
+        if (0 == selector_length || end != selector + selector_length || position < 0) {
+            fprintf(stderr, "%s: The sequence index %.*s is invalid.\n", fname, (int) selector_length, selector);
+            return -1;
+        }
+        if (QUERY_STATE_PROPERTIES != state && QUERY_STATE_STRINGS != state && QUERY_STATE_PAIRS != state) {
+            return 0;
+        }
+        op = query_add_op(query, QUERY_OP_POSITION);
+        op->position = position;
+    } else {
+        if (QUERY_STATE_PROPERTIES == state) {
+            field = kubeconfig_property_field_lookup(type, kubeconfig_key_lookup(selector, (size_t) (equal - selector)));
+        } else if (QUERY_STATE_PAIRS == state) {
+            field = query_pair_field(selector, (size_t) (equal - selector));
+        } else {
+            return 0;
+        }
+        if (KUBECONFIG_FIELD_STRING != field->kind) {
+            return 0;
+        }
+        op = query_add_op(query, QUERY_OP_MATCH);
+        op->offset = field->offset;
+        op->data = field->data;
+        op->value = equal + 1;
+        op->value_length = selector_length - (size_t) (equal - selector) - 1;
+    }
+
+    switch (state) {
+    case QUERY_STATE_PROPERTIES:
+        *p_state = QUERY_STATE_PROPERTY;
+        break;
+    case QUERY_STATE_STRINGS:
+        *p_state = QUERY_STATE_STRING;
+        break;
+    default:
+        *p_state = QUERY_STATE_PAIR;
+        break;
+    }
+    return 0;
+}
+
+static int query_compile(kubeyaml_query_t * query)
+{
+    static char fname[] = "kubeyaml_query_compile()";
+
+    char *p = query->values;
+    const char *key = NULL;
+    char *close = NULL;
+    kubeconfig_property_type_t type = 0;
+    query_state_t state = QUERY_STATE_TOP;
+    size_t key_length = 0;
+
+    if (!*p) {
+        fprintf(stderr, "%s: The path is empty.\n", fname);
+        return -1;
+    }
+
+    while (*p) {
+        key = p;
+        while (*p && '.' != *p && '[' != *p) {
+            p++;
+        }
+        if (p == key) {
+            fprintf(stderr, "%s: The path %s is invalid.\n", fname, query->path);
+            return -1;
+        }
+        key_length = (size_t) (p - key);
+        state = query_compile_key(query, state, key, key_length, ('\0' == *p), &type);
+
+        while ('[' == *p) {
+            close = strchr(p, ']');
+            if (!close) {
+                fprintf(stderr, "%s: The path %s is invalid.\n", fname, query->path);
+                return -1;
+            }
+            if (0 != query_compile_selector(query, &state, p + 1, (size_t) (close - p - 1), type)) {
+                return -1;
+            }
+            /* The value of a selection is compared as a string. */
+            *close = '\0';
+            p = close + 1;
+        }
+
+        if ('.' == *p) {
+            p++;
+            if (!*p) {
+                fprintf(stderr, "%s: The path %s is invalid.\n", fname, query->path);
+                return -1;
+            }
+        } else if (*p) {
+            fprintf(stderr, "%s: The path %s is invalid.\n", fname, query->path);
+            return -1;
+        }
+    }
+
+    query->state = state;
+    if (QUERY_STATE_NONE == state) {
+        query->ops_count = 0;
+    } else if (QUERY_STATE_STRING == state) {
+        query->data = query->ops[query->ops_count - 1].data;
+    }
+    return 0;
+}
+
+kubeyaml_query_t *kubeyaml_query_compile(const char *path)
+{
+    static char fname[] = "kubeyaml_query_compile()";
+
+    kubeyaml_query_t *query = NULL;
+    size_t length = 0;
+
+    if (!path) {
+        fprintf(stderr, "%s: The path is null.\n", fname);
+        return NULL;
+    }
+    length = strlen(path);
+
+    query = kubeyaml_calloc(1, sizeof(kubeyaml_query_t));
+    if (!query) {
+        fprintf(stderr, "%s: Cannot allocate memory for the query.\n", fname);
+        return NULL;
+    }
+    query->path = kubeyaml_strdup(path);
+    query->values = kubeyaml_strdup(path);
+    /* A step adds at most one operation for its key and one for each selection. */
+    query->ops = kubeyaml_calloc(length + 1, sizeof(query_op_t));
+    if (!query->path || !query->values || !query->ops) {
+        fprintf(stderr, "%s: Cannot allocate memory for the query.\n", fname);
+        kubeyaml_query_free(query);
+        return NULL;
+    }
+
+    if (0 != query_compile(query)) {
+        kubeyaml_query_free(query);
+        return NULL;
+    }
+    return query;
+}
+
+void kubeyaml_query_free(kubeyaml_query_t * query)
+{
+    if (!query) {
+        return;
+    }
+
+    if (query->path) {
+        kubeyaml_free(query->path);
+    }
+    if (query->values) {
+        kubeyaml_free(query->values);
+    }
+    if (query->ops) {
+        kubeyaml_free(query->ops);
+    }
+
+    kubeyaml_free(query);
+}
+
+/*
+ * Execution
+ */
+
+static int query_item_matches(const void *item, const query_op_t * op, const kubeconfig_t * kubeconfig)
+{
+    const char *string = NULL;
+
+    /* The bytes of a decoded *-data field are not compared with the text of the path. */
+    if (!item || (op->data && kubeconfig->data_decoded)) {
+        return 0;
+    }
+    string = *KUBECONFIG_FIELD_MEMBER(item, op->offset, char *);
+    return (string && 0 == strcmp(string, op->value));
+}
+
+static const void *query_match(query_op_t * op, void *const *items, int count, const kubeconfig_t * kubeconfig)
+{
+    int hint = __atomic_load_n(&op->hint, __ATOMIC_RELAXED);
+
+    if (hint < count && query_item_matches(items[hint], op, kubeconfig)) {
+        return items[hint];
+    }
+
+    for (int i = 0; i < count; i++) {
+        if (query_item_matches(items[i], op, kubeconfig)) {
+            __atomic_store_n(&op->hint, i, __ATOMIC_RELAXED);
+            return items[i];
+        }
+    }
+    return NULL;
+}
+
+int kubeyaml_query_run(const kubeyaml_query_t * query, const kubeconfig_t * kubeconfig, kubeyaml_query_value_t * value)
+{
+    static char fname[] = "kubeyaml_query_run()";
+
+    const void *object = kubeconfig;
+    void *const *items = NULL;
+    int count = 0;
+    query_op_t *op = NULL;
+
+    if (!query || !kubeconfig || !value) {
+        fprintf(stderr, "%s: The query, the kubeconfig or the value is null.\n", fname);
+        return -1;
+    }
+    memset(value, 0, sizeof(kubeyaml_query_value_t));
+
+    for (int i = 0; i < query->ops_count; i++) {
+        op = &query->ops[i];
+
+        if (QUERY_OP_MEMBER == op->type) {
+            if (KUBECONFIG_FIELD_STRING == op->kind || KUBECONFIG_FIELD_SUB_PROPERTY == op->kind) {
+                object = *KUBECONFIG_FIELD_MEMBER(object, op->offset, void *);
+            } else {
+                items = *KUBECONFIG_FIELD_MEMBER(object, op->offset, void **);
+                count = *KUBECONFIG_FIELD_MEMBER(object, op->count_offset, int);
+                object = items;
+            }
+        } else if (QUERY_OP_POSITION == op->type) {
+            object = (op->position < count) ? items[op->position] : NULL;
+        } else {
+            object = query_match(op, items, count, kubeconfig);
+        }
+
+        if (!object) {
+            return 0;
+        }
+    }
+
+    switch (query->state) {
+    case QUERY_STATE_STRING:
+        if (query->data && kubeconfig->data_decoded) {
+            value->type = KUBEYAML_QUERY_DATA;
+            value->data = object;
+        } else {
+            value->type = KUBEYAML_QUERY_STRING;
+            value->string = object;
+        }
+        break;
+    case QUERY_STATE_STRINGS:
+        value->type = KUBEYAML_QUERY_STRINGS;
+        value->strings = (char *const *) items;
+        value->count = count;
+        break;
+    case QUERY_STATE_PAIRS:
+        value->type = KUBEYAML_QUERY_PAIRS;
+        value->pairs = (keyValuePair_t * const *) items;
+        value->count = count;
+        break;
+    case QUERY_STATE_PAIR:
+        value->type = KUBEYAML_QUERY_PAIR;
+        value->pair = object;
+        break;
+    case QUERY_STATE_PROPERTY:
+        value->type = KUBEYAML_QUERY_PROPERTY;
+        value->property = object;
+        break;
+    case QUERY_STATE_PROPERTIES:
+        value->type = KUBEYAML_QUERY_PROPERTIES;
+        value->properties = (kubeconfig_property_t * const *) items;
+        value->count = count;
+        break;
+    default:
+        break;
+    }
+    return 0;
+}
+
+const char *kubeyaml_query_get_string(const kubeyaml_query_t * query, const kubeconfig_t * kubeconfig)
+{
+    kubeyaml_query_value_t value;
+
+    if (0 != kubeyaml_query_run(query, kubeconfig, &value) || KUBEYAML_QUERY_STRING != value.type) {
+        return NULL;
+    }
+    return value.string;
+}
+
+int kubeyaml_query_get_index_string(const kubeyaml_query_t * query, const kubeyaml_index_t * index, char **value)
+{
+    static char fname[] = "kubeyaml_query_get_index_string()";
+
+    if (!query) {
+        fprintf(stderr, "%s: The query is null.\n", fname);
+        return -1;
+    }
+    return kubeyaml_index_get_string(index, query->path, value);
+}
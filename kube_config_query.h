@@ -0,0 +1,124 @@
+#ifndef _KUBE_CONFIG_QUERY_H
+#define _KUBE_CONFIG_QUERY_H
+
+#include "kube_config_model.h"
+#include "kube_config_index.h"
+
+#ifdef  __cplusplus
+extern "C" {
+#endif
+
+/*
+ * A query finds a value of a kubeconfig by its path, e.g.
+ * "users[name=prod-admin].user.exec.args" or "clusters[0].cluster.server",
+ * with the syntax of kubeyaml_index_get_string(): mapping keys separated by
+ * '.', each may be followed by "[i]" to select the i-th entry of a
+ * sequence or by "[key=value]" to select the entry with this key and value.
+ *
+ * kubeyaml_query_compile() parses the path once and resolves its keys to
+ * the members of kubeconfig_t and kubeconfig_property_t they are loaded
+ * into. Running the query is then a walk through these members, without
+ * any key comparison. A "[key=value]" selection remembers the entry it
+ * found last and checks it first the next time, so a query run again on
+ * the same kubeconfig does not scan the entries.
+ *
+ * On a kubeconfig_t, the mappings nested in an entry are one property,
+ * like when the kubeconfig is loaded: "clusters[0].cluster.server" and
+ * "clusters[0].server" are the same member, and "[server=...]" selects a
+ * cluster by the server of its cluster mapping. Keys the kubeconfig does
+ * not load give no value. The same query runs on the text of a kubeconfig
+ * through its index, where the path is followed as it is written.
+ *
+ * On a kubeconfig loaded with KUBEYAML_LOAD_DECODE_DATA, the
+ * certificate-authority-data, client-certificate-data and client-key-data
+ * fields are KUBEYAML_QUERY_DATA values, their decoded bytes, and are not
+ * strings for kubeyaml_query_get_string(). A "[key=value]" selection on
+ * one of them selects nothing.
+ */
+
+    typedef struct kubeyaml_query_t kubeyaml_query_t;
+
+    typedef enum kubeyaml_query_type_t {
+        KUBEYAML_QUERY_NONE = 0,        /* nothing at the path */
+        KUBEYAML_QUERY_STRING,  /* string, e.g. "current-context" */
+        KUBEYAML_QUERY_STRINGS, /* strings and count, e.g. "users[0].user.exec.args" */
+        KUBEYAML_QUERY_PAIRS,   /* pairs and count, e.g. "users[0].user.exec.env" */
+        KUBEYAML_QUERY_PAIR,    /* pair, e.g. "users[0].user.exec.env[name=HOME]" */
+        KUBEYAML_QUERY_PROPERTY,        /* property, e.g. "users[name=admin]" */
+        KUBEYAML_QUERY_PROPERTIES,      /* properties and count, e.g. "users" */
+        KUBEYAML_QUERY_DATA     /* decoded bytes, e.g. "clusters[0].cluster.certificate-authority-data", see above */
+    } kubeyaml_query_type_t;
+
+/* The value found by a query points into the kubeconfig, it is valid until the kubeconfig is changed or freed. */
+    typedef struct kubeyaml_query_value_t {
+        kubeyaml_query_type_t type;
+        const char *string;
+        char *const *strings;
+        keyValuePair_t *const *pairs;
+        const keyValuePair_t *pair;
+        const kubeconfig_property_t *property;
+        kubeconfig_property_t *const *properties;
+        const kubeconfig_data_t *data;  /* DATA, data->length bytes */
+        int count;              /* STRINGS, PAIRS and PROPERTIES */
+    } kubeyaml_query_value_t;
+
+/*
+ * kubeyaml_query_compile
+ *
+ * Description:
+ *
+ * Compile the path of a query, see above.
+ *
+ * Return:
+ *
+ *   The query, to be freed by kubeyaml_query_free(), or NULL if the path is
+ *   invalid or the memory cannot be allocated.
+ *
+ * Parameter:
+ *
+ * IN:
+ * path: path of the value, it is copied
+ *
+ */
+    kubeyaml_query_t *kubeyaml_query_compile(const char *path);
+
+    void kubeyaml_query_free(kubeyaml_query_t * query);
+
+/*
+ * kubeyaml_query_run
+ *
+ * Description:
+ *
+ * Find the value of the query in a kubeconfig. A query may be run by
+ * several threads at the same time.
+ *
+ * Return:
+ *
+ *   0     Success, value->type is KUBEYAML_QUERY_NONE if there is nothing at the path
+ *  -1     Failed, the query or the kubeconfig is null
+ *
+ * Parameter:
+ *
+ * IN:
+ * query: compiled query
+ * kubeconfig: loaded kubeconfig
+ *
+ * OUT:
+ * value: value at the path of the query
+ *
+ */
+    int kubeyaml_query_run(const kubeyaml_query_t * query, const kubeconfig_t * kubeconfig, kubeyaml_query_value_t * value);
+
+/* The string at the path of the query, NULL if there is none or the value is not a string, e.g. KUBEYAML_QUERY_DATA. */
+    const char *kubeyaml_query_get_string(const kubeyaml_query_t * query, const kubeconfig_t * kubeconfig);
+
+/*
+ * Like kubeyaml_index_get_string() with the path of the query, to get the
+ * scalar of the query from the text of a kubeconfig without loading it.
+ */
+    int kubeyaml_query_get_index_string(const kubeyaml_query_t * query, const kubeyaml_index_t * index, char **value);
+
+#ifdef  __cplusplus
+}
+#endif
+#endif                          /* _KUBE_CONFIG_QUERY_H */
@@ -0,0 +1,370 @@
+#include <ctype.h>
+#include <pthread.h>
+#include <string.h>
+#include "kube_config_scalar.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define KUBEYAML_SCALAR_X86
+#endif
+
+/* Only blanks or a comment may follow a scalar on its line. */
+int kubeconfig_scalar_rest_is_empty(const char *p, const char *eol)
+{
+    if (p == eol) {
+        return 1;
+    }
+    if (!KUBECONFIG_SCALAR_IS_BLANK(*p)) {
+        return 0;
+    }
+    while (p < eol && KUBECONFIG_SCALAR_IS_BLANK(*p)) {
+        p++;
+    }
+    return (p == eol || '#' == *p);
+}
+
+/*
+ * Spans
+ *
+ * The certificates and keys of a kubeconfig are base64 scalars of several
+ * KB. Their runs of ordinary characters are skipped 16 or 32 bytes at a
+ * time, the scan only stops on the two indicators of the scalar (':' and
+ * '#' in a plain scalar, the quote and the backslash in a quoted one or a
+ * JSON string) and on the tab, control, DEL or non-ASCII bytes, which are
+ * then looked at one by one. The vector width is selected once for the
+ * CPU.
+ */
+
+#define SCALAR_IS_SPAN_STOP(c, a, b) ((a) == (c) || (b) == (c) || (unsigned char) (c) < 0x20 || (unsigned char) (c) >= 0x7f)
+
+static const char *scalar_span_generic(const char *p, const char *eol, char a, char b)
+{
+    while (p < eol && !SCALAR_IS_SPAN_STOP(*p, a, b)) {
+        p++;
+    }
+    return p;
+}
+
+#ifdef KUBEYAML_SCALAR_X86
+
+__attribute__ ((target("sse2")))
+static const char *scalar_span_sse2(const char *p, const char *eol, char a, char b)
+{
+    const __m128i stop_a = _mm_set1_epi8(a);
+    const __m128i stop_b = _mm_set1_epi8(b);
+    const __m128i space = _mm_set1_epi8(' ');
+    const __m128i del = _mm_set1_epi8(0x7F);
+    __m128i chunk;
+    int mask = 0;
+
+    while (eol - p >= 16) {
+        chunk = _mm_loadu_si128((const __m128i *) p);
+        /* The signed compare also catches the bytes above 0x7F. */
+        mask = _mm_movemask_epi8(_mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(chunk, stop_a), _mm_cmpeq_epi8(chunk, stop_b)), _mm_or_si128(_mm_cmpgt_epi8(space, chunk), _mm_cmpeq_epi8(chunk, del))));
+        if (mask) {
+            return p + __builtin_ctz((unsigned int) mask);
+        }
+        p += 16;
+    }
+    return scalar_span_generic(p, eol, a, b);
+}
+
+__attribute__ ((target("avx2")))
+static const char *scalar_span_avx2(const char *p, const char *eol, char a, char b)
+{
+    const __m256i stop_a = _mm256_set1_epi8(a);
+    const __m256i stop_b = _mm256_set1_epi8(b);
+    const __m256i space = _mm256_set1_epi8(' ');
+    const __m256i del = _mm256_set1_epi8(0x7F);
+    __m256i chunk;
+    unsigned int mask = 0;
+
+    while (eol - p >= 32) {
+        chunk = _mm256_loadu_si256((const __m256i *) p);
+        mask = (unsigned int) _mm256_movemask_epi8(_mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(chunk, stop_a), _mm256_cmpeq_epi8(chunk, stop_b)),
+                                                                  _mm256_or_si256(_mm256_cmpgt_epi8(space, chunk), _mm256_cmpeq_epi8(chunk, del))));
+        if (mask) {
+            return p + __builtin_ctz(mask);
+        }
+        p += 32;
+    }
+    return scalar_span_sse2(p, eol, a, b);
+}
+
+#endif
+
+typedef const char *(*scalar_span_t)(const char *p, const char *eol, char a, char b);
+
+static scalar_span_t scalar_span_selected = scalar_span_generic;
+static pthread_once_t scalar_span_once = PTHREAD_ONCE_INIT;
+
+static void scalar_span_select(void)
+{
+#ifdef KUBEYAML_SCALAR_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        scalar_span_selected = scalar_span_avx2;
+    } else if (__builtin_cpu_supports("sse2")) {
+        scalar_span_selected = scalar_span_sse2;
+    }
+#endif
+}
+
+const char *kubeconfig_scalar_span(const char *p, const char *eol, char a, char b)
+{
+    /* Names and short values are not worth the vector setup. */
+    if (eol - p < 16) {
+        return scalar_span_generic(p, eol, a, b);
+    }
+    pthread_once(&scalar_span_once, scalar_span_select);
+    return scalar_span_selected(p, eol, a, b);
+}
+
+static char *scalar_put_utf8(char *out, unsigned long c)
+{
+    if (c < 0x80) {
+        *out++ = (char) c;
+    } else if (c < 0x800) {
+        *out++ = (char) (0xC0 | (c >> 6));
+        *out++ = (char) (0x80 | (c & 0x3F));
+    } else if (c < 0x10000) {
+        *out++ = (char) (0xE0 | (c >> 12));
+        *out++ = (char) (0x80 | ((c >> 6) & 0x3F));
+        *out++ = (char) (0x80 | (c & 0x3F));
+    } else {
+        *out++ = (char) (0xF0 | (c >> 18));
+        *out++ = (char) (0x80 | ((c >> 12) & 0x3F));
+        *out++ = (char) (0x80 | ((c >> 6) & 0x3F));
+        *out++ = (char) (0x80 | (c & 0x3F));
+    }
+    return out;
+}
+
+static int scalar_hex(const char *p, const char *eol, int digits, unsigned long *value)
+{
+    int i = 0;
+
+    *value = 0;
+    for (i = 0; i < digits; i++) {
+        if (p + i >= eol || !isxdigit((unsigned char) p[i])) {
+            return KUBECONFIG_SCALAR_UNSUPPORTED;
+        }
+        *value = (*value << 4) + (isdigit((unsigned char) p[i]) ? p[i] - '0' : (tolower((unsigned char) p[i]) - 'a' + 10));
+    }
+    return 0;
+}
+
+/*
+ * Unescape the quoted scalar starting at p into scratch. *next is set
+ * past the closing quote. A scalar that continues on the next line is not
+ * supported.
+ */
+static int scalar_quoted(const char *p, const char *eol, char *scratch, const char **value, size_t *length, const char **next)
+{
+    char quote = *p++;
+    unsigned long c = 0;
+    char *out = scratch;
+    const char *q = NULL;
+    int digits = 0;
+
+    while (p < eol) {
+        q = kubeconfig_scalar_span(p, eol, quote, '\\');
+        memcpy(out, p, (size_t) (q - p));
+        out += q - p;
+        p = q;
+        if (p == eol) {
+            break;
+        }
+        if (quote == *p) {
+            /* '' is a single quote inside a single-quoted scalar */
+            if ('\'' == quote && p + 1 < eol && '\'' == p[1]) {
+                *out++ = '\'';
+                p += 2;
+                continue;
+            }
+            break;
+        }
+        if (!KUBECONFIG_SCALAR_IS_TEXT(*p)) {
+            return KUBECONFIG_SCALAR_UNSUPPORTED;
+        }
+        if ('\\' == *p && '"' == quote) {
+            if (++p == eol) {
+                return KUBECONFIG_SCALAR_UNSUPPORTED;
+            }
+            digits = 0;
+            switch (*p) {
+            case '0':
+                *out++ = '\0';
+                break;
+            case 'a':
+                *out++ = '\a';
+                break;
+            case 'b':
+                *out++ = '\b';
+                break;
+            case 't':
+            case '\t':
+                *out++ = '\t';
+                break;
+            case 'n':
+                *out++ = '\n';
+                break;
+            case 'v':
+                *out++ = '\v';
+                break;
+            case 'f':
+                *out++ = '\f';
+                break;
+            case 'r':
+                *out++ = '\r';
+                break;
+            case 'e':
+                *out++ = '\x1B';
+                break;
+            case ' ':
+            case '"':
+            case '/':
+            case '\'':
+            case '\\':
+                *out++ = *p;
+                break;
+            case 'N':
+                out = scalar_put_utf8(out, 0x85);
+                break;
+            case '_':
+                out = scalar_put_utf8(out, 0xA0);
+                break;
+            case 'L':
+                out = scalar_put_utf8(out, 0x2028);
+                break;
+            case 'P':
+                out = scalar_put_utf8(out, 0x2029);
+                break;
+            case 'x':
+                digits = 2;
+                break;
+            case 'u':
+                digits = 4;
+                break;
+            case 'U':
+                digits = 8;
+                break;
+            default:
+                return KUBECONFIG_SCALAR_UNSUPPORTED;
+            }
+            if (digits) {
+                if (scalar_hex(p + 1, eol, digits, &c) || (c >= 0xD800 && c <= 0xDFFF) || c > 0x10FFFF) {
+                    return KUBECONFIG_SCALAR_UNSUPPORTED;
+                }
+                out = scalar_put_utf8(out, c);
+                p += digits;
+            }
+            p++;
+        } else {
+            *out++ = *p++;
+        }
+    }
+
+    if (p == eol) {
+        return KUBECONFIG_SCALAR_UNSUPPORTED;
+    }
+
+    *value = scratch;
+    *length = (size_t) (out - scratch);
+    *next = p + 1;
+    return 0;
+}
+
+/* Indicators that start anchors, aliases, tags, block scalars, flow collections, directives and complex keys. */
+int kubeconfig_scalar_plain_start(const char *p, const char *eol)
+{
+    switch (*p) {
+    case '[':
+    case ']':
+    case '{':
+    case '}':
+    case ',':
+    case '#':
+    case '&':
+    case '*':
+    case '!':
+    case '|':
+    case '>':
+    case '%':
+    case '@':
+    case '`':
+        return KUBECONFIG_SCALAR_UNSUPPORTED;
+    case '-':
+    case '?':
+    case ':':
+        if (p + 1 == eol || KUBECONFIG_SCALAR_IS_BLANK(p[1])) {
+            return KUBECONFIG_SCALAR_UNSUPPORTED;
+        }
+        break;
+    default:
+        break;
+    }
+    return 0;
+}
+
+/*
+ * Scan the scalar starting at p. *next is set to the ':' of a mapping key,
+ * or to what follows the scalar on the line.
+ */
+int kubeconfig_scalar_scan(const char *p, const char *eol, char *scratch, const char **value, size_t *length, const char **next)
+{
+    const char *q = p;
+    const char *end = NULL;
+    int rc = 0;
+
+    if ('"' == *p || '\'' == *p) {
+        rc = scalar_quoted(p, eol, scratch, value, length, next);
+        if (rc) {
+            return rc;
+        }
+        q = *next;
+        while (q < eol && KUBECONFIG_SCALAR_IS_BLANK(*q)) {
+            q++;
+        }
+        if (q < eol && ':' == *q) {
+            /* libyaml only takes "key":value as a key in a flow collection. */
+            if (q + 1 < eol && !KUBECONFIG_SCALAR_IS_BLANK(q[1])) {
+                return KUBECONFIG_SCALAR_UNSUPPORTED;
+            }
+            *next = q;
+        }
+        return 0;
+    }
+
+    rc = kubeconfig_scalar_plain_start(p, eol);
+    if (rc) {
+        return rc;
+    }
+
+    while (q < eol) {
+        q = kubeconfig_scalar_span(q, eol, ':', '#');
+        if (q == eol) {
+            break;
+        }
+        if (':' == *q && (q + 1 == eol || KUBECONFIG_SCALAR_IS_BLANK(q[1]))) {
+            break;
+        }
+        if ('#' == *q && KUBECONFIG_SCALAR_IS_BLANK(q[-1])) {
+            break;
+        }
+        if (!KUBECONFIG_SCALAR_IS_TEXT(*q)) {
+            return KUBECONFIG_SCALAR_UNSUPPORTED;
+        }
+        q++;
+    }
+
+    end = q;
+    while (end > p && KUBECONFIG_SCALAR_IS_BLANK(end[-1])) {
+        end--;
+    }
+
+    *value = p;
+    *length = (size_t) (end - p);
+    *next = (q < eol && '#' == *q) ? end : q;
+    return 0;
+}
@@ -0,0 +1,40 @@
+#ifndef _KUBE_CONFIG_SCALAR_H
+#define _KUBE_CONFIG_SCALAR_H
+
+#include <stddef.h>
+
+#ifdef  __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Scalars of the YAML subset kubectl writes: plain, single-quoted or
+ * double-quoted, always on a single line. The functions return
+ * KUBECONFIG_SCALAR_UNSUPPORTED for anything else (block scalars, multi-line
+ * scalars, anchors, tags, control or non-ASCII characters), the caller then
+ * leaves the input to libyaml.
+ *
+ * eol is the end of the line, CR excluded.
+ */
+
+#define KUBECONFIG_SCALAR_UNSUPPORTED 1
+
+#define KUBECONFIG_SCALAR_IS_TEXT(c) (((unsigned char) (c) >= 0x20 && (unsigned char) (c) < 0x7f) || '\t' == (c))
+#define KUBECONFIG_SCALAR_IS_BLANK(c) (' ' == (c) || '\t' == (c))
+
+    int kubeconfig_scalar_rest_is_empty(const char *p, const char *eol);
+    int kubeconfig_scalar_plain_start(const char *p, const char *eol);
+
+/* Return the first byte of [p, eol) that is a or b or is not a printable ASCII character, eol if there is none. */
+    const char *kubeconfig_scalar_span(const char *p, const char *eol, char a, char b);
+
+/*
+ * scratch receives the unescaped text of a quoted scalar, it must hold at
+ * least eol - p bytes. A plain scalar is returned in place.
+ */
+    int kubeconfig_scalar_scan(const char *p, const char *eol, char *scratch, const char **value, size_t *length, const char **next);
+
+#ifdef  __cplusplus
+}
+#endif
+#endif                          /* _KUBE_CONFIG_SCALAR_H */
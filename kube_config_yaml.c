@@ -1,6 +1,20 @@
 #include "yaml.h"
 #include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 #include "kube_config_yaml.h"
+#include "kube_config_keys.h"
+#include "kube_config_builder.h"
+#include "kube_config_scalar.h"
+#include "kube_config_projection.h"
+#include "kube_config_index.h"
+#include "kube_config_json.h"
+#include "kube_config_base64.h"
+#include "kube_config_compress.h"
+#include "kube_config_alloc.h"
 
 /*
 A valid sequence of events should obey the grammar :
@@ -12,46 +26,7 @@ sequence :: = SEQUENCE - START node * SEQUENCE - END
 mapping :: = MAPPING - START(node node) * MAPPING - END
 */
 
-#define KEY_APIVERSION "apiVersion"
-#define KEY_KIND "kind"
-#define KEY_CURRENT_CONTEXT "current-context"
-#define KEY_PREFERENCES "preferences"
-#define KEY_CLUSTERS "clusters"
-#define KEY_CLUSTER "cluster"
-#define KEY_CONTEXTS "contexts"
-#define KEY_CONTEXT "context"
-#define KEY_NAMESPACE "namespace"
-#define KEY_USERS "users"
-#define KEY_USER "user"
-#define KEY_NAME "name"
-#define KEY_USER_EXEC "exec"
-#define KEY_USER_EXEC_COMMAND "command"
-#define KEY_USER_EXEC_ENV "env"
-#define KEY_USER_EXEC_ENV_KEY "name"
-#define KEY_USER_EXEC_ENV_VALUE "value"
-#define KEY_USER_EXEC_ARGS "args"
-#define KEY_USER_AUTH_PROVIDER "auth-provider"
-#define KEY_USER_AUTH_PROVIDER_CONFIG "config"
-#define KEY_USER_AUTH_PROVIDER_CONFIG_ACCESS_TOKEN "access-token"
-#define KEY_USER_AUTH_PROVIDER_CONFIG_CLIENT_ID "client-id"
-#define KEY_USER_AUTH_PROVIDER_CONFIG_CLIENT_SECRET "client-secret"
-#define KEY_USER_AUTH_PROVIDER_CONFIG_CMD_PATH "cmd-path"
-#define KEY_USER_AUTH_PROVIDER_CONFIG_EXPIRES_ON "expires-on"
-#define KEY_USER_AUTH_PROVIDER_CONFIG_EXPIRY "expiry"
-#define KEY_USER_AUTH_PROVIDER_CONFIG_ID_TOKEN "id-token"
-#define KEY_USER_AUTH_PROVIDER_CONFIG_IDP_CERTIFICATE_AUTHORITY_DATA "idp-certificate-authority-data"
-#define KEY_USER_AUTH_PROVIDER_CONFIG_IDP_ISSUE_URL "idp-issuer-url"
-#define KEY_USER_AUTH_PROVIDER_CONFIG_REFRESH_TOKEN "refresh-token"
-#define KEY_CERTIFICATE_AUTHORITY_DATA "certificate-authority-data"
-#define KEY_SERVER "server"
-#define KEY_CLIENT_CERTIFICATE_DATA "client-certificate-data"
-#define KEY_CLIENT_KEY_DATA "client-key-data"
-#define KEY_STAUTS "status"
-#define KEY_TOKEN "token"
-#define KEY_CLIENT_CERTIFICATE_DATA2 "clientCertificateData"
-#define KEY_CLIENT_KEY_DATA2 "clientKeyData"
-
-static int parse_kubeconfig_yaml_string_sequence(char ***p_strings, int *p_strings_count, yaml_document_t * document, yaml_node_t * node)
+static int parse_kubeconfig_yaml_string_sequence(kubeconfig_t * kubeconfig, char ***p_strings, int *p_strings_count, yaml_document_t * document, yaml_node_t * node)
 {
     static char fname[] = "parse_kubeconfig_yaml_string_sequence()";
 
@@ -61,29 +36,35 @@ static int parse_kubeconfig_yaml_string_sequence(char ***p_strings, int *p_strin
     int i = 0;
     int rc = 0;
 
-    for (item = node->data.sequence.items.start, item_count = 0; item < node->data.sequence.items.top; item++, item_count++) {
-        ;
+    /* Like in the other loading modes, items that are not scalars are left out. */
+    for (item = node->data.sequence.items.start, item_count = 0; item < node->data.sequence.items.top; item++) {
+        if (YAML_SCALAR_NODE == yaml_document_get_node(document, *item)->type) {
+            item_count++;
+        }
     }
 
     int strings_count = item_count;
-    char **strings = (char **) calloc(strings_count, sizeof(char *));
+    char **strings = (char **) kubeconfig_alloc(kubeconfig, strings_count * sizeof(char *));
     if (!strings) {
         fprintf(stderr, "%s: Cannot allocate memory for string sequence.\n", fname);
         return -1;
     }
 
-    for (item = node->data.sequence.items.start, i = 0; item < node->data.sequence.items.top; item++, i++) {
+    for (item = node->data.sequence.items.start, i = 0; item < node->data.sequence.items.top; item++) {
         value = yaml_document_get_node(document, *item);
-        strings[i] = strdup(value->data.scalar.value);
+        if (YAML_SCALAR_NODE == value->type) {
+            strings[i++] = kubeconfig_strndup(kubeconfig, (const char *) value->data.scalar.value, value->data.scalar.length);
+        }
     }
 
+    kubeconfig_string_list_release(kubeconfig, *p_strings, *p_strings_count);
     *p_strings = strings;
     *p_strings_count = strings_count;
 
     return 0;
 }
 
-static int parse_kubeconfig_yaml_string_mapping(keyValuePair_t * string_mapping, yaml_document_t * document, yaml_node_t * node)
+static int parse_kubeconfig_yaml_string_mapping(kubeconfig_t * kubeconfig, keyValuePair_t * string_mapping, yaml_document_t * document, yaml_node_t * node)
 {
     static char fname[] = "parse_kubeconfig_yaml_string_mapping()";
 
@@ -91,6 +72,11 @@ static int parse_kubeconfig_yaml_string_mapping(keyValuePair_t * string_mapping,
     yaml_node_t *key = NULL;
     yaml_node_t *value = NULL;
 
+    /* An entry that is not a mapping is an empty pair. */
+    if (YAML_MAPPING_NODE != node->type) {
+        return 0;
+    }
+
     for (pair = node->data.mapping.pairs.start; pair < node->data.mapping.pairs.top; pair++) {
         key = yaml_document_get_node(document, pair->key);
         value = yaml_document_get_node(document, pair->value);
@@ -101,11 +87,14 @@ static int parse_kubeconfig_yaml_string_mapping(keyValuePair_t * string_mapping,
         }
 
         if (value->type == YAML_SCALAR_NODE) {
-            if (0 == strcmp(key->data.scalar.value, KEY_USER_EXEC_ENV_KEY)) {
-                string_mapping->key = strdup(value->data.scalar.value);
-            } else if (0 == strcmp(key->data.scalar.value, KEY_USER_EXEC_ENV_VALUE)) {
-                string_mapping->value = strdup(value->data.scalar.value);
-            } else {
+            switch (kubeconfig_key_lookup((const char *) key->data.scalar.value, key->data.scalar.length)) {
+            case KUBECONFIG_KEY_USER_EXEC_ENV_KEY:
+                string_mapping->key = kubeconfig_strndup(kubeconfig, (const char *) value->data.scalar.value, value->data.scalar.length);
+                break;
+            case KUBECONFIG_KEY_USER_EXEC_ENV_VALUE:
+                string_mapping->value = kubeconfig_strndup(kubeconfig, (const char *) value->data.scalar.value, value->data.scalar.length);
+                break;
+            default:
                 fprintf(stderr, "%s: The key of node is invalid: %s\n", fname, key->data.scalar.value);
                 return -1;
             }
@@ -115,317 +104,2873 @@ static int parse_kubeconfig_yaml_string_mapping(keyValuePair_t * string_mapping,
     return 0;
 }
 
-static int parse_kubeconfig_yaml_string_mapping_sequence(keyValuePair_t *** p_string_mappings, int *p_mappings_count, yaml_document_t * document, yaml_node_t * node)
+static int parse_kubeconfig_yaml_string_mapping_sequence(kubeconfig_t * kubeconfig, keyValuePair_t *** p_string_mappings, int *p_mappings_count, yaml_document_t * document, yaml_node_t * node)
+{
+    static char fname[] = "parse_kubeconfig_yaml_string_mapping_sequence()";
+
+    yaml_node_item_t *item = NULL;
+    yaml_node_t *value = NULL;
+    int item_count = 0;
+    int i = 0;
+    int rc = 0;
+
+    for (item = node->data.sequence.items.start, item_count = 0; item < node->data.sequence.items.top; item++, item_count++) {
+        ;
+    }
+
+    int mappings_count = item_count;
+    keyValuePair_t **string_mappings = (keyValuePair_t **) kubeconfig_alloc(kubeconfig, mappings_count * sizeof(keyValuePair_t *));
+    if (!string_mappings) {
+        fprintf(stderr, "%s: Cannot allocate memory for string mappings.\n", fname);
+        return -1;
+    }
+    for (int j = 0; j < mappings_count; j++) {
+        string_mappings[j] = kubeconfig_alloc(kubeconfig, sizeof(keyValuePair_t));
+        if (!string_mappings[j]) {
+            fprintf(stderr, "%s: Cannot allocate memory for string mapping.\n", fname);
+            return -1;
+        }
+    }
+
+    for (item = node->data.sequence.items.start, i = 0; item < node->data.sequence.items.top; item++, i++) {
+        value = yaml_document_get_node(document, *item);
+
+        rc = parse_kubeconfig_yaml_string_mapping(kubeconfig, string_mappings[i], document, value);
+        if (0 != rc) {
+            fprintf(stderr, "%s: Cannot parse kubeconfig string mapping.\n", fname);
+            return -1;
+        }
+    }
+
+    kubeconfig_string_map_list_release(kubeconfig, *p_string_mappings, *p_mappings_count);
+    *p_string_mappings = string_mappings;
+    *p_mappings_count = mappings_count;
+
+    return 0;
+}
+
+static int parse_kubeconfig_yaml_property_mapping(kubeconfig_t * kubeconfig, kubeconfig_property_t * property, yaml_document_t * document, yaml_node_t * node, const kubeconfig_projection_t * projection)
+{
+    static char fname[] = "parse_kubeconfig_yaml_property_info_mapping()";
+
+    yaml_node_pair_t *pair = NULL;
+    yaml_node_t *key = NULL;
+    yaml_node_t *value = NULL;
+    const kubeconfig_field_t *field = NULL;
+
+    /* An entry that is not a mapping is an empty property. */
+    if (!node || YAML_MAPPING_NODE != node->type) {
+        return 0;
+    }
+
+    for (pair = node->data.mapping.pairs.start; pair < node->data.mapping.pairs.top; pair++) {
+        key = yaml_document_get_node(document, pair->key);
+        value = yaml_document_get_node(document, pair->value);
+
+        if (key->type != YAML_SCALAR_NODE) {
+            fprintf(stderr, "%s: The key node is not YAML_SCALAR_NODE.\n", fname);
+            return -1;
+        }
+
+        field = kubeconfig_projection_field_lookup(projection, property->type, kubeconfig_key_lookup((const char *) key->data.scalar.value, key->data.scalar.length));
+
+        if (KUBECONFIG_FIELD_SKIPPED == field->kind) {
+            continue;
+        } else if (value->type == YAML_SCALAR_NODE) {
+            if (KUBECONFIG_FIELD_STRING == field->kind) {
+                char **p_string = KUBECONFIG_FIELD_MEMBER(property, field->offset, char *);
+                if (*p_string) {
+                    kubeconfig_string_free(kubeconfig, *p_string);
+                }
+                if (field->interned) {
+                    *p_string = kubeconfig_intern(kubeconfig, (const char *) value->data.scalar.value, value->data.scalar.length);
+                } else {
+                    *p_string = kubeconfig_strndup(kubeconfig, (const char *) value->data.scalar.value, value->data.scalar.length);
+                }
+            }
+        } else if (value->type == YAML_MAPPING_NODE) {
+            if (KUBECONFIG_FIELD_SUB_PROPERTY == field->kind) {
+                /* user exec or auth provider */
+                kubeconfig_property_t **p_sub_property = KUBECONFIG_FIELD_MEMBER(property, field->offset, kubeconfig_property_t *);
+                int rc = 0;
+                if (*p_sub_property) {
+                    kubeconfig_property_release(kubeconfig, *p_sub_property);
+                }
+                *p_sub_property = kubeconfig_property_alloc(kubeconfig, field->property_type);
+                if (!*p_sub_property) {
+                    fprintf(stderr, "Cannot allocate memory for kubeconfig %s for user %s.\n", key->data.scalar.value, property->name);
+                    return -1;
+                }
+                rc = parse_kubeconfig_yaml_property_mapping(kubeconfig, *p_sub_property, document, value, projection);
+                if (0 != rc) {
+                    fprintf(stderr, "Cannot parse kubeconfig %s for user %s.\n", key->data.scalar.value, property->name);
+                    return -1;
+                }
+            } else {
+                /* e.g. the 'cluster', 'context' and 'user' mappings fill the property itself */
+                parse_kubeconfig_yaml_property_mapping(kubeconfig, property, document, value, projection);
+            }
+        } else if (value->type == YAML_SEQUENCE_NODE) {
+            if (KUBECONFIG_FIELD_PAIRS == field->kind) {
+                parse_kubeconfig_yaml_string_mapping_sequence(kubeconfig, KUBECONFIG_FIELD_MEMBER(property, field->offset, keyValuePair_t **), KUBECONFIG_FIELD_MEMBER(property, field->count_offset, int), document, value);
+            } else if (KUBECONFIG_FIELD_STRINGS == field->kind) {
+                parse_kubeconfig_yaml_string_sequence(kubeconfig, KUBECONFIG_FIELD_MEMBER(property, field->offset, char **), KUBECONFIG_FIELD_MEMBER(property, field->count_offset, int), document, value);
+            }
+        }
+    }
+
+    return 0;
+}
+
+/*
+ * When contexts are selected, the entries of clusters, contexts and users
+ * that kubeconfig_projection_apply() would remove are not parsed.
+ */
+typedef struct parse_selection_t {
+    const kubeconfig_projection_t *projection;
+    const char *current_context;
+    kubeconfig_references_t references;
+} parse_selection_t;
+
+/* The strings an entry fills its property with. */
+typedef struct parse_entry_strings_t {
+    const char *name;
+    const char *cluster;
+    const char *user;
+} parse_entry_strings_t;
+
+/* The value of the last key in the mapping, or NULL. */
+static yaml_node_t *parse_kubeconfig_yaml_mapping_get(yaml_document_t * document, yaml_node_t * node, kubeconfig_key_t key_id)
+{
+    yaml_node_pair_t *pair = NULL;
+    yaml_node_t *key = NULL;
+    yaml_node_t *value = NULL;
+
+    if (!node || YAML_MAPPING_NODE != node->type) {
+        return NULL;
+    }
+    for (pair = node->data.mapping.pairs.start; pair < node->data.mapping.pairs.top; pair++) {
+        key = yaml_document_get_node(document, pair->key);
+        if (key && YAML_SCALAR_NODE == key->type && key_id == kubeconfig_key_lookup((const char *) key->data.scalar.value, key->data.scalar.length)) {
+            value = yaml_document_get_node(document, pair->value);
+        }
+    }
+    return value;
+}
+
+/* Like parse_kubeconfig_yaml_property_mapping(), a mapping under any key but a sub-property fills the property too. */
+static void parse_kubeconfig_yaml_entry_strings(parse_entry_strings_t * strings, kubeconfig_property_type_t type, yaml_document_t * document, yaml_node_t * node, const kubeconfig_projection_t * projection)
+{
+    yaml_node_pair_t *pair = NULL;
+    yaml_node_t *key = NULL;
+    yaml_node_t *value = NULL;
+    const kubeconfig_field_t *field = NULL;
+    kubeconfig_key_t key_id = KUBECONFIG_KEY_UNKNOWN;
+
+    if (!node || YAML_MAPPING_NODE != node->type) {
+        return;
+    }
+    for (pair = node->data.mapping.pairs.start; pair < node->data.mapping.pairs.top; pair++) {
+        key = yaml_document_get_node(document, pair->key);
+        value = yaml_document_get_node(document, pair->value);
+        if (!key || !value || YAML_SCALAR_NODE != key->type) {
+            return;
+        }
+
+        key_id = kubeconfig_key_lookup((const char *) key->data.scalar.value, key->data.scalar.length);
+        field = kubeconfig_projection_field_lookup(projection, type, key_id);
+        if (KUBECONFIG_FIELD_SKIPPED == field->kind) {
+            continue;
+        } else if (YAML_SCALAR_NODE == value->type && KUBECONFIG_FIELD_STRING == field->kind) {
+            if (KUBECONFIG_KEY_NAME == key_id) {
+                strings->name = (const char *) value->data.scalar.value;
+            } else if (KUBECONFIG_KEY_CLUSTER == key_id) {
+                strings->cluster = (const char *) value->data.scalar.value;
+            } else if (KUBECONFIG_KEY_USER == key_id) {
+                strings->user = (const char *) value->data.scalar.value;
+            }
+        } else if (YAML_MAPPING_NODE == value->type && KUBECONFIG_FIELD_SUB_PROPERTY != field->kind) {
+            parse_kubeconfig_yaml_entry_strings(strings, type, document, value, projection);
+        }
+    }
+}
+
+static int parse_kubeconfig_yaml_selection(parse_selection_t * selection, const kubeconfig_t * loaded, yaml_document_t * document, yaml_node_t * node, const kubeconfig_projection_t * projection)
+{
+    yaml_node_item_t *item = NULL;
+    yaml_node_t *contexts = NULL;
+    yaml_node_t *current_context = NULL;
+    parse_entry_strings_t strings;
+    int rc = 0;
+
+    memset(selection, 0, sizeof(parse_selection_t));
+    selection->projection = projection;
+    if (!projection || !projection->select) {
+        return 0;
+    }
+
+    current_context = parse_kubeconfig_yaml_mapping_get(document, node, KUBECONFIG_KEY_CURRENT_CONTEXT);
+    if (current_context && YAML_SCALAR_NODE == current_context->type) {
+        selection->current_context = (const char *) current_context->data.scalar.value;
+    } else {
+        selection->current_context = loaded->current_context;
+    }
+
+    /* The contexts of a previous load stay if the document has none. */
+    for (int i = 0; i < loaded->contexts_count && 0 == rc; i++) {
+        if (kubeconfig_projection_has_context(projection, selection->current_context, loaded->contexts[i]->name)) {
+            rc = kubeconfig_references_add(&selection->references, loaded->contexts[i]->cluster, loaded->contexts[i]->user);
+        }
+    }
+
+    contexts = parse_kubeconfig_yaml_mapping_get(document, node, KUBECONFIG_KEY_CONTEXTS);
+    if (!contexts || YAML_SEQUENCE_NODE != contexts->type) {
+        return rc;
+    }
+
+    for (item = contexts->data.sequence.items.start; item < contexts->data.sequence.items.top && 0 == rc; item++) {
+        memset(&strings, 0, sizeof(strings));
+        parse_kubeconfig_yaml_entry_strings(&strings, KUBECONFIG_PROPERTY_TYPE_CONTEXT, document, yaml_document_get_node(document, *item), projection);
+        if (kubeconfig_projection_has_context(projection, selection->current_context, strings.name)) {
+            rc = kubeconfig_references_add(&selection->references, strings.cluster, strings.user);
+        }
+    }
+
+    return rc;
+}
+
+static int parse_kubeconfig_yaml_selected(const parse_selection_t * selection, kubeconfig_property_type_t type, yaml_document_t * document, yaml_node_t * entry)
+{
+    parse_entry_strings_t strings;
+
+    /* An entry that is not a mapping is parsed for its error. */
+    if (!selection->projection || !selection->projection->select || !entry || YAML_MAPPING_NODE != entry->type) {
+        return 1;
+    }
+
+    memset(&strings, 0, sizeof(strings));
+    parse_kubeconfig_yaml_entry_strings(&strings, type, document, entry, selection->projection);
+
+    switch (type) {
+    case KUBECONFIG_PROPERTY_TYPE_CONTEXT:
+        return kubeconfig_projection_has_context(selection->projection, selection->current_context, strings.name);
+    case KUBECONFIG_PROPERTY_TYPE_CLUSTER:
+        return kubeconfig_references_has(selection->references.clusters, selection->references.clusters_count, strings.name);
+    case KUBECONFIG_PROPERTY_TYPE_USER:
+        return kubeconfig_references_has(selection->references.users, selection->references.users_count, strings.name);
+    default:
+        return 1;
+    }
+}
+
+static int parse_kubeconfig_yaml_property_sequence(kubeconfig_t * kubeconfig, kubeconfig_property_t *** p_properties, int *p_properties_count, kubeconfig_property_type_t type, yaml_document_t * document, yaml_node_t * node, const parse_selection_t * selection)
+{
+    yaml_node_item_t *item = NULL;
+    yaml_node_t *value = NULL;
+    int item_count = 0;
+    int i = 0;
+    int rc = 0;
+
+    // Get the count of data (e.g. cluster, context, user, user_exec )
+    for (item = node->data.sequence.items.start, item_count = 0; item < node->data.sequence.items.top; item++) {
+        if (parse_kubeconfig_yaml_selected(selection, type, document, yaml_document_get_node(document, *item))) {
+            item_count++;
+        }
+    }
+
+    int properties_count = item_count;
+    kubeconfig_property_t **properties = kubeconfig_properties_alloc(kubeconfig, properties_count, type);
+    if (!properties) {
+        fprintf(stderr, "Cannot allocate memory for kubeconfig properties.\n");
+        return -1;
+    }
+
+    for (item = node->data.sequence.items.start, i = 0; item < node->data.sequence.items.top; item++) {
+        value = yaml_document_get_node(document, *item);
+        if (!parse_kubeconfig_yaml_selected(selection, type, document, value)) {
+            continue;
+        }
+        rc = parse_kubeconfig_yaml_property_mapping(kubeconfig, properties[i], document, value, selection->projection);
+        if (0 != rc) {
+            fprintf(stderr, "Cannot parse kubeconfig properties.\n");
+            kubeconfig_properties_release(kubeconfig, properties, properties_count);
+            return -1;
+        }
+        i++;
+    }
+
+    /* A later document replaces the properties of an earlier one. */
+    if (*p_properties) {
+        kubeconfig_properties_release(kubeconfig, *p_properties, *p_properties_count);
+    }
+    *p_properties = properties;
+    *p_properties_count = properties_count;
+
+    return 0;
+
+}
+
+static int parse_kubeconfig_yaml_top_mapping(kubeconfig_t * kubeconfig, const kubeconfig_t * loaded, yaml_document_t * document, yaml_node_t * node, const kubeconfig_projection_t * projection)
+{
+    static char fname[] = "parse_kubeconfig_yaml_top_mapping()";
+    int rc = 0;
+
+    yaml_node_pair_t *pair = NULL;
+    yaml_node_t *key = NULL;
+    yaml_node_t *value = NULL;
+    const kubeconfig_field_t *field = NULL;
+    parse_selection_t selection;
+
+    if (0 != parse_kubeconfig_yaml_selection(&selection, loaded, document, node, projection)) {
+        kubeconfig_references_clear(&selection.references);
+        return -1;
+    }
+
+    for (pair = node->data.mapping.pairs.start; pair < node->data.mapping.pairs.top; pair++) {
+        key = yaml_document_get_node(document, pair->key);
+        value = yaml_document_get_node(document, pair->value);
+
+        if (key->type != YAML_SCALAR_NODE) {
+            fprintf(stderr, "%s: The key node is not YAML_SCALAR_NODE.\n", fname);
+            rc = -1;
+            break;
+        }
+
+        field = kubeconfig_top_field_lookup(kubeconfig_key_lookup((const char *) key->data.scalar.value, key->data.scalar.length));
+
+        if (value->type == YAML_SCALAR_NODE) {
+            if (KUBECONFIG_FIELD_STRING == field->kind) {
+                char **p_string = KUBECONFIG_FIELD_MEMBER(kubeconfig, field->offset, char *);
+                if (*p_string) {
+                    kubeconfig_string_free(kubeconfig, *p_string);
+                }
+                if (field->interned) {
+                    *p_string = kubeconfig_intern(kubeconfig, (const char *) value->data.scalar.value, value->data.scalar.length);
+                } else {
+                    *p_string = kubeconfig_strndup(kubeconfig, (const char *) value->data.scalar.value, value->data.scalar.length);
+                }
+            }
+        } else {
+            if (KUBECONFIG_FIELD_PROPERTIES == field->kind) {
+                /* clusters, contexts or users */
+                rc = parse_kubeconfig_yaml_property_sequence(kubeconfig, KUBECONFIG_FIELD_MEMBER(kubeconfig, field->offset, kubeconfig_property_t **), KUBECONFIG_FIELD_MEMBER(kubeconfig, field->count_offset, int), field->property_type, document, value, &selection);
+            }
+        }
+    }
+
+    kubeconfig_references_clear(&selection.references);
+    return rc;
+}
+
+static int parse_kubeconfig_yaml_node(kubeconfig_t * kubeconfig, const kubeconfig_t * loaded, yaml_document_t * document, yaml_node_t * node, const kubeconfig_projection_t * projection)
+{
+    static char fname[] = "parse_kubeconfig_yaml_node()";
+    int rc = 0;
+
+    if (YAML_MAPPING_NODE == node->type) {
+        rc = parse_kubeconfig_yaml_top_mapping(kubeconfig, loaded, document, node, projection);
+    } else {
+        fprintf(stderr, "%s: %s is not a valid kubeconfig file.\n", fname, loaded->fileName ? loaded->fileName : "The input");
+        rc = -1;
+    }
+
+    return rc;
+}
+
+static int parse_kubeconfig_yaml_document(kubeconfig_t * kubeconfig, const kubeconfig_t * loaded, yaml_document_t * document, const kubeconfig_projection_t * projection)
+{
+    static char fname[] = "parse_kubeconfig_yaml_document()";
+    int rc = 0;
+
+    yaml_node_t *root;
+    root = yaml_document_get_root_node(document);
+    if (NULL == root) {
+        fprintf(stderr, "%s: The document is null\n", fname);
+        return -1;
+    }
+
+    rc = parse_kubeconfig_yaml_node(kubeconfig, loaded, document, root, projection);
+
+    return rc;
+}
+
+/*
+ * A kubeconfig to scan into before kubeconfig, with an arena of its own if
+ * kubeconfig has one. It interns in the table of strings of kubeconfig.
+ */
+static kubeconfig_t *scanned_kubeconfig_create(kubeconfig_t * kubeconfig)
+{
+    kubeconfig_t *scanned = kubeconfig_create();
+
+    if (scanned) {
+        scanned->strings = kubeconfig_strings_ref(kubeconfig->strings);
+    }
+    if (scanned && kubeconfig->arena) {
+        scanned->arena = kubeconfig_arena_create();
+        if (!scanned->arena) {
+            kubeconfig_free(scanned);
+            return NULL;
+        }
+    }
+    return scanned;
+}
+
+/* Once entries of from are moved into kubeconfig, they are freed with the arena of kubeconfig. */
+static void move_kubeconfig_arena(kubeconfig_t * kubeconfig, kubeconfig_t * from)
+{
+    if (kubeconfig->arena) {
+        kubeconfig_arena_merge(kubeconfig->arena, from->arena);
+    }
+}
+
+static void move_kubeconfig_string(kubeconfig_t * kubeconfig, char **to, char **from)
+{
+    if (*from) {
+        if (*to) {
+            kubeconfig_string_free(kubeconfig, *to);
+        }
+        *to = *from;
+        *from = NULL;
+    }
+}
+
+static void move_kubeconfig_properties(kubeconfig_t * kubeconfig, kubeconfig_property_t *** to, int *to_count, kubeconfig_property_t *** from, int *from_count)
+{
+    if (*from) {
+        if (*to) {
+            kubeconfig_properties_release(kubeconfig, *to, *to_count);
+        }
+        *to = *from;
+        *to_count = *from_count;
+        *from = NULL;
+        *from_count = 0;
+    }
+}
+
+/* Move what was loaded into from over the fields of kubeconfig. */
+static void move_kubeconfig(kubeconfig_t * kubeconfig, kubeconfig_t * from)
+{
+    move_kubeconfig_string(kubeconfig, &kubeconfig->apiVersion, &from->apiVersion);
+    move_kubeconfig_string(kubeconfig, &kubeconfig->kind, &from->kind);
+    move_kubeconfig_string(kubeconfig, &kubeconfig->current_context, &from->current_context);
+    move_kubeconfig_properties(kubeconfig, &kubeconfig->clusters, &kubeconfig->clusters_count, &from->clusters, &from->clusters_count);
+    move_kubeconfig_properties(kubeconfig, &kubeconfig->contexts, &kubeconfig->contexts_count, &from->contexts, &from->contexts_count);
+    move_kubeconfig_properties(kubeconfig, &kubeconfig->users, &kubeconfig->users_count, &from->users, &from->users_count);
+    move_kubeconfig_arena(kubeconfig, from);
+}
+
+/*
+ * A document is parsed into a kubeconfig of its own and moved over
+ * kubeconfig once all of it is parsed, like with the events loader: a
+ * document that is not a kubeconfig fails the load and leaves kubeconfig
+ * as the documents before it loaded it.
+ */
+static int load_kubeconfig_yaml_document_tree(kubeconfig_t * kubeconfig, yaml_parser_t * parser, const kubeconfig_projection_t * projection)
+{
+    static char fname[] = "load_kubeconfig_yaml_document_tree()";
+
+    yaml_document_t documents[2];
+    kubeconfig_projection_t fields;
+    kubeconfig_t *parsed = NULL;
+    int current = 0;
+    int more = 0;
+    int failed = 0;
+    int rc = 0;
+
+    /*
+     * A later document can replace the contexts a document is selected by,
+     * so only the last document is selected while it is parsed. The
+     * documents before it only skip fields.
+     */
+    if (projection) {
+        fields = *projection;
+        fields.select = 0;
+    }
+
+    if (!yaml_parser_load(parser, &documents[current])) {
+        return -1;
+    }
+
+    while (yaml_document_get_root_node(&documents[current])) {
+
+        /* The documents before an error are still loaded. */
+        failed = !yaml_parser_load(parser, &documents[!current]);
+        more = failed || (NULL != yaml_document_get_root_node(&documents[!current]));
+
+        parsed = scanned_kubeconfig_create(kubeconfig);
+        if (!parsed) {
+            fprintf(stderr, "%s: Cannot allocate memory for the document.\n", fname);
+            rc = -1;
+        } else {
+            rc = parse_kubeconfig_yaml_document(parsed, kubeconfig, &documents[current], (projection && more) ? &fields : projection);
+            if (0 == rc) {
+                move_kubeconfig(kubeconfig, parsed);
+            }
+            kubeconfig_free(parsed);
+        }
+
+        yaml_document_delete(&documents[current]);
+        if (failed || 0 != rc) {
+            if (!failed) {
+                yaml_document_delete(&documents[!current]);
+            }
+            return -1;
+        }
+        current = !current;
+    }
+
+    yaml_document_delete(&documents[current]);
+    return 0;
+}
+
+/*
+ * Like the tree loader, a document is only loaded into kubeconfig once all
+ * of it is parsed: it is built into a kubeconfig of its own and moved over
+ * at its end, so a parse error leaves kubeconfig as the documents before
+ * the error loaded it.
+ */
+static int load_kubeconfig_yaml_events(kubeconfig_t * kubeconfig, yaml_parser_t * parser, const kubeconfig_projection_t * projection)
+{
+    static char fname[] = "load_kubeconfig_yaml_events()";
+
+    kubeconfig_builder_t builder;
+    kubeconfig_t *document = NULL;
+    yaml_event_t event;
+
+    int done = 0;
+    int rc = 0;
+
+    while (!done && 0 == rc) {
+
+        if (!yaml_parser_parse(parser, &event)) {
+            rc = -1;
+            break;
+        }
+
+        switch (event.type) {
+        case YAML_STREAM_END_EVENT:
+            done = 1;
+            break;
+        case YAML_DOCUMENT_START_EVENT:
+            document = scanned_kubeconfig_create(kubeconfig);
+            if (!document) {
+                fprintf(stderr, "%s: Cannot allocate memory for the document.\n", fname);
+                rc = -1;
+                break;
+            }
+            kubeconfig_builder_init(&builder, document);
+            builder.projection = projection;
+            break;
+        case YAML_DOCUMENT_END_EVENT:
+            kubeconfig_builder_clear(&builder);
+            move_kubeconfig(kubeconfig, document);
+            kubeconfig_free(document);
+            document = NULL;
+            break;
+        case YAML_MAPPING_START_EVENT:
+            rc = kubeconfig_builder_mapping_start(&builder);
+            break;
+        case YAML_MAPPING_END_EVENT:
+            rc = kubeconfig_builder_mapping_end(&builder);
+            break;
+        case YAML_SEQUENCE_START_EVENT:
+            rc = kubeconfig_builder_sequence_start(&builder);
+            break;
+        case YAML_SEQUENCE_END_EVENT:
+            rc = kubeconfig_builder_sequence_end(&builder);
+            break;
+        case YAML_SCALAR_EVENT:
+            /*
+             * The builder takes over the scalar libyaml allocated with the C library instead of copying it again,
+             * unless the kubeconfig uses an arena or the allocator hooks: the scalar is then copied into their memory.
+             */
+            rc = kubeconfig_builder_scalar(&builder, (const char *) event.data.scalar.value, event.data.scalar.length, (kubeconfig->arena || kubeyaml_has_allocator()) ? NULL : (char **) &(event.data.scalar.value));
+            break;
+        case YAML_ALIAS_EVENT:
+            fprintf(stderr, "%s: Aliases are not supported when loading from parser events.\n", fname);
+            rc = -1;
+            break;
+        default:
+            break;
+        }
+
+        yaml_event_delete(&event);
+
+    }
+
+    if (document) {
+        kubeconfig_builder_clear(&builder);
+        /* The handler of kubeyaml_foreach() stopped, what the document set until then stays. */
+        if (KUBECONFIG_BUILDER_STOPPED == rc) {
+            move_kubeconfig(kubeconfig, document);
+        }
+        kubeconfig_free(document);
+    }
+    return rc;
+}
+
+static int load_kubeconfig_yaml_parser(kubeconfig_t * kubeconfig, yaml_parser_t * parser, unsigned int flags, const kubeconfig_projection_t * projection)
+{
+    if (flags & KUBEYAML_LOAD_EVENTS) {
+        return load_kubeconfig_yaml_events(kubeconfig, parser, projection);
+    }
+    return load_kubeconfig_yaml_document_tree(kubeconfig, parser, projection);
+}
+
+/*
+ * Fast path
+ *
+ * kubectl writes kubeconfigs in a small subset of YAML: block mappings and
+ * sequences, single-line plain or quoted scalars, comments and the empty
+ * flow collections {} and []. load_kubeconfig_fast_path() recognizes this
+ * subset line by line and feeds the kubeconfig builder directly, without
+ * going through libyaml.
+ *
+ * As soon as the input leaves the subset (anchors, aliases, tags, block
+ * scalars, multi-line scalars, flow collections, directives, several
+ * documents, tabs in indentation, non-ASCII text ...) it returns
+ * FAST_PATH_UNSUPPORTED and the caller loads the input again with libyaml,
+ * so the result and the errors are the same as without the fast path.
+ */
+
+#define FAST_PATH_UNSUPPORTED KUBECONFIG_SCALAR_UNSUPPORTED
+#define FAST_PATH_MAX_LEVELS 64
+
+typedef struct fast_path_level_t {
+    int indent;
+    int is_sequence;
+} fast_path_level_t;
+
+typedef struct fast_path_t {
+    kubeconfig_builder_t builder;
+    fast_path_level_t levels[FAST_PATH_MAX_LEVELS];
+    int levels_count;
+    int pending;                /* the last key or sequence entry waits for a value on the next lines */
+    int has_root;
+    int has_document_start;
+    const char *line;
+    char *scratch;              /* unescaped text of quoted scalars */
+    size_t scratch_size;
+    char *views;                /* writable input of a zero-copy load */
+    size_t views_length;
+    size_t *terminators;        /* offsets of the NUL terminators of the views */
+    size_t terminators_count;
+    size_t terminators_capacity;
+    kubeyaml_index_entry_t *skips;      /* entries left out by the projection, by offset */
+    int skips_count;
+} fast_path_t;
+
+static int fast_path_scalar_event(fast_path_t * fp, const char *value, size_t length)
+{
+    return kubeconfig_builder_scalar(&fp->builder, value, length, NULL) ? FAST_PATH_UNSUPPORTED : 0;
+}
+
+/*
+ * In a zero-copy load a plain value is passed to the builder as a view into
+ * the input. Its terminator, the blank or line break after it, is only
+ * written once the whole input is scanned, a fallback to libyaml must read
+ * the original text.
+ */
+static int fast_path_value_event(fast_path_t * fp, const char *value, size_t length)
+{
+    size_t offset = 0;
+    size_t *terminators = NULL;
+    char *view = NULL;
+
+    /* Quoted values are unescaped into the scratch buffer, a value ending the input has no byte left for its terminator. */
+    if (!fp->views || value == fp->scratch || (size_t) (value - fp->views) + length >= fp->views_length) {
+        return fast_path_scalar_event(fp, value, length);
+    }
+
+    offset = (size_t) (value - fp->views);
+    view = fp->views + offset;
+    if (kubeconfig_builder_scalar(&fp->builder, view, length, &view)) {
+        return FAST_PATH_UNSUPPORTED;
+    }
+    if (view) {
+        return 0;               /* not a field of the kubeconfig */
+    }
+
+    if (fp->terminators_count == fp->terminators_capacity) {
+        size_t capacity = fp->terminators_capacity ? fp->terminators_capacity * 2 : 64;
+        terminators = kubeyaml_realloc(fp->terminators, capacity * sizeof(size_t));
+        if (!terminators) {
+            return FAST_PATH_UNSUPPORTED;
+        }
+        fp->terminators = terminators;
+        fp->terminators_capacity = capacity;
+    }
+    fp->terminators[fp->terminators_count++] = offset + length;
+
+    return 0;
+}
+
+static int fast_path_open(fast_path_t * fp, int indent, int is_sequence)
+{
+    if (fp->levels_count == FAST_PATH_MAX_LEVELS) {
+        return FAST_PATH_UNSUPPORTED;
+    }
+    fp->levels[fp->levels_count].indent = indent;
+    fp->levels[fp->levels_count].is_sequence = is_sequence;
+    fp->levels_count++;
+
+    if (is_sequence) {
+        return kubeconfig_builder_sequence_start(&fp->builder) ? FAST_PATH_UNSUPPORTED : 0;
+    }
+    return kubeconfig_builder_mapping_start(&fp->builder) ? FAST_PATH_UNSUPPORTED : 0;
+}
+
+static int fast_path_close(fast_path_t * fp)
+{
+    int rc = 0;
+
+    /* A key or an entry without value on the following lines is null, libyaml reports it as an empty scalar. */
+    if (fp->pending) {
+        fp->pending = 0;
+        rc = fast_path_scalar_event(fp, "", 0);
+        if (rc) {
+            return rc;
+        }
+    }
+
+    fp->levels_count--;
+    if (fp->levels[fp->levels_count].is_sequence) {
+        return kubeconfig_builder_sequence_end(&fp->builder) ? FAST_PATH_UNSUPPORTED : 0;
+    }
+    return kubeconfig_builder_mapping_end(&fp->builder) ? FAST_PATH_UNSUPPORTED : 0;
+}
+
+static int fast_path_flush(fast_path_t * fp)
+{
+    if (fp->pending) {
+        fp->pending = 0;
+        return fast_path_scalar_event(fp, "", 0);
+    }
+    return 0;
+}
+
+static int fast_path_scalar(fast_path_t * fp, const char *p, const char *eol, const char **value, size_t *length, const char **next)
+{
+    /* The unescaped text of a quoted scalar is never longer than the quoted one. */
+    if (fp->scratch_size < (size_t) (eol - p)) {
+        char *scratch = kubeyaml_realloc(fp->scratch, (size_t) (eol - p));
+        if (!scratch) {
+            return FAST_PATH_UNSUPPORTED;
+        }
+        fp->scratch = scratch;
+        fp->scratch_size = (size_t) (eol - p);
+    }
+    return kubeconfig_scalar_scan(p, eol, fp->scratch, value, length, next);
+}
+
+/* {} and [] are the only flow collections kubectl writes. */
+static int fast_path_empty_collection(fast_path_t * fp, const char *p, const char *eol)
+{
+    char close = ('{' == *p) ? '}' : ']';
+    const char *q = p + 1;
+    int rc = 0;
+
+    while (q < eol && ' ' == *q) {
+        q++;
+    }
+    if (q == eol || close != *q || !kubeconfig_scalar_rest_is_empty(q + 1, eol)) {
+        return FAST_PATH_UNSUPPORTED;
+    }
+
+    if ('{' == *p) {
+        rc = kubeconfig_builder_mapping_start(&fp->builder) || kubeconfig_builder_mapping_end(&fp->builder);
+    } else {
+        rc = kubeconfig_builder_sequence_start(&fp->builder) || kubeconfig_builder_sequence_end(&fp->builder);
+    }
+    return rc ? FAST_PATH_UNSUPPORTED : 0;
+}
+
+/* The value after "key:" or "-" on the same line, or nothing if it is on the following lines. */
+static int fast_path_value(fast_path_t * fp, const char *p, const char *eol)
+{
+    const char *value = NULL;
+    const char *next = NULL;
+    size_t length = 0;
+    int rc = 0;
+
+    while (p < eol && KUBECONFIG_SCALAR_IS_BLANK(*p)) {
+        p++;
+    }
+    if (p == eol || '#' == *p) {
+        fp->pending = 1;
+        return 0;
+    }
+    if ('{' == *p || '[' == *p) {
+        return fast_path_empty_collection(fp, p, eol);
+    }
+
+    rc = fast_path_scalar(fp, p, eol, &value, &length, &next);
+    if (rc) {
+        return rc;
+    }
+    if (!kubeconfig_scalar_rest_is_empty(next, eol)) {
+        return FAST_PATH_UNSUPPORTED;
+    }
+    return fast_path_value_event(fp, value, length);
+}
+
+/* "key: value", "key:", "- value", "- key: value" or "-" */
+static int fast_path_entry(fast_path_t * fp, const char *p, const char *eol, int is_sequence_entry)
+{
+    const char *value = NULL;
+    const char *next = NULL;
+    size_t length = 0;
+    int rc = 0;
+
+    if (is_sequence_entry) {
+        p++;
+        while (p < eol && ' ' == *p) {
+            p++;
+        }
+        if (p == eol || '#' == *p || '{' == *p || '[' == *p) {
+            return fast_path_value(fp, p, eol);
+        }
+        /* Tabs would make the indentation of a mapping in the entry ambiguous. */
+        if ('\t' == *p || ('-' == *p && (p + 1 == eol || ' ' == p[1]))) {
+            return FAST_PATH_UNSUPPORTED;
+        }
+    }
+
+    rc = fast_path_scalar(fp, p, eol, &value, &length, &next);
+    if (rc) {
+        return rc;
+    }
+
+    if (next == eol || ':' != *next) {
+        /* A scalar is only allowed as a sequence entry, a mapping wants a key here. */
+        if (!is_sequence_entry || !kubeconfig_scalar_rest_is_empty(next, eol)) {
+            return FAST_PATH_UNSUPPORTED;
+        }
+        return fast_path_value_event(fp, value, length);
+    }
+
+    /* "- key: value" starts a mapping inside the sequence entry, its keys are aligned on this one. */
+    if (is_sequence_entry) {
+        rc = fast_path_open(fp, (int) (p - fp->line), 0);
+        if (rc) {
+            return rc;
+        }
+    }
+
+    rc = fast_path_scalar_event(fp, value, length);
+    if (rc) {
+        return rc;
+    }
+    return fast_path_value(fp, next + 1, eol);
+}
+
+/* Close the collections the indentation of the line leaves and open the one it starts. */
+static int fast_path_indent(fast_path_t * fp, int indent, int is_sequence_entry)
+{
+    fast_path_level_t *top = NULL;
+    int rc = 0;
+
+    while (fp->levels_count > 0 && fp->levels[fp->levels_count - 1].indent > indent) {
+        rc = fast_path_close(fp);
+        if (rc) {
+            return rc;
+        }
+    }
+
+    if (0 == fp->levels_count) {
+        /* Only one root collection, a line less indented than the root mapping is not part of it. */
+        if (fp->has_root) {
+            return FAST_PATH_UNSUPPORTED;
+        }
+        fp->has_root = 1;
+        return fast_path_open(fp, indent, is_sequence_entry);
+    }
+
+    top = &fp->levels[fp->levels_count - 1];
+    if (top->indent < indent) {
+        /* A more indented line is the value of the pending key or entry. */
+        if (!fp->pending) {
+            return FAST_PATH_UNSUPPORTED;
+        }
+        fp->pending = 0;
+        return fast_path_open(fp, indent, is_sequence_entry);
+    }
+
+    if (top->is_sequence == is_sequence_entry) {
+        return fast_path_flush(fp);
+    }
+
+    if (top->is_sequence) {
+        /* A key aligned on the "-" ends a sequence written at the level of its parent key. */
+        rc = fast_path_close(fp);
+        if (rc) {
+            return rc;
+        }
+        top = fp->levels_count > 0 ? &fp->levels[fp->levels_count - 1] : NULL;
+        if (!top || top->indent != indent || top->is_sequence) {
+            return FAST_PATH_UNSUPPORTED;
+        }
+        return 0;
+    }
+
+    /* A "-" aligned on the keys starts the sequence value of the pending key. */
+    if (!fp->pending) {
+        return FAST_PATH_UNSUPPORTED;
+    }
+    fp->pending = 0;
+    return fast_path_open(fp, indent, 1);
+}
+
+static int fast_path_line(fast_path_t * fp, const char *line, const char *eol)
+{
+    const char *p = line;
+    int is_sequence_entry = 0;
+    int rc = 0;
+
+    while (p < eol && ' ' == *p) {
+        p++;
+    }
+    if (p == eol || '#' == *p) {
+        return 0;
+    }
+    if ('\t' == *p) {
+        return FAST_PATH_UNSUPPORTED;
+    }
+
+    if (p == line) {
+        if ('%' == *p) {
+            return FAST_PATH_UNSUPPORTED;
+        }
+        if (eol - p >= 3 && (0 == memcmp(p, "---", 3) || 0 == memcmp(p, "...", 3)) && (eol - p == 3 || KUBECONFIG_SCALAR_IS_BLANK(p[3]))) {
+            /* Only the start marker of a single document, with nothing after it on the line. */
+            if ('.' == *p || fp->has_root || fp->has_document_start || !kubeconfig_scalar_rest_is_empty(p + 3, eol)) {
+                return FAST_PATH_UNSUPPORTED;
+            }
+            fp->has_document_start = 1;
+            return 0;
+        }
+    }
+
+    is_sequence_entry = ('-' == *p && (p + 1 == eol || ' ' == p[1]));
+
+    fp->line = line;
+    rc = fast_path_indent(fp, (int) (p - line), is_sequence_entry);
+    if (rc) {
+        return rc;
+    }
+    return fast_path_entry(fp, p, eol, is_sequence_entry);
+}
+
+static int fast_path_scan(fast_path_t * fp, const char *buf, size_t len)
+{
+    const char *p = buf;
+    const char *end = buf + len;
+    const char *eol = NULL;
+    int skip = 0;
+    int rc = 0;
+
+    while (p < end) {
+        if (skip < fp->skips_count && (size_t) (p - buf) == fp->skips[skip].offset) {
+            p += fp->skips[skip++].length;
+            continue;
+        }
+
+        eol = memchr(p, '\n', (size_t) (end - p));
+        if (!eol) {
+            eol = end;
+        }
+
+        rc = fast_path_line(fp, p, (eol > p && '\r' == eol[-1]) ? eol - 1 : eol);
+        if (rc) {
+            return rc;
+        }
+
+        p = eol + 1;
+    }
+
+    while (fp->levels_count > 0) {
+        rc = fast_path_close(fp);
+        if (rc) {
+            return rc;
+        }
+    }
+    return 0;
+}
+
+/*
+ * JSON
+ *
+ * Tools like "kubectl config view -o json" or Terraform write kubeconfigs
+ * as JSON, which libyaml reads as a flow mapping. An input that starts
+ * with '{' is scanned as JSON instead and fed to the same builder, its
+ * structure is given by the brackets and there is no indentation to track.
+ * Strings are unescaped like YAML double-quoted scalars, numbers, true,
+ * false and null are plain scalars, as libyaml reports them. Anything else,
+ * invalid JSON and non-ASCII text included, returns FAST_PATH_UNSUPPORTED
+ * and is left to libyaml.
+ */
+
+typedef enum fast_path_json_state_t {
+    FAST_PATH_JSON_VALUE,       /* a value is expected */
+    FAST_PATH_JSON_KEY,         /* a key is expected */
+    FAST_PATH_JSON_NEXT         /* a ',' or the end of the collection is expected */
+} fast_path_json_state_t;
+
+static const char *fast_path_json_space(const char *p, const char *end)
+{
+    while (p < end && KUBECONFIG_JSON_IS_SPACE(*p)) {
+        p++;
+    }
+    return p;
+}
+
+static int fast_path_is_json(const char *buf, size_t len)
+{
+    const char *p = fast_path_json_space(buf, buf + len);
+
+    return (p < buf + len && '{' == *p);
+}
+
+/* A string without escapes is returned in place, others are unescaped into the scratch buffer. */
+static int fast_path_json_string(fast_path_t * fp, const char *p, const char *end, const char **value, size_t *length, const char **next)
+{
+    int escaped = 0;
+    const char *q = kubeconfig_json_string_end(p, end, &escaped);
+
+    if (!q) {
+        return FAST_PATH_UNSUPPORTED;
+    }
+
+    if (!escaped) {
+        *value = p + 1;
+        *length = (size_t) (q - p - 1);
+        *next = q + 1;
+        return 0;
+    }
+    return fast_path_scalar(fp, p, q + 1, value, length, next);
+}
+
+/* true, false, null or a number. */
+static int fast_path_json_literal(const char *p, const char *end, const char **next)
+{
+    *next = kubeconfig_json_literal_end(p, end);
+    return *next ? 0 : FAST_PATH_UNSUPPORTED;
+}
+
+static int fast_path_json_value(fast_path_t * fp, const char *p, const char *end, const char **next)
+{
+    const char *value = NULL;
+    size_t length = 0;
+    int rc = 0;
+
+    if ('"' == *p) {
+        rc = fast_path_json_string(fp, p, end, &value, &length, next);
+    } else {
+        rc = fast_path_json_literal(p, end, next);
+        value = p;
+        length = (size_t) (*next - p);
+    }
+    if (rc) {
+        return rc;
+    }
+    return fast_path_value_event(fp, value, length);
+}
+
+static int fast_path_json_scan(fast_path_t * fp, const char *buf, size_t len)
+{
+    const char *p = buf;
+    const char *end = buf + len;
+    const char *value = NULL;
+    size_t length = 0;
+    fast_path_json_state_t state = FAST_PATH_JSON_VALUE;
+    int is_sequence = 0;
+    int empty = 0;              /* the collection was just opened */
+    int opened = 0;
+    int rc = 0;
+
+    while (0 == rc) {
+        p = fast_path_json_space(p, end);
+        if (FAST_PATH_JSON_NEXT == state && 0 == fp->levels_count) {
+            /* Only blanks may follow the top object. */
+            return (p == end) ? 0 : FAST_PATH_UNSUPPORTED;
+        }
+        if (p == end) {
+            return FAST_PATH_UNSUPPORTED;
+        }
+        is_sequence = fp->levels_count ? fp->levels[fp->levels_count - 1].is_sequence : 0;
+        opened = 0;
+
+        switch (state) {
+        case FAST_PATH_JSON_VALUE:
+            if (empty && ']' == *p) {
+                rc = fast_path_close(fp);
+                p++;
+                state = FAST_PATH_JSON_NEXT;
+            } else if ('{' == *p || '[' == *p) {
+                rc = fast_path_open(fp, 0, '[' == *p);
+                state = ('{' == *p) ? FAST_PATH_JSON_KEY : FAST_PATH_JSON_VALUE;
+                opened = 1;
+                p++;
+            } else {
+                rc = fast_path_json_value(fp, p, end, &p);
+                state = FAST_PATH_JSON_NEXT;
+            }
+            break;
+        case FAST_PATH_JSON_KEY:
+            if (empty && '}' == *p) {
+                rc = fast_path_close(fp);
+                p++;
+                state = FAST_PATH_JSON_NEXT;
+                break;
+            }
+            if ('"' != *p) {
+                return FAST_PATH_UNSUPPORTED;
+            }
+            rc = fast_path_json_string(fp, p, end, &value, &length, &p);
+            if (0 == rc) {
+                rc = fast_path_scalar_event(fp, value, length);
+            }
+            if (rc) {
+                return rc;
+            }
+            p = fast_path_json_space(p, end);
+            if (p == end || ':' != *p) {
+                return FAST_PATH_UNSUPPORTED;
+            }
+            p++;
+            state = FAST_PATH_JSON_VALUE;
+            break;
+        case FAST_PATH_JSON_NEXT:
+            if (',' == *p) {
+                state = is_sequence ? FAST_PATH_JSON_VALUE : FAST_PATH_JSON_KEY;
+            } else if ((is_sequence ? ']' : '}') == *p) {
+                rc = fast_path_close(fp);
+            } else {
+                return FAST_PATH_UNSUPPORTED;
+            }
+            p++;
+            break;
+        }
+        empty = opened;
+    }
+
+    return rc;
+}
+
+static int fast_path_skip_compare(const void *a, const void *b)
+{
+    const kubeyaml_index_entry_t *x = a;
+    const kubeyaml_index_entry_t *y = b;
+
+    return (x->offset > y->offset) - (x->offset < y->offset);
+}
+
+static int fast_path_skip(fast_path_t * fp, const kubeyaml_index_entry_t * entry)
+{
+    kubeyaml_index_entry_t *skips = kubeyaml_realloc(fp->skips, (fp->skips_count + 1) * sizeof(kubeyaml_index_entry_t));
+    if (!skips) {
+        return -1;
+    }
+    fp->skips = skips;
+    fp->skips[fp->skips_count++] = *entry;
+    return 0;
+}
+
+/* Whether one of the names an entry may get is selected. */
+static int fast_path_selected(kubeconfig_property_type_t type, char *const *names, int names_count, const kubeconfig_projection_t * projection, const char *current_context, const kubeconfig_references_t * references)
+{
+    for (int i = 0; i < names_count; i++) {
+        if (KUBECONFIG_PROPERTY_TYPE_CONTEXT == type && kubeconfig_projection_has_context(projection, current_context, names[i])) {
+            return 1;
+        } else if (KUBECONFIG_PROPERTY_TYPE_CLUSTER == type && kubeconfig_references_has(references->clusters, references->clusters_count, names[i])) {
+            return 1;
+        } else if (KUBECONFIG_PROPERTY_TYPE_USER == type && kubeconfig_references_has(references->users, references->users_count, names[i])) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+static int fast_path_select_references(kubeyaml_index_t * index, const kubeyaml_index_entry_t * entry, kubeconfig_references_t * references)
+{
+    char **clusters = NULL;
+    char **users = NULL;
+    int clusters_count = 0;
+    int users_count = 0;
+    int rc = 0;
+
+    rc = kubeyaml_index_entry_get_strings(index, entry, KEY_CLUSTER, &clusters, &clusters_count);
+    if (0 == rc) {
+        rc = kubeyaml_index_entry_get_strings(index, entry, KEY_USER, &users, &users_count);
+    }
+    for (int i = 0; i < clusters_count && 0 == rc; i++) {
+        rc = kubeconfig_references_add(references, clusters[i], NULL);
+    }
+    for (int i = 0; i < users_count && 0 == rc; i++) {
+        rc = kubeconfig_references_add(references, NULL, users[i]);
+    }
+
+    kubeconfig_free_string_list(clusters, clusters_count);
+    kubeconfig_free_string_list(users, users_count);
+    return rc;
+}
+
+/*
+ * Skip the entries at path none of whose names is selected, and add the
+ * references of the contexts that are kept.
+ */
+static int fast_path_select_entries(fast_path_t * fp, kubeyaml_index_t * index, const char *path, kubeconfig_property_type_t type, const kubeconfig_projection_t * projection, const char *current_context, kubeconfig_references_t * references)
+{
+    kubeyaml_index_entry_t *entries = NULL;
+    char **names = NULL;
+    int entries_count = 0;
+    int names_count = 0;
+    int rc = 0;
+
+    rc = kubeyaml_index_get_entries(index, path, &entries, &entries_count);
+    for (int i = 0; i < entries_count && 0 == rc; i++) {
+        rc = kubeyaml_index_entry_get_strings(index, &entries[i], KEY_NAME, &names, &names_count);
+        if (0 != rc) {
+            break;
+        }
+        if (!fast_path_selected(type, names, names_count, projection, current_context, references)) {
+            rc = fast_path_skip(fp, &entries[i]);
+        } else if (KUBECONFIG_PROPERTY_TYPE_CONTEXT == type) {
+            rc = fast_path_select_references(index, &entries[i], references);
+        }
+        kubeconfig_free_string_list(names, names_count);
+        names = NULL;
+        names_count = 0;
+    }
+
+    kubeyaml_free(entries);
+    return rc;
+}
+
+/*
+ * When contexts are selected, the index of the input tells which entries of
+ * clusters, contexts and users kubeconfig_projection_apply() would remove,
+ * and the scan jumps over their lines. The loader fills an entry from every
+ * mapping nested in it, so an entry is kept when any of the names it may
+ * get is selected, and a context refers to all the clusters and users it
+ * may get. A failure here only means that nothing is skipped.
+ */
+static void fast_path_select(fast_path_t * fp, kubeconfig_t * kubeconfig, const char *buf, size_t len, const kubeconfig_projection_t * projection)
+{
+    kubeyaml_index_t *index = NULL;
+    kubeconfig_references_t references;
+    char *current_context = NULL;
+    const char *selected_context = NULL;
+    int rc = 0;
+
+    index = kubeyaml_index_try_create(buf, len);
+    if (!index) {
+        return;
+    }
+    memset(&references, 0, sizeof(references));
+
+    rc = kubeyaml_index_get_string(index, KEY_CURRENT_CONTEXT, &current_context);
+    selected_context = current_context ? current_context : kubeconfig->current_context;
+
+    /* The contexts of a previous load stay if the input has none. */
+    for (int i = 0; i < kubeconfig->contexts_count && 0 == rc; i++) {
+        if (kubeconfig_projection_has_context(projection, selected_context, kubeconfig->contexts[i]->name)) {
+            rc = kubeconfig_references_add(&references, kubeconfig->contexts[i]->cluster, kubeconfig->contexts[i]->user);
+        }
+    }
+
+    if (0 == rc) {
+        rc = fast_path_select_entries(fp, index, KEY_CONTEXTS, KUBECONFIG_PROPERTY_TYPE_CONTEXT, projection, selected_context, &references);
+    }
+    if (0 == rc) {
+        rc = fast_path_select_entries(fp, index, KEY_CLUSTERS, KUBECONFIG_PROPERTY_TYPE_CLUSTER, projection, selected_context, &references);
+    }
+    if (0 == rc) {
+        rc = fast_path_select_entries(fp, index, KEY_USERS, KUBECONFIG_PROPERTY_TYPE_USER, projection, selected_context, &references);
+    }
+
+    if (0 == rc && fp->skips) {
+        qsort(fp->skips, fp->skips_count, sizeof(kubeyaml_index_entry_t), fast_path_skip_compare);
+    } else if (0 != rc) {
+        kubeyaml_free(fp->skips);
+        fp->skips = NULL;
+        fp->skips_count = 0;
+    }
+
+    kubeconfig_references_clear(&references);
+    kubeyaml_free(current_context);
+    kubeyaml_index_free(index);
+}
+
+/*
+ * Context
+ *
+ * A context keeps the scratch buffers of the fast path and the JSON parser
+ * between loads. The libyaml parser is initialized and deleted by each
+ * load, libyaml has no call to reuse one.
+ */
+
+struct kubeyaml_context_t {
+    char *scratch;              /* unescaped text of quoted scalars and JSON strings */
+    size_t scratch_size;
+    size_t *terminators;        /* NUL terminators of a zero-copy load */
+    size_t terminators_capacity;
+};
+
+kubeyaml_context_t *kubeyaml_context_create(void)
+{
+    static char fname[] = "kubeyaml_context_create()";
+
+    kubeyaml_context_t *context = kubeyaml_calloc(1, sizeof(kubeyaml_context_t));
+    if (!context) {
+        fprintf(stderr, "%s: Cannot allocate memory for the context.\n", fname);
+        return NULL;
+    }
+    return context;
+}
+
+void kubeyaml_context_free(kubeyaml_context_t * context)
+{
+    if (!context) {
+        return;
+    }
+    if (context->scratch) {
+        kubeyaml_free(context->scratch);
+    }
+    if (context->terminators) {
+        kubeyaml_free(context->terminators);
+    }
+    kubeyaml_free(context);
+}
+
+/*
+ * Load the buffer with the fast path. The kubeconfig is filled from a
+ * separate kubeconfig_t that is only moved into it once the whole input is
+ * known to be inside the subset, so a fallback starts from the original
+ * kubeconfig.
+ *
+ * If views is not NULL, it is the same bytes as buf, writable, and the
+ * plain values become views into it. The kubeconfig then borrows views as
+ * its buffer.
+ */
+static int load_kubeconfig_fast_path(kubeconfig_t * kubeconfig, kubeyaml_context_t * context, const char *buf, size_t len, char *views, const kubeconfig_projection_t * projection)
+{
+    fast_path_t fp;
+    kubeconfig_t *scanned = NULL;
+    int is_json = 0;
+    int rc = 0;
+
+    scanned = scanned_kubeconfig_create(kubeconfig);
+    if (!scanned) {
+        return FAST_PATH_UNSUPPORTED;
+    }
+
+    memset(&fp, 0, sizeof(fp));
+    if (context) {
+        fp.scratch = context->scratch;
+        fp.scratch_size = context->scratch_size;
+        fp.terminators = context->terminators;
+        fp.terminators_capacity = context->terminators_capacity;
+    }
+    kubeconfig_builder_init(&fp.builder, scanned);
+    fp.builder.projection = projection;
+    is_json = fast_path_is_json(buf, len);
+    if (projection && projection->select && !is_json) {
+        fast_path_select(&fp, kubeconfig, buf, len, projection);
+    }
+    if (views) {
+        fp.views = views;
+        fp.views_length = len;
+        scanned->buffer = views;
+        scanned->buffer_size = len;
+        scanned->buffer_type = KUBECONFIG_BUFFER_BORROWED;
+    }
+
+    if (is_json) {
+        rc = fast_path_json_scan(&fp, buf, len);
+    } else {
+        rc = fast_path_scan(&fp, buf, len);
+    }
+
+    kubeconfig_builder_clear(&fp.builder);
+
+    if (0 == rc) {
+        for (size_t i = 0; i < fp.terminators_count; i++) {
+            views[fp.terminators[i]] = '\0';
+        }
+        move_kubeconfig(kubeconfig, scanned);
+        if (views) {
+            kubeconfig->buffer = views;
+            kubeconfig->buffer_size = len;
+            kubeconfig->buffer_type = KUBECONFIG_BUFFER_BORROWED;
+        }
+    }
+    if (context) {
+        context->scratch = fp.scratch;
+        context->scratch_size = fp.scratch_size;
+        context->terminators = fp.terminators;
+        context->terminators_capacity = fp.terminators_capacity;
+    } else {
+        if (fp.scratch) {
+            kubeyaml_free(fp.scratch);
+        }
+        if (fp.terminators) {
+            kubeyaml_free(fp.terminators);
+        }
+    }
+    if (fp.skips) {
+        kubeyaml_free(fp.skips);
+    }
+
+    kubeconfig_free(scanned);
+    return rc;
+}
+
+/*
+ * Threads
+ */
+
+/* Run worker(data) on threads threads, the calling thread included, to share tasks tasks. Threads that cannot be started leave their share to the others. */
+static void threads_run(int threads, int tasks, void *(*worker) (void *), void *data)
+{
+    pthread_t *workers = NULL;
+    int workers_count = 0;
+
+    if (threads <= 0) {
+        threads = (int) sysconf(_SC_NPROCESSORS_ONLN);
+    }
+    if (threads > tasks) {
+        threads = tasks;
+    }
+
+    if (threads > 1) {
+        workers = kubeyaml_calloc((size_t) threads - 1, sizeof(pthread_t));
+    }
+    for (int i = 0; workers && i < threads - 1; i++) {
+        if (0 != pthread_create(&workers[i], NULL, worker, data)) {
+            break;
+        }
+        workers_count++;
+    }
+    worker(data);
+    for (int i = 0; i < workers_count; i++) {
+        pthread_join(workers[i], NULL);
+    }
+
+    if (workers) {
+        kubeyaml_free(workers);
+    }
+}
+
+/*
+ * Shards
+ *
+ * KUBEYAML_LOAD_PARALLEL: the index finds the entries of clusters, contexts
+ * and users, which are cut into shards of consecutive entries. A pool of
+ * threads scans each shard with the fast path into its own kubeconfig_t,
+ * as the value of its key in a top mapping. The rest of the input is then
+ * scanned with the shards skipped, and the properties of the shards are
+ * put together in the order of the input. Input that the index or the fast
+ * path does not handle is left to the loader without threads.
+ */
+
+#define SHARD_MIN_ENTRIES 64    /* fewer entries are not worth a thread */
+#define SHARDS_PER_THREAD 4     /* smaller shards even out the work of the threads */
+
+typedef struct shard_t {
+    const char *key;            /* clusters, contexts or users */
+    kubeconfig_property_type_t type;
+    kubeyaml_index_entry_t range;       /* from the start of the first entry to the end of the last one */
+    kubeconfig_t *kubeconfig;   /* properties of the entries */
+    int rc;
+} shard_t;
+
+typedef struct shards_t {
+    kubeconfig_t *kubeconfig;   /* loaded into */
+    const char *buf;
+    const kubeconfig_projection_t *projection;
+    shard_t *shards;
+    int count;
+    int next;                   /* next shard to scan, shared by the threads */
+} shards_t;
+
+static kubeconfig_property_t ***shard_properties(kubeconfig_t * kubeconfig, kubeconfig_property_type_t type, int **p_count)
+{
+    switch (type) {
+    case KUBECONFIG_PROPERTY_TYPE_CLUSTER:
+        *p_count = &kubeconfig->clusters_count;
+        return &kubeconfig->clusters;
+    case KUBECONFIG_PROPERTY_TYPE_CONTEXT:
+        *p_count = &kubeconfig->contexts_count;
+        return &kubeconfig->contexts;
+    default:
+        *p_count = &kubeconfig->users_count;
+        return &kubeconfig->users;
+    }
+}
+
+static int shards_split(shards_t * shards, const kubeyaml_index_t * index, int threads)
+{
+    static const char *const keys[] = { KEY_CLUSTERS, KEY_CONTEXTS, KEY_USERS };
+    static const kubeconfig_property_type_t types[] = { KUBECONFIG_PROPERTY_TYPE_CLUSTER, KUBECONFIG_PROPERTY_TYPE_CONTEXT, KUBECONFIG_PROPERTY_TYPE_USER };
+
+    kubeyaml_index_entry_t *entries[3] = { NULL, NULL, NULL };
+    int counts[3] = { 0, 0, 0 };
+    shard_t *shard = NULL;
+    int total = 0;
+    int size = 0;
+    int last = 0;
+    int rc = 0;
+
+    /* A key that is not a sequence is left to the scan of the rest. */
+    for (int k = 0; k < 3; k++) {
+        if (0 != kubeyaml_index_get_entries(index, keys[k], &entries[k], &counts[k])) {
+            counts[k] = 0;
+        }
+        total += counts[k];
+    }
+
+    if (total < 2 * SHARD_MIN_ENTRIES) {
+        rc = FAST_PATH_UNSUPPORTED;
+        goto end;
+    }
+    size = (total + threads * SHARDS_PER_THREAD - 1) / (threads * SHARDS_PER_THREAD);
+    if (size < SHARD_MIN_ENTRIES) {
+        size = SHARD_MIN_ENTRIES;
+    }
+
+    shards->shards = kubeyaml_calloc((size_t) (total / size + 3), sizeof(shard_t));
+    if (!shards->shards) {
+        rc = FAST_PATH_UNSUPPORTED;
+        goto end;
+    }
+    for (int k = 0; k < 3; k++) {
+        for (int i = 0; i < counts[k]; i += size) {
+            last = (i + size < counts[k]) ? i + size - 1 : counts[k] - 1;
+            shard = &shards->shards[shards->count++];
+            shard->key = keys[k];
+            shard->type = types[k];
+            shard->range.offset = entries[k][i].offset;
+            shard->range.length = entries[k][last].offset + entries[k][last].length - entries[k][i].offset;
+            shard->range.line = entries[k][i].line;
+        }
+    }
+
+  end:
+    for (int k = 0; k < 3; k++) {
+        kubeyaml_free(entries[k]);
+    }
+    return rc;
+}
+
+static int shard_scan(shards_t * shards, shard_t * shard)
+{
+    fast_path_t fp;
+    int rc = 0;
+
+    shard->kubeconfig = scanned_kubeconfig_create(shards->kubeconfig);
+    if (!shard->kubeconfig) {
+        return FAST_PATH_UNSUPPORTED;
+    }
+
+    memset(&fp, 0, sizeof(fp));
+    kubeconfig_builder_init(&fp.builder, shard->kubeconfig);
+    fp.builder.projection = shards->projection;
+    /* The entries are the value of the key in a top mapping opened before them, a document marker among them is not supported. */
+    fp.has_root = 1;
+    rc = fast_path_open(&fp, -1, 0);
+    if (0 == rc) {
+        rc = fast_path_scalar_event(&fp, shard->key, strlen(shard->key));
+    }
+    if (0 == rc) {
+        fp.pending = 1;
+        rc = fast_path_scan(&fp, shards->buf + shard->range.offset, shard->range.length);
+    }
+
+    kubeconfig_builder_clear(&fp.builder);
+    if (fp.scratch) {
+        kubeyaml_free(fp.scratch);
+    }
+    return rc;
+}
+
+static void *shards_worker(void *data)
+{
+    shards_t *shards = data;
+    int i = 0;
+
+    while ((i = __atomic_fetch_add(&shards->next, 1, __ATOMIC_RELAXED)) < shards->count) {
+        shards->shards[i].rc = shard_scan(shards, &shards->shards[i]);
+    }
+    return NULL;
+}
+
+/* Put the properties of the shards of each key together, they replace those of an earlier occurrence of the key like in a serial load. */
+static int shards_merge(shards_t * shards, kubeconfig_t * scanned)
+{
+    kubeconfig_property_t ***to = NULL;
+    kubeconfig_property_t ***from = NULL;
+    kubeconfig_property_t **properties = NULL;
+    int *to_count = NULL;
+    int *from_count = NULL;
+    int count = 0;
+    int first = 0;
+
+    for (int i = 0; i < shards->count; i = first) {
+        first = i;
+        count = 0;
+        while (first < shards->count && shards->shards[first].type == shards->shards[i].type) {
+            shard_properties(shards->shards[first].kubeconfig, shards->shards[i].type, &from_count);
+            count += *from_count;
+            first++;
+        }
+
+        properties = NULL;
+        if (count > 0) {
+            properties = kubeconfig_alloc(scanned, (size_t) count * sizeof(kubeconfig_property_t *));
+            if (!properties) {
+                return FAST_PATH_UNSUPPORTED;
+            }
+        }
+        count = 0;
+        for (int j = i; j < first; j++) {
+            from = shard_properties(shards->shards[j].kubeconfig, shards->shards[j].type, &from_count);
+            if (*from) {
+                memcpy(properties + count, *from, (size_t) *from_count * sizeof(kubeconfig_property_t *));
+                count += *from_count;
+                kubeconfig_memory_release(shards->shards[j].kubeconfig, *from);
+                *from = NULL;
+                *from_count = 0;
+            }
+        }
+
+        to = shard_properties(scanned, shards->shards[i].type, &to_count);
+        if (*to) {
+            kubeconfig_properties_release(scanned, *to, *to_count);
+        }
+        *to = properties;
+        *to_count = count;
+    }
+
+    for (int i = 0; i < shards->count; i++) {
+        move_kubeconfig_arena(scanned, shards->shards[i].kubeconfig);
+    }
+    return 0;
+}
+
+static int load_kubeconfig_parallel(kubeconfig_t * kubeconfig, const char *buf, size_t len, int threads, const kubeconfig_projection_t * projection)
+{
+    shards_t shards;
+    fast_path_t fp;
+    kubeyaml_index_t *index = NULL;
+    kubeconfig_t *scanned = NULL;
+    int rc = 0;
+
+    /* The selection of contexts has its own way to skip entries, the table of interned strings is not shared by threads. */
+    if (fast_path_is_json(buf, len) || (projection && projection->select) || kubeconfig->strings) {
+        return FAST_PATH_UNSUPPORTED;
+    }
+    if (threads <= 0) {
+        threads = (int) sysconf(_SC_NPROCESSORS_ONLN);
+    }
+    if (threads < 2) {
+        return FAST_PATH_UNSUPPORTED;
+    }
+
+    index = kubeyaml_index_try_create(buf, len);
+    if (!index) {
+        return FAST_PATH_UNSUPPORTED;
+    }
+    memset(&shards, 0, sizeof(shards));
+    shards.kubeconfig = kubeconfig;
+    shards.buf = buf;
+    shards.projection = projection;
+    rc = shards_split(&shards, index, threads);
+    kubeyaml_index_free(index);
+    if (0 != rc) {
+        goto end;
+    }
+
+    threads_run(threads, shards.count, shards_worker, &shards);
+    for (int i = 0; i < shards.count && 0 == rc; i++) {
+        rc = shards.shards[i].rc;
+    }
+    if (0 != rc) {
+        goto end;
+    }
+
+    scanned = scanned_kubeconfig_create(kubeconfig);
+    if (!scanned) {
+        rc = FAST_PATH_UNSUPPORTED;
+        goto end;
+    }
+    memset(&fp, 0, sizeof(fp));
+    kubeconfig_builder_init(&fp.builder, scanned);
+    fp.builder.projection = projection;
+    fp.skips = kubeyaml_malloc((size_t) shards.count * sizeof(kubeyaml_index_entry_t));
+    if (!fp.skips) {
+        rc = FAST_PATH_UNSUPPORTED;
+        goto end;
+    }
+    for (int i = 0; i < shards.count; i++) {
+        fp.skips[i] = shards.shards[i].range;
+    }
+    fp.skips_count = shards.count;
+    qsort(fp.skips, fp.skips_count, sizeof(kubeyaml_index_entry_t), fast_path_skip_compare);
+
+    rc = fast_path_scan(&fp, buf, len);
+
+    kubeconfig_builder_clear(&fp.builder);
+    if (fp.scratch) {
+        kubeyaml_free(fp.scratch);
+    }
+    kubeyaml_free(fp.skips);
+
+    if (0 == rc) {
+        rc = shards_merge(&shards, scanned);
+    }
+    if (0 == rc) {
+        move_kubeconfig(kubeconfig, scanned);
+    }
+
+  end:
+    for (int i = 0; i < shards.count; i++) {
+        kubeconfig_free(shards.shards[i].kubeconfig);
+    }
+    kubeyaml_free(shards.shards);
+    kubeconfig_free(scanned);
+    return rc;
+}
+
+static int load_kubeconfig_reader(kubeconfig_t * kubeconfig, kubeyaml_read_handler_t handler, void *data, unsigned int flags, const kubeconfig_projection_t * projection)
+{
+    yaml_parser_t parser;
+    int rc = 0;
+
+    /* Create the Parser object. */
+    yaml_parser_initialize(&parser);
+
+    /* Pull the input through the caller's handler as the parser needs it. */
+    yaml_parser_set_input(&parser, (yaml_read_handler_t *) handler, data);
+
+    rc = load_kubeconfig_yaml_parser(kubeconfig, &parser, flags, projection);
+
+    /* Cleanup */
+    yaml_parser_delete(&parser);
+    return rc;
+}
+
+/* The decompressed text is streamed to libyaml, the fast path and zero-copy loads need all of it at once. */
+static int load_kubeconfig_decompress(kubeconfig_t * kubeconfig, kubeconfig_decompress_t * decompress, unsigned int flags, const kubeconfig_projection_t * projection)
+{
+    int rc = 0;
+
+    rc = load_kubeconfig_reader(kubeconfig, kubeconfig_decompress_read, decompress, flags & ~KUBEYAML_LOAD_ZERO_COPY, projection);
+    kubeconfig_decompress_free(decompress);
+    return rc;
+}
+
+static int load_kubeconfig_compressed_buffer(kubeconfig_t * kubeconfig, kubeconfig_compression_t compression, const char *buf, size_t len, unsigned int flags, const kubeconfig_projection_t * projection)
+{
+    kubeconfig_decompress_t decompress;
+
+    if (0 != kubeconfig_decompress_init_buffer(&decompress, compression, buf, len)) {
+        return -1;
+    }
+    return load_kubeconfig_decompress(kubeconfig, &decompress, flags, projection);
+}
+
+static int load_kubeconfig_buffer(kubeconfig_t * kubeconfig, kubeyaml_context_t * context, const char *buf, size_t len, unsigned int flags, int threads, const kubeconfig_projection_t * projection)
+{
+    kubeconfig_compression_t compression = kubeconfig_compression_detect(buf, len);
+    yaml_parser_t parser;
+    int rc = 0;
+
+    if (KUBECONFIG_COMPRESSION_NONE != compression) {
+        return load_kubeconfig_compressed_buffer(kubeconfig, compression, buf, len, flags, projection);
+    }
+
+    if ((flags & KUBEYAML_LOAD_PARALLEL) && !(flags & KUBEYAML_LOAD_NO_FAST_PATH)) {
+        rc = load_kubeconfig_parallel(kubeconfig, buf, len, threads, projection);
+        if (FAST_PATH_UNSUPPORTED != rc) {
+            return rc;
+        }
+    }
+
+    if (!(flags & KUBEYAML_LOAD_NO_FAST_PATH)) {
+        rc = load_kubeconfig_fast_path(kubeconfig, context, buf, len, NULL, projection);
+        if (FAST_PATH_UNSUPPORTED != rc) {
+            return rc;
+        }
+    }
+
+    /* Create the Parser object. */
+    yaml_parser_initialize(&parser);
+
+    /* Set a string input, the parser reads the caller's buffer in place. */
+    yaml_parser_set_input_string(&parser, (const unsigned char *) buf, len);
+
+    rc = load_kubeconfig_yaml_parser(kubeconfig, &parser, flags, projection);
+
+    /* Cleanup */
+    yaml_parser_delete(&parser);
+    return rc;
+}
+
+/*
+ * KUBEYAML_LOAD_ZERO_COPY: when the fast path handles buf, the kubeconfig
+ * keeps it as its buffer of type buffer_type. Otherwise buf is loaded with
+ * copies and the caller still owns it.
+ */
+static int load_kubeconfig_zero_copy(kubeconfig_t * kubeconfig, kubeyaml_context_t * context, char *buf, size_t len, kubeconfig_buffer_type_t buffer_type, unsigned int flags, const kubeconfig_projection_t * projection)
+{
+    int rc = 0;
+
+    if (!(flags & KUBEYAML_LOAD_NO_FAST_PATH) && KUBECONFIG_COMPRESSION_NONE == kubeconfig_compression_detect(buf, len)) {
+        rc = load_kubeconfig_fast_path(kubeconfig, context, buf, len, buf, projection);
+        if (0 == rc) {
+            kubeconfig->buffer_type = buffer_type;
+        }
+        if (FAST_PATH_UNSUPPORTED != rc) {
+            return rc;
+        }
+    }
+
+    return load_kubeconfig_buffer(kubeconfig, context, buf, len, flags | KUBEYAML_LOAD_NO_FAST_PATH, 0, projection);
+}
+
+static int load_kubeconfig_file(kubeconfig_t * kubeconfig, kubeyaml_context_t * context, unsigned int flags, int threads, const kubeconfig_projection_t * projection)
+{
+    static char fname[] = "load_kubeconfig_file()";
+
+    kubeconfig_decompress_t decompress;
+    unsigned char head[KUBECONFIG_COMPRESSION_MAGIC_SIZE];
+    size_t head_length = 0;
+    struct stat st;
+    FILE *input = NULL;
+    char *buf = NULL;
+    size_t size = 0;
+    int rc = 0;
+
+    /* Set a file input. */
+    input = fopen(kubeconfig->fileName, "rb");
+    if (!input) {
+        fprintf(stderr, "%s: Cannot open the file %s.[%s]\n", fname, kubeconfig->fileName, strerror(errno));
+        return -1;
+    }
+
+    /* The first bytes tell whether the file is compressed, they are read once so that pipes work too. */
+    head_length = fread(head, 1, sizeof(head), input);
+    if (ferror(input)) {
+        fprintf(stderr, "%s: Cannot read the file %s.\n", fname, kubeconfig->fileName);
+        fclose(input);
+        return -1;
+    }
+
+    /* The fast path needs the whole input, a regular file is read at once. Files reporting no size (e.g. in /proc) are streamed. */
+    if (!(flags & KUBEYAML_LOAD_NO_FAST_PATH) && KUBECONFIG_COMPRESSION_NONE == kubeconfig_compression_detect(head, head_length)
+        && 0 == fstat(fileno(input), &st) && S_ISREG(st.st_mode) && st.st_size > 0) {
+        size = (size_t) st.st_size;
+        if (size < head_length) {
+            size = head_length;
+        }
+        buf = kubeyaml_malloc(size);
+        if (!buf) {
+            fprintf(stderr, "%s: Cannot allocate memory for the file %s.\n", fname, kubeconfig->fileName);
+            fclose(input);
+            return -1;
+        }
+        memcpy(buf, head, head_length);
+        size = head_length + fread(buf + head_length, 1, size - head_length, input);
+        if (ferror(input)) {
+            fprintf(stderr, "%s: Cannot read the file %s.\n", fname, kubeconfig->fileName);
+            kubeyaml_free(buf);
+            fclose(input);
+            return -1;
+        }
+        fclose(input);
+
+        if (flags & KUBEYAML_LOAD_ZERO_COPY) {
+            rc = load_kubeconfig_zero_copy(kubeconfig, context, buf, size, KUBECONFIG_BUFFER_HEAP, flags, projection);
+        } else {
+            rc = load_kubeconfig_buffer(kubeconfig, context, buf, size, flags, threads, projection);
+        }
+
+        if (kubeconfig->buffer != buf) {
+            kubeyaml_free(buf);
+        }
+        return rc;
+    }
+
+    /* Compressed files are decompressed as the parser reads them, the others are passed through. */
+    if (0 != kubeconfig_decompress_init_file(&decompress, input, head, head_length)) {
+        fclose(input);
+        return -1;
+    }
+    rc = load_kubeconfig_decompress(kubeconfig, &decompress, flags, projection);
+
+    /* Cleanup */
+    fclose(input);
+    return rc;
+}
+
+static int load_kubeconfig_mapped_file(kubeconfig_t * kubeconfig, kubeyaml_context_t * context, unsigned int flags, int threads, const kubeconfig_projection_t * projection)
+{
+    static char fname[] = "load_kubeconfig_mapped_file()";
+
+    struct stat st;
+    void *map = NULL;
+    size_t size = 0;
+    int fd = -1;
+    int rc = 0;
+
+    fd = open(kubeconfig->fileName, O_RDONLY);
+    if (-1 == fd) {
+        fprintf(stderr, "%s: Cannot open the file %s.[%s]\n", fname, kubeconfig->fileName, strerror(errno));
+        return -1;
+    }
+    if (-1 == fstat(fd, &st)) {
+        fprintf(stderr, "%s: Cannot stat the file %s.[%s]\n", fname, kubeconfig->fileName, strerror(errno));
+        close(fd);
+        return -1;
+    }
+    if (!S_ISREG(st.st_mode)) {
+        fprintf(stderr, "%s: %s is not a regular file.\n", fname, kubeconfig->fileName);
+        close(fd);
+        return -1;
+    }
+
+    /* mmap() refuses zero-length mappings, an empty file is parsed as an empty string. */
+    size = (size_t) st.st_size;
+    if (size > 0) {
+        /* The views of a zero-copy load are terminated in place, in private copies of the pages. */
+        map = mmap(NULL, size, (flags & KUBEYAML_LOAD_ZERO_COPY) ? PROT_READ | PROT_WRITE : PROT_READ, MAP_PRIVATE, fd, 0);
+        if (MAP_FAILED == map) {
+            fprintf(stderr, "%s: Cannot map the file %s.[%s]\n", fname, kubeconfig->fileName, strerror(errno));
+            close(fd);
+            return -1;
+        }
+        madvise(map, size, MADV_SEQUENTIAL);
+    }
+    /* The mapping stays valid after the descriptor is closed. */
+    close(fd);
+
+    /* Feed the whole mapping to the parser as one contiguous buffer. */
+    if (map && (flags & KUBEYAML_LOAD_ZERO_COPY)) {
+        rc = load_kubeconfig_zero_copy(kubeconfig, context, map, size, KUBECONFIG_BUFFER_MAPPED, flags, projection);
+    } else {
+        rc = load_kubeconfig_buffer(kubeconfig, context, map ? (const char *) map : "", size, flags, threads, projection);
+    }
+
+    /* Cleanup */
+    if (map && kubeconfig->buffer != map) {
+        munmap(map, size);
+    }
+    return rc;
+}
+
+static int load_kubeconfig_input(kubeconfig_t * kubeconfig, const kubeyaml_load_options_t * options, unsigned int flags, const kubeconfig_projection_t * projection)
+{
+    static char fname[] = "kubeyaml_load_kubeconfig_with_options()";
+
+    kubeyaml_context_t *context = options ? options->context : NULL;
+    int threads = options ? options->threads : 0;
+
+    if (options && options->buffer && (flags & KUBEYAML_LOAD_ZERO_COPY)) {
+        /* The caller provides a writable buffer for a zero-copy load. */
+        return load_kubeconfig_zero_copy(kubeconfig, context, (char *) options->buffer, options->buffer_length, KUBECONFIG_BUFFER_BORROWED, flags, projection);
+    } else if (options && options->buffer) {
+        return load_kubeconfig_buffer(kubeconfig, context, options->buffer, options->buffer_length, flags, threads, projection);
+    } else if (options && options->read_handler) {
+        return load_kubeconfig_reader(kubeconfig, options->read_handler, options->read_handler_data, flags, projection);
+    }
+
+    if (!kubeconfig->fileName) {
+        fprintf(stderr, "%s: The kubeconf file name needs be set by kubeconfig->fileName .\n", fname);
+        return -1;
+    }
+
+    if (flags & KUBEYAML_LOAD_MMAP) {
+        return load_kubeconfig_mapped_file(kubeconfig, context, flags, threads, projection);
+    }
+    return load_kubeconfig_file(kubeconfig, context, flags, threads, projection);
+}
+
+/*
+ * Decoding of the *-data fields
+ *
+ * A pass over the loaded entries, whatever the way they were loaded. The
+ * text is released like any replaced string: freed when it was copied,
+ * left in the arena or the buffer of the kubeconfig otherwise.
+ */
+
+static int decode_kubeconfig_data_field(kubeconfig_t * kubeconfig, char **p_field, const char *key)
+{
+    static char fname[] = "kubeyaml_load_kubeconfig_with_options()";
+
+    kubeconfig_base64_t decoder;
+    kubeconfig_data_t *data = NULL;
+    char *text = *p_field;
+    size_t length = 0;
+    size_t size = 0;
+    size_t n = 0;
+
+    if (!text) {
+        return 0;
+    }
+    *p_field = NULL;
+
+    length = strlen(text);
+    size = KUBECONFIG_BASE64_DECODED_LENGTH(length);
+    data = kubeconfig_alloc(kubeconfig, sizeof(kubeconfig_data_t) + size + 1);
+    if (!data) {
+        fprintf(stderr, "%s: Cannot allocate memory for the decoded %s.\n", fname, key);
+        kubeconfig_string_free(kubeconfig, text);
+        return -1;
+    }
+
+    kubeconfig_base64_init(&decoder, text, length);
+    do {
+        if (0 != kubeconfig_base64_decode(&decoder, data->data + data->length, size - data->length, &n)) {
+            fprintf(stderr, "%s: The %s is not valid base64.\n", fname, key);
+            kubeconfig_memory_release(kubeconfig, data);
+            kubeconfig_string_free(kubeconfig, text);
+            return -1;
+        }
+        data->length += n;
+    } while (n > 0 && data->length < size);
+    data->data[data->length] = '\0';
+
+    kubeconfig_string_free(kubeconfig, text);
+    *p_field = (char *) data;
+    return 0;
+}
+
+static int decode_kubeconfig_data(kubeconfig_t * kubeconfig)
+{
+    int rc = 0;
+
+    /* A field that cannot be decoded is left NULL, the others are decoded all the same. */
+    kubeconfig->data_decoded = 1;
+    for (int i = 0; i < kubeconfig->clusters_count; i++) {
+        kubeconfig_property_t *cluster = kubeconfig->clusters[i];
+        if (cluster && 0 != decode_kubeconfig_data_field(kubeconfig, &cluster->certificate_authority_data, KEY_CERTIFICATE_AUTHORITY_DATA)) {
+            rc = -1;
+        }
+    }
+    for (int i = 0; i < kubeconfig->users_count; i++) {
+        kubeconfig_property_t *user = kubeconfig->users[i];
+        if (user && 0 != decode_kubeconfig_data_field(kubeconfig, &user->client_certificate_data, KEY_CLIENT_CERTIFICATE_DATA)) {
+            rc = -1;
+        }
+        if (user && 0 != decode_kubeconfig_data_field(kubeconfig, &user->client_key_data, KEY_CLIENT_KEY_DATA)) {
+            rc = -1;
+        }
+    }
+    return rc;
+}
+
+int kubeyaml_load_kubeconfig_with_options(kubeconfig_t * kubeconfig, const kubeyaml_load_options_t * options)
+{
+    static char fname[] = "kubeyaml_load_kubeconfig_with_options()";
+
+    unsigned int flags = options ? options->flags : 0;
+    kubeconfig_projection_t projection;
+    const kubeconfig_projection_t *p_projection = NULL;
+    int rc = 0;
+
+    if (!kubeconfig) {
+        fprintf(stderr, "%s: The kubeconfig is null.\n", fname);
+        return -1;
+    }
+    /* Its strings may point into the buffer, they cannot be replaced by another load. */
+    if (kubeconfig->buffer) {
+        fprintf(stderr, "%s: The kubeconfig holds the input of a zero-copy load.\n", fname);
+        return -1;
+    }
+    /* The entries a load keeps would be decoded, the ones it replaces not. */
+    if (kubeconfig->data_decoded) {
+        fprintf(stderr, "%s: The kubeconfig holds decoded *-data fields.\n", fname);
+        return -1;
+    }
+    if ((flags & KUBEYAML_LOAD_ARENA) && !kubeconfig->arena) {
+        /* kubeconfig_free() would not walk the entries loaded before. */
+        if (kubeconfig->apiVersion || kubeconfig->kind || kubeconfig->preferences || kubeconfig->current_context || kubeconfig->clusters || kubeconfig->contexts || kubeconfig->users) {
+            fprintf(stderr, "%s: The kubeconfig is already loaded without an arena.\n", fname);
+            return -1;
+        }
+        kubeconfig->arena = kubeconfig_arena_create();
+        if (!kubeconfig->arena) {
+            fprintf(stderr, "%s: Cannot allocate memory for the arena.\n", fname);
+            return -1;
+        }
+    }
+    if ((flags & KUBEYAML_LOAD_INTERN) && !kubeconfig->strings) {
+        kubeconfig->strings = kubeconfig_strings_create();
+        if (!kubeconfig->strings) {
+            fprintf(stderr, "%s: Cannot allocate memory for the table of strings.\n", fname);
+            return -1;
+        }
+    }
+
+    memset(&projection, 0, sizeof(projection));
+    if (options) {
+        projection.skip_fields = options->skip_fields;
+        projection.current_context = (flags & KUBEYAML_LOAD_CURRENT_CONTEXT) ? 1 : 0;
+        projection.contexts = options->contexts;
+        projection.contexts_count = options->contexts ? options->contexts_count : 0;
+        projection.select = (projection.current_context || projection.contexts);
+    }
+    if (projection.skip_fields || projection.select) {
+        p_projection = &projection;
+    }
+
+    rc = load_kubeconfig_input(kubeconfig, options, flags, p_projection);
+    if (0 == rc) {
+        rc = kubeconfig_projection_apply(kubeconfig, p_projection);
+    }
+    if (0 == rc && (flags & KUBEYAML_LOAD_DECODE_DATA)) {
+        rc = decode_kubeconfig_data(kubeconfig);
+    }
+    return rc;
+}
+
+int kubeyaml_load_kubeconfig(kubeconfig_t * kubeconfig)
+{
+    return kubeyaml_load_kubeconfig_with_options(kubeconfig, NULL);
+}
+
+int kubeyaml_load_kubeconfig_mmap(kubeconfig_t * kubeconfig)
+{
+    kubeyaml_load_options_t options;
+
+    memset(&options, 0, sizeof(options));
+    options.flags = KUBEYAML_LOAD_MMAP;
+
+    return kubeyaml_load_kubeconfig_with_options(kubeconfig, &options);
+}
+
+int kubeyaml_load_kubeconfig_from_buffer(kubeconfig_t * kubeconfig, const char *buf, size_t len)
+{
+    static char fname[] = "kubeyaml_load_kubeconfig_from_buffer()";
+
+    kubeyaml_load_options_t options;
+
+    if (!buf) {
+        fprintf(stderr, "%s: The kubeconfig buffer is null.\n", fname);
+        return -1;
+    }
+
+    memset(&options, 0, sizeof(options));
+    options.buffer = buf;
+    options.buffer_length = len;
+
+    return kubeyaml_load_kubeconfig_with_options(kubeconfig, &options);
+}
+
+static int read_fd_handler(void *data, unsigned char *buffer, size_t size, size_t * size_read)
+{
+    int fd = *(int *) data;
+    ssize_t n = 0;
+
+    do {
+        n = read(fd, buffer, size);
+    } while (-1 == n && EINTR == errno);
+
+    if (n < 0) {
+        *size_read = 0;
+        return 0;
+    }
+
+    *size_read = (size_t) n;
+    return 1;
+}
+
+int kubeyaml_load_kubeconfig_from_reader(kubeconfig_t * kubeconfig, kubeyaml_read_handler_t handler, void *data)
+{
+    static char fname[] = "kubeyaml_load_kubeconfig_from_reader()";
+
+    kubeyaml_load_options_t options;
+
+    if (!handler) {
+        fprintf(stderr, "%s: The read handler is null.\n", fname);
+        return -1;
+    }
+
+    memset(&options, 0, sizeof(options));
+    options.read_handler = handler;
+    options.read_handler_data = data;
+
+    return kubeyaml_load_kubeconfig_with_options(kubeconfig, &options);
+}
+
+int kubeyaml_load_kubeconfig_from_fd(kubeconfig_t * kubeconfig, int fd)
+{
+    static char fname[] = "kubeyaml_load_kubeconfig_from_fd()";
+
+    if (fd < 0) {
+        fprintf(stderr, "%s: The file descriptor %d is invalid.\n", fname, fd);
+        return -1;
+    }
+
+    return kubeyaml_load_kubeconfig_from_reader(kubeconfig, read_fd_handler, &fd);
+}
+
+/*
+ * Secret
+ *
+ * Cluster API and other controllers store kubeconfigs base64-encoded in the
+ * data of a Secret. The encoded text is found in place in the manifest when
+ * the JSON helpers or the index handle it, in the libyaml document of the
+ * manifest otherwise, and is decoded as the kubeconfig parser reads it.
+ */
+
+#define SECRET_DEFAULT_KEY "value"
+
+static int secret_read_handler(void *data, unsigned char *buffer, size_t size, size_t * size_read)
+{
+    return (0 == kubeconfig_base64_decode((kubeconfig_base64_t *) data, buffer, size, size_read));
+}
+
+/* Find data.key in place, 1 if the manifest is left to libyaml. */
+static int secret_find_view(const char *buf, size_t len, const char *key, const char **value, size_t *length)
+{
+    const char *keys[2] = { "data", key };
+    kubeyaml_index_t *index = NULL;
+    char *path = NULL;
+    int rc = 0;
+
+    if (fast_path_is_json(buf, len)) {
+        return kubeconfig_json_get_view(buf, len, keys, 2, value, length);
+    }
+
+    /* The index paths split the keys at '.' and '['. */
+    if (strpbrk(key, ".[")) {
+        return 1;
+    }
+    index = kubeyaml_index_try_create(buf, len);
+    if (!index) {
+        return 1;
+    }
+    path = kubeyaml_malloc(strlen("data.") + strlen(key) + 1);
+    if (!path) {
+        kubeyaml_index_free(index);
+        return 1;
+    }
+    sprintf(path, "data.%s", key);
+    rc = kubeyaml_index_get_view(index, path, value, length);
+    kubeyaml_free(path);
+    kubeyaml_index_free(index);
+
+    return (0 == rc) ? 0 : 1;
+}
+
+/* Find data.key in the first document of the manifest, the last one of duplicate keys wins. */
+static int secret_find_node(yaml_document_t * document, const char *key, const char **value, size_t *length)
+{
+    static char fname[] = "kubeyaml_load_kubeconfig_from_secret()";
+
+    yaml_node_t *root = NULL;
+    yaml_node_t *data = NULL;
+    yaml_node_pair_t *pair = NULL;
+    yaml_node_t *node = NULL;
+
+    root = yaml_document_get_root_node(document);
+    if (!root || YAML_MAPPING_NODE != root->type) {
+        fprintf(stderr, "%s: The secret manifest is not a mapping.\n", fname);
+        return -1;
+    }
+
+    for (pair = root->data.mapping.pairs.start; pair < root->data.mapping.pairs.top; pair++) {
+        node = yaml_document_get_node(document, pair->key);
+        if (YAML_SCALAR_NODE == node->type && 0 == strcmp((const char *) node->data.scalar.value, "data")) {
+            data = yaml_document_get_node(document, pair->value);
+        }
+    }
+    if (!data || YAML_MAPPING_NODE != data->type) {
+        return 0;
+    }
+
+    for (pair = data->data.mapping.pairs.start; pair < data->data.mapping.pairs.top; pair++) {
+        node = yaml_document_get_node(document, pair->key);
+        if (YAML_SCALAR_NODE == node->type && 0 == strcmp((const char *) node->data.scalar.value, key)) {
+            node = yaml_document_get_node(document, pair->value);
+            if (YAML_SCALAR_NODE != node->type) {
+                fprintf(stderr, "%s: data.%s of the secret is not a scalar.\n", fname, key);
+                return -1;
+            }
+            *value = (const char *) node->data.scalar.value;
+            *length = node->data.scalar.length;
+        }
+    }
+    return 0;
+}
+
+int kubeyaml_load_kubeconfig_from_secret(kubeconfig_t * kubeconfig, const char *buf, size_t len, const char *key)
+{
+    static char fname[] = "kubeyaml_load_kubeconfig_from_secret()";
+
+    kubeyaml_load_options_t options;
+    kubeconfig_base64_t decoder;
+    yaml_parser_t parser;
+    yaml_document_t document;
+    int has_document = 0;
+    const char *value = NULL;
+    size_t length = 0;
+    int rc = 0;
+
+    if (!buf) {
+        fprintf(stderr, "%s: The secret buffer is null.\n", fname);
+        return -1;
+    }
+    if (!key) {
+        key = SECRET_DEFAULT_KEY;
+    }
+
+    rc = secret_find_view(buf, len, key, &value, &length);
+    if (0 != rc) {
+        yaml_parser_initialize(&parser);
+        yaml_parser_set_input_string(&parser, (const unsigned char *) buf, len);
+        if (!yaml_parser_load(&parser, &document)) {
+            fprintf(stderr, "%s: Cannot parse the secret manifest.\n", fname);
+            yaml_parser_delete(&parser);
+            return -1;
+        }
+        yaml_parser_delete(&parser);
+        has_document = 1;
+        rc = secret_find_node(&document, key, &value, &length);
+    }
+
+    if (0 == rc && !value) {
+        fprintf(stderr, "%s: The secret has no data.%s.\n", fname, key);
+        rc = -1;
+    }
+
+    if (0 == rc) {
+        kubeconfig_base64_init(&decoder, value, length);
+        memset(&options, 0, sizeof(options));
+        options.read_handler = secret_read_handler;
+        options.read_handler_data = &decoder;
+        rc = kubeyaml_load_kubeconfig_with_options(kubeconfig, &options);
+    }
+
+    if (has_document) {
+        yaml_document_delete(&document);
+    }
+    return rc;
+}
+
+/*
+ * Documents
+ *
+ * A stream of several kubeconfigs is cut at the lines starting with "---",
+ * which YAML does not allow inside a document, even in a block or quoted
+ * scalar. The directives of a document ("%YAML", "%TAG") stay with the
+ * "---" that follows them. The documents are then independent buffers,
+ * loaded by a pool of threads that take them in turn.
+ */
+
+typedef struct documents_t {
+    size_t *offsets;            /* document i is [offsets[i], offsets[i + 1]) */
+    int count;
+    size_t capacity;
+    const char *buf;
+    const kubeyaml_load_options_t *options;
+    kubeconfig_t **kubeconfigs;
+    int *rcs;
+    int next;                   /* next document to load, shared by the threads */
+} documents_t;
+
+static int documents_is_marker(const char *p, const char *end)
+{
+    return (end - p >= 3 && 0 == memcmp(p, "---", 3) && (end - p == 3 || ' ' == p[3] || '\t' == p[3] || '\r' == p[3] || '\n' == p[3]));
+}
+
+/* Whether the text before the first marker is a document, and not only blanks and comments. */
+static int documents_has_content(const char *p, const char *end)
+{
+    while (p < end) {
+        if ('#' == *p) {
+            p = memchr(p, '\n', (size_t) (end - p));
+            if (!p) {
+                return 0;
+            }
+        } else if (' ' != *p && '\t' != *p && '\r' != *p && '\n' != *p) {
+            return 1;
+        }
+        p++;
+    }
+    return 0;
+}
+
+/* Move the start of a document back over the directives before its marker. */
+static const char *documents_directives(const char *buf, const char *start)
+{
+    const char *line = NULL;
+
+    while (start > buf) {
+        line = start - 1;
+        while (line > buf && '\n' != line[-1]) {
+            line--;
+        }
+        if ('%' != *line) {
+            break;
+        }
+        start = line;
+    }
+    return start;
+}
+
+static int documents_add(documents_t * documents, size_t offset)
+{
+    static char fname[] = "kubeyaml_load_kubeconfig_documents()";
+
+    size_t *offsets = NULL;
+    size_t capacity = 0;
+
+    /* Keep room for the end of the last document. */
+    if ((size_t) documents->count + 2 > documents->capacity) {
+        capacity = documents->capacity ? documents->capacity * 2 : 16;
+        offsets = kubeyaml_realloc(documents->offsets, capacity * sizeof(size_t));
+        if (!offsets) {
+            fprintf(stderr, "%s: Cannot allocate memory for the documents.\n", fname);
+            return -1;
+        }
+        documents->offsets = offsets;
+        documents->capacity = capacity;
+    }
+    documents->offsets[documents->count++] = offset;
+    return 0;
+}
+
+static int documents_split(documents_t * documents, const char *buf, size_t len)
+{
+    const char *end = buf + len;
+    const char *p = buf;
+    const char *start = NULL;
+
+    while (p) {
+        /* p is at the beginning of a line. */
+        if (documents_is_marker(p, end)) {
+            start = documents_directives(buf, p);
+            if (0 == documents->count && documents_has_content(buf, start) && documents_add(documents, 0)) {
+                return -1;
+            }
+            if (documents_add(documents, (size_t) (start - buf))) {
+                return -1;
+            }
+        }
+        p = memchr(p, '\n', (size_t) (end - p));
+        if (p) {
+            p++;
+        }
+    }
+
+    if (0 == documents->count && documents_has_content(buf, end) && documents_add(documents, 0)) {
+        return -1;
+    }
+    if (documents->count) {
+        documents->offsets[documents->count] = len;
+    }
+    return 0;
+}
+
+static int documents_load(documents_t * documents, int i)
+{
+    static char fname[] = "kubeyaml_load_kubeconfig_documents()";
+
+    kubeyaml_load_options_t options;
+    kubeconfig_t *kubeconfig = NULL;
+    int rc = 0;
+
+    kubeconfig = kubeconfig_create();
+    if (!kubeconfig) {
+        fprintf(stderr, "%s: Cannot allocate memory for the kubeconfig of document %d.\n", fname, i);
+        return -1;
+    }
+
+    if (documents->options) {
+        memcpy(&options, documents->options, sizeof(options));
+    } else {
+        memset(&options, 0, sizeof(options));
+    }
+    options.buffer = documents->buf + documents->offsets[i];
+    options.buffer_length = documents->offsets[i + 1] - documents->offsets[i];
+    options.read_handler = NULL;
+    options.read_handler_data = NULL;
+    /* A context serves one load at a time. */
+    options.context = NULL;
+    /* The documents are already loaded in parallel. */
+    options.flags &= ~KUBEYAML_LOAD_PARALLEL;
+
+    rc = kubeyaml_load_kubeconfig_with_options(kubeconfig, &options);
+    if (0 != rc) {
+        fprintf(stderr, "%s: Cannot load the kubeconfig of document %d.\n", fname, i);
+    }
+    documents->kubeconfigs[i] = kubeconfig;
+    return rc;
+}
+
+static void *documents_worker(void *data)
+{
+    documents_t *documents = data;
+    int i = 0;
+
+    while ((i = __atomic_fetch_add(&documents->next, 1, __ATOMIC_RELAXED)) < documents->count) {
+        documents->rcs[i] = documents_load(documents, i);
+    }
+    return NULL;
+}
+
+int kubeyaml_load_kubeconfig_documents(const char *buf, size_t len, const kubeyaml_load_options_t * options, int threads, kubeconfig_t *** kubeconfigs, int *count)
+{
+    static char fname[] = "kubeyaml_load_kubeconfig_documents()";
+
+    documents_t documents;
+    int rc = 0;
+
+    if (!buf || !kubeconfigs || !count) {
+        fprintf(stderr, "%s: The buffer or the result is null.\n", fname);
+        return -1;
+    }
+    *kubeconfigs = NULL;
+    *count = 0;
+
+    memset(&documents, 0, sizeof(documents));
+    documents.buf = buf;
+    documents.options = options;
+    rc = documents_split(&documents, buf, len);
+    if (0 != rc || 0 == documents.count) {
+        kubeyaml_free(documents.offsets);
+        return rc;
+    }
+
+    documents.kubeconfigs = kubeyaml_calloc((size_t) documents.count, sizeof(kubeconfig_t *));
+    documents.rcs = kubeyaml_calloc((size_t) documents.count, sizeof(int));
+    if (!documents.kubeconfigs || !documents.rcs) {
+        fprintf(stderr, "%s: Cannot allocate memory for the kubeconfigs.\n", fname);
+        rc = -1;
+        goto end;
+    }
+
+    threads_run(threads, documents.count, documents_worker, &documents);
+
+    for (int i = 0; i < documents.count; i++) {
+        if (0 != documents.rcs[i]) {
+            rc = -1;
+        }
+    }
+
+  end:
+    if (0 == rc) {
+        *kubeconfigs = documents.kubeconfigs;
+        *count = documents.count;
+    } else {
+        kubeconfig_list_free(documents.kubeconfigs, documents.count);
+    }
+    if (documents.rcs) {
+        kubeyaml_free(documents.rcs);
+    }
+    kubeyaml_free(documents.offsets);
+    return rc;
+}
+
+/*
+ * Foreach
+ *
+ * kubeyaml_foreach() is a load in KUBEYAML_LOAD_EVENTS mode without the
+ * fast path, which needs all of the input, and with a projection through
+ * which the builder hands out each entry instead of adding it to the
+ * kubeconfig. Files are read through stdio a chunk at a time.
+ */
+
+int kubeyaml_foreach(kubeconfig_t * kubeconfig, const kubeyaml_load_options_t * options, kubeyaml_foreach_handler_t handler, void *data)
 {
-    static char fname[] = "parse_kubeconfig_yaml_string_mapping_sequence()";
+    static char fname[] = "kubeyaml_foreach()";
 
-    yaml_node_item_t *item = NULL;
-    yaml_node_t *value = NULL;
-    int item_count = 0;
-    int i = 0;
-    int rc = 0;
+    kubeconfig_projection_t projection;
+    unsigned int flags = KUBEYAML_LOAD_EVENTS | KUBEYAML_LOAD_NO_FAST_PATH;
 
-    for (item = node->data.sequence.items.start, item_count = 0; item < node->data.sequence.items.top; item++, item_count++) {
-        ;
+    if (!kubeconfig || !handler) {
+        fprintf(stderr, "%s: The kubeconfig or the handler is null.\n", fname);
+        return -1;
     }
-
-    int mappings_count = item_count;
-    keyValuePair_t **string_mappings = (keyValuePair_t **) calloc(mappings_count, sizeof(keyValuePair_t *));
-    if (!string_mappings) {
-        fprintf(stderr, "%s: Cannot allocate memory for string mappings.\n", fname);
+    if (kubeconfig->buffer) {
+        fprintf(stderr, "%s: The kubeconfig holds the input of a zero-copy load.\n", fname);
         return -1;
     }
-    for (int j = 0; j < mappings_count; j++) {
-        string_mappings[j] = calloc(1, sizeof(keyValuePair_t));
-        if (!string_mappings[j]) {
-            fprintf(stderr, "%s: Cannot allocate memory for string mapping.\n", fname);
-            return -1;
-        }
+    /* The entries handed out would pile up in the arena until the kubeconfig is freed. */
+    if (kubeconfig->arena) {
+        fprintf(stderr, "%s: The kubeconfig has an arena.\n", fname);
+        return -1;
     }
 
-    for (item = node->data.sequence.items.start, i = 0; item < node->data.sequence.items.top; item++, i++) {
-        value = yaml_document_get_node(document, *item);
+    memset(&projection, 0, sizeof(projection));
+    projection.skip_fields = options ? options->skip_fields : 0;
+    projection.visit = handler;
+    projection.visit_data = data;
 
-        rc = parse_kubeconfig_yaml_string_mapping(string_mappings[i], document, value);
-        if (0 != rc) {
-            fprintf(stderr, "%s: Cannot parse kubeconfig string mapping.\n", fname);
-            return -1;
-        }
+    /* A mapped file is parsed in place, still without holding more than an entry. */
+    if (options) {
+        flags |= options->flags & KUBEYAML_LOAD_MMAP;
     }
 
-    *p_string_mappings = string_mappings;
-    *p_mappings_count = mappings_count;
-
-    return 0;
+    return load_kubeconfig_input(kubeconfig, options, flags, &projection);
 }
 
-static int parse_kubeconfig_yaml_property_mapping(kubeconfig_property_t * property, yaml_document_t * document, yaml_node_t * node)
+/*
+ * Peek
+ *
+ * kubeyaml_peek_current_context() only parses the lines that start in the
+ * first column, the keys of the top mapping. The indented lines and the
+ * sequence entries below them (clusters, contexts, users and their
+ * certificates) are skipped a line at a time with memchr(), and the scan
+ * stops at the current-context key. kubectl writes this key after the
+ * clusters and contexts, the pages of the mapped file after it are not
+ * read at all.
+ *
+ * A top-level line the scan cannot follow returns PEEK_UNSUPPORTED, the
+ * file is then loaded with kubeyaml_load_kubeconfig() instead.
+ */
+
+#define PEEK_UNSUPPORTED KUBECONFIG_SCALAR_UNSUPPORTED
+#define PEEK_NOT_FOUND (KUBECONFIG_SCALAR_UNSUPPORTED + 1)
+
+static const char peek_key[] = "current-context";
+
+static int peek_scalar(const char *p, const char *eol, char **scratch, const char **value, size_t *length, const char **next)
 {
-    static char fname[] = "parse_kubeconfig_yaml_property_info_mapping()";
+    char *grown = NULL;
 
-    yaml_node_pair_t *pair = NULL;
-    yaml_node_t *key = NULL;
-    yaml_node_t *value = NULL;
-
-    for (pair = node->data.mapping.pairs.start; pair < node->data.mapping.pairs.top; pair++) {
-        key = yaml_document_get_node(document, pair->key);
-        value = yaml_document_get_node(document, pair->value);
-
-        if (key->type != YAML_SCALAR_NODE) {
-            fprintf(stderr, "%s: The key node is not YAML_SCALAR_NODE.\n", fname);
-            return -1;
-        }
-
-        if (value->type == YAML_SCALAR_NODE) {
-            if (0 == strcmp(key->data.scalar.value, KEY_NAME)) {
-                property->name = strdup(value->data.scalar.value);
-            }
-            if (KUBECONFIG_PROPERTY_TYPE_CLUSTER == property->type) {
-                if (0 == strcmp(key->data.scalar.value, KEY_CERTIFICATE_AUTHORITY_DATA)) {
-                    property->certificate_authority_data = strdup(value->data.scalar.value);
-                } else if (0 == strcmp(key->data.scalar.value, KEY_SERVER)) {
-                    property->server = strdup(value->data.scalar.value);
-                }
-            } else if (KUBECONFIG_PROPERTY_TYPE_USER == property->type) {
-                if (0 == strcmp(key->data.scalar.value, KEY_CLIENT_CERTIFICATE_DATA)) {
-                    property->client_certificate_data = strdup(value->data.scalar.value);
-                } else if (0 == strcmp(key->data.scalar.value, KEY_CLIENT_KEY_DATA)) {
-                    property->client_key_data = strdup(value->data.scalar.value);
-                }
-            } else if (KUBECONFIG_PROPERTY_TYPE_CONTEXT == property->type) {
-                if (0 == strcmp(key->data.scalar.value, KEY_CLUSTER)) {
-                    property->cluster = strdup(value->data.scalar.value);
-                } else if (0 == strcmp(key->data.scalar.value, KEY_NAMESPACE)) {
-                    property->namespace = strdup(value->data.scalar.value);
-                } else if (0 == strcmp(key->data.scalar.value, KEY_USER)) {
-                    property->user = strdup(value->data.scalar.value);
-                }
-            } else if (KUBECONFIG_PROPERTY_TYPE_USER_EXEC == property->type) {
-                if (0 == strcmp(key->data.scalar.value, KEY_APIVERSION)) {
-                    property->apiVersion = strdup(value->data.scalar.value);
-                } else if (0 == strcmp(key->data.scalar.value, KEY_USER_EXEC_COMMAND)) {
-                    property->command = strdup(value->data.scalar.value);
-                }
-            } else if (KUBECONFIG_PROPERTY_TYPE_USER_AUTH_PROVIDER == property->type) {
-                if (0 == strcmp(key->data.scalar.value, KEY_USER_AUTH_PROVIDER_CONFIG_CLIENT_ID)) {
-                    property->client_id = strdup(value->data.scalar.value);
-                } else if (0 == strcmp(key->data.scalar.value, KEY_USER_AUTH_PROVIDER_CONFIG_CLIENT_SECRET)) {
-                    property->client_secret = strdup(value->data.scalar.value);
-                } else if (0 == strcmp(key->data.scalar.value, KEY_USER_AUTH_PROVIDER_CONFIG_ID_TOKEN)) {
-                    property->id_token = strdup(value->data.scalar.value);
-                } else if (0 == strcmp(key->data.scalar.value, KEY_USER_AUTH_PROVIDER_CONFIG_IDP_CERTIFICATE_AUTHORITY_DATA)) {
-                    property->idp_certificate_authority_data = strdup(value->data.scalar.value);
-                } else if (0 == strcmp(key->data.scalar.value, KEY_USER_AUTH_PROVIDER_CONFIG_IDP_ISSUE_URL)) {
-                    property->idp_issuer_url = strdup(value->data.scalar.value);
-                } else if (0 == strcmp(key->data.scalar.value, KEY_USER_AUTH_PROVIDER_CONFIG_REFRESH_TOKEN)) {
-                    property->refresh_token = strdup(value->data.scalar.value);
-                }
-            }
-        } else if (value->type == YAML_MAPPING_NODE) {
-            if (KUBECONFIG_PROPERTY_TYPE_USER == property->type) {
-                int rc = 0;
-                if (0 == strcmp(key->data.scalar.value, KEY_USER_EXEC)) {
-                    property->exec = kubeconfig_property_create(KUBECONFIG_PROPERTY_TYPE_USER_EXEC);
-                    if (!property->exec) {
-                        fprintf(stderr, "Cannot allocate memory for kubeconfig exec for user %s.\n", property->name);
-                        return -1;
-                    }
-                    rc = parse_kubeconfig_yaml_property_mapping(property->exec, document, value);
-                    if (0 != rc) {
-                        fprintf(stderr, "Cannot parse kubeconfig exec for user %s.\n", property->name);
-                        return -1;
-                    }
-                } else if (0 == strcmp(key->data.scalar.value, KEY_USER_AUTH_PROVIDER)) {
-                    property->auth_provider = kubeconfig_property_create(KUBECONFIG_PROPERTY_TYPE_USER_AUTH_PROVIDER);
-                    if (!property->auth_provider) {
-                        fprintf(stderr, "Cannot allocate memory for kubeconfig auth provider for user %s.\n", property->name);
-                        return -1;
-                    }
-                    rc = parse_kubeconfig_yaml_property_mapping(property->auth_provider, document, value);
-                    if (0 != rc) {
-                        fprintf(stderr, "Cannot parse kubeconfig auth provider for user %s.\n", property->name);
-                        return -1;
-                    }
-                } else {
-                    parse_kubeconfig_yaml_property_mapping(property, document, value);
-                }
-            } else {
-                parse_kubeconfig_yaml_property_mapping(property, document, value);
-            }
-        } else if (value->type == YAML_SEQUENCE_NODE) {
-            if (KUBECONFIG_PROPERTY_TYPE_USER_EXEC == property->type) {
-                if (0 == strcmp(key->data.scalar.value, KEY_USER_EXEC_ENV)) {
-                    parse_kubeconfig_yaml_string_mapping_sequence(&(property->envs), &(property->envs_count), document, value);
-                } else if (0 == strcmp(key->data.scalar.value, KEY_USER_EXEC_ARGS)) {
-                    parse_kubeconfig_yaml_string_sequence(&(property->args), &(property->args_count), document, value);
-                }
-            }
+    if ('"' == *p || '\'' == *p) {
+        grown = kubeyaml_realloc(*scratch, (size_t) (eol - p));
+        if (!grown) {
+            return PEEK_UNSUPPORTED;
         }
+        *scratch = grown;
     }
-
-    return 0;
+    return kubeconfig_scalar_scan(p, eol, *scratch, value, length, next);
 }
 
-static int parse_kubeconfig_yaml_property_sequence(kubeconfig_property_t *** p_properties, int *p_properties_count, kubeconfig_property_type_t type, yaml_document_t * document, yaml_node_t * node)
+/*
+ * The value of another top-level key must end on its line or continue on
+ * indented lines, which are skipped. A quoted scalar or a flow collection
+ * may go on in the first column, where the scan would take its lines for
+ * keys: only the empty "{}" and "[]" of kubectl are followed.
+ */
+static int peek_other_value(const char *p, const char *eol, char **scratch)
 {
-    yaml_node_item_t *item = NULL;
-    yaml_node_t *value = NULL;
-    int item_count = 0;
-    int i = 0;
+    const char *value = NULL;
+    const char *next = NULL;
+    size_t length = 0;
     int rc = 0;
 
-    // Get the count of data (e.g. cluster, context, user, user_exec )
-    for (item = node->data.sequence.items.start, item_count = 0; item < node->data.sequence.items.top; item++, item_count++) {
-        ;
+    while (p < eol && KUBECONFIG_SCALAR_IS_BLANK(*p)) {
+        p++;
     }
+    if (p == eol || '#' == *p) {
+        return PEEK_NOT_FOUND;
+    }
+    if (eol - p >= 2 && (0 == memcmp(p, "{}", 2) || 0 == memcmp(p, "[]", 2))) {
+        return kubeconfig_scalar_rest_is_empty(p + 2, eol) ? PEEK_NOT_FOUND : PEEK_UNSUPPORTED;
+    }
+    /* A flow collection, or an anchor or a tag in front of a quoted scalar. */
+    if ('{' == *p || '[' == *p || '&' == *p || '!' == *p) {
+        return PEEK_UNSUPPORTED;
+    }
+    if ('"' != *p && '\'' != *p) {
+        return PEEK_NOT_FOUND;
+    }
+    rc = peek_scalar(p, eol, scratch, &value, &length, &next);
+    if (rc) {
+        return rc;
+    }
+    return kubeconfig_scalar_rest_is_empty(next, eol) ? PEEK_NOT_FOUND : PEEK_UNSUPPORTED;
+}
 
-    int properties_count = item_count;
-    kubeconfig_property_t **properties = kubeconfig_properties_create(properties_count, type);
-    if (!properties) {
-        fprintf(stderr, "Cannot allocate memory for kubeconfig properties.\n");
-        return -1;
+/* A line of the top mapping, PEEK_NOT_FOUND if its key is not current-context. */
+static int peek_top_line(const char *p, const char *eol, char **scratch, const char **value, size_t *length)
+{
+    const char *key = NULL;
+    const char *next = NULL;
+    size_t key_length = 0;
+    int rc = 0;
+
+    if ('\t' == *p) {
+        return PEEK_UNSUPPORTED;
+    }
+    rc = peek_scalar(p, eol, scratch, &key, &key_length, &next);
+    if (rc) {
+        return rc;
+    }
+    if (next == eol || ':' != *next) {
+        return PEEK_UNSUPPORTED;
+    }
+    if (key_length != sizeof(peek_key) - 1 || 0 != memcmp(key, peek_key, key_length)) {
+        return peek_other_value(next + 1, eol, scratch);
     }
 
-    for (item = node->data.sequence.items.start, i = 0; item < node->data.sequence.items.top; item++, i++) {
-        value = yaml_document_get_node(document, *item);
-        rc = parse_kubeconfig_yaml_property_mapping(properties[i], document, value);
-        if (0 != rc) {
-            fprintf(stderr, "Cannot parse kubeconfig properties.\n");
-            return -1;
-        }
+    p = next + 1;
+    while (p < eol && KUBECONFIG_SCALAR_IS_BLANK(*p)) {
+        p++;
+    }
+    /* The value is on the following lines or is not a scalar. */
+    if (p == eol || '#' == *p || '{' == *p || '[' == *p) {
+        return PEEK_UNSUPPORTED;
+    }
+    rc = peek_scalar(p, eol, scratch, value, length, &next);
+    if (rc) {
+        return rc;
     }
+    if (!kubeconfig_scalar_rest_is_empty(next, eol)) {
+        return PEEK_UNSUPPORTED;
+    }
+    return 0;
+}
 
-    *p_properties = properties;
-    *p_properties_count = properties_count;
+/* An indented line after the value would continue it. */
+static int peek_value_end(const char *eol, const char *end)
+{
+    const char *p = eol;
 
+    while (p < end && ('\n' == *p || '\r' == *p)) {
+        p++;
+    }
+    if (p < end && (' ' == *p || '\t' == *p)) {
+        return PEEK_UNSUPPORTED;
+    }
     return 0;
-
 }
 
-static int parse_kubeconfig_yaml_top_mapping(kubeconfig_t * kubeconfig, yaml_document_t * document, yaml_node_t * node)
+static int peek_current_context_scan(const char *buf, size_t len, char **scratch, const char **value, size_t *length)
 {
-    static char fname[] = "parse_kubeconfig_yaml_top_mapping()";
+    const char *p = buf;
+    const char *end = buf + len;
+    const char *eol = NULL;
+    const char *line_end = NULL;
+    int has_key = 0;
     int rc = 0;
 
-    yaml_node_pair_t *pair = NULL;
-    yaml_node_t *key = NULL;
-    yaml_node_t *value = NULL;
-
-    for (pair = node->data.mapping.pairs.start; pair < node->data.mapping.pairs.top; pair++) {
-        key = yaml_document_get_node(document, pair->key);
-        value = yaml_document_get_node(document, pair->value);
-
-        if (key->type != YAML_SCALAR_NODE) {
-            fprintf(stderr, "%s: The key node is not YAML_SCALAR_NODE.\n", fname);
-            return -1;
+    while (p < end) {
+        eol = memchr(p, '\n', (size_t) (end - p));
+        if (!eol) {
+            eol = end;
         }
-
-        if (value->type == YAML_SCALAR_NODE) {
-            if (0 == strcmp(key->data.scalar.value, KEY_APIVERSION)) {
-                kubeconfig->apiVersion = strdup(value->data.scalar.value);
-            } else if (0 == strcmp(key->data.scalar.value, KEY_KIND)) {
-                kubeconfig->kind = strdup(value->data.scalar.value);
-            } else if (0 == strcmp(key->data.scalar.value, KEY_CURRENT_CONTEXT)) {
-                kubeconfig->current_context = strdup(value->data.scalar.value);
+        line_end = (eol > p && '\r' == eol[-1]) ? eol - 1 : eol;
+
+        if (p == line_end || ' ' == *p || '#' == *p) {
+            /* an empty line, a comment or a line nested in a top-level key */
+        } else if ('-' == *p && (p + 1 == line_end || KUBECONFIG_SCALAR_IS_BLANK(p[1]))) {
+            /* an entry of a top-level sequence, kubectl does not indent them */
+        } else if (line_end - p >= 3 && 0 == memcmp(p, "---", 3) && (line_end - p == 3 || KUBECONFIG_SCALAR_IS_BLANK(p[3]))) {
+            /* A later document could set current-context again. */
+            if (has_key || !kubeconfig_scalar_rest_is_empty(p + 3, line_end)) {
+                return PEEK_UNSUPPORTED;
             }
         } else {
-            if (0 == strcmp(key->data.scalar.value, KEY_CLUSTERS)) {
-                rc = parse_kubeconfig_yaml_property_sequence(&(kubeconfig->clusters), &(kubeconfig->clusters_count), KUBECONFIG_PROPERTY_TYPE_CLUSTER, document, value);
-            } else if (0 == strcmp(key->data.scalar.value, KEY_CONTEXTS)) {
-                rc = parse_kubeconfig_yaml_property_sequence(&(kubeconfig->contexts), &(kubeconfig->contexts_count), KUBECONFIG_PROPERTY_TYPE_CONTEXT, document, value);
-            } else if (0 == strcmp(key->data.scalar.value, KEY_USERS)) {
-                rc = parse_kubeconfig_yaml_property_sequence(&(kubeconfig->users), &(kubeconfig->users_count), KUBECONFIG_PROPERTY_TYPE_USER, document, value);
+            rc = peek_top_line(p, line_end, scratch, value, length);
+            if (PEEK_NOT_FOUND != rc) {
+                return rc ? rc : peek_value_end(eol, end);
             }
+            has_key = 1;
         }
-    }
 
-    return rc;
+        p = eol + 1;
+    }
+    return PEEK_NOT_FOUND;
 }
 
-static int parse_kubeconfig_yaml_node(kubeconfig_t * kubeconfig, yaml_document_t * document, yaml_node_t * node)
+static int peek_copy(char *buf, size_t len, const char *value, size_t length)
 {
-    static char fname[] = "parse_kubeconfig_yaml_node()";
-    int rc = 0;
+    static char fname[] = "kubeyaml_peek_current_context()";
 
-    if (YAML_MAPPING_NODE == node->type) {
-        rc = parse_kubeconfig_yaml_top_mapping(kubeconfig, document, node);
-    } else {
-        fprintf(stderr, "%s: %s is not a valid kubeconfig file.\n", fname, kubeconfig->fileName);
-        rc = -1;
+    if (length >= len) {
+        fprintf(stderr, "%s: The buffer is too small for the current context.\n", fname);
+        return -1;
     }
+    memcpy(buf, value, length);
+    buf[length] = '\0';
 
-    return rc;
+    return 0;
 }
 
-static int parse_kubeconfig_yaml_document(kubeconfig_t * kubeconfig, yaml_document_t * document)
+static int peek_current_context_load(const char *fileName, char *buf, size_t len)
 {
-    static char fname[] = "parse_kubeconfig_yaml_document()";
+    static char fname[] = "kubeyaml_peek_current_context()";
+
+    kubeconfig_t *kubeconfig = NULL;
     int rc = 0;
 
-    yaml_node_t *root;
-    root = yaml_document_get_root_node(document);
-    if (NULL == root) {
-        fprintf(stderr, "%s: The document is null\n", fname);
+    kubeconfig = kubeconfig_create();
+    if (!kubeconfig) {
+        fprintf(stderr, "%s: Cannot allocate memory for kubeconfig.\n", fname);
+        return -1;
+    }
+    kubeconfig->fileName = kubeyaml_strdup(fileName);
+    if (!kubeconfig->fileName) {
+        fprintf(stderr, "%s: Cannot allocate memory for the file name.\n", fname);
+        kubeconfig_free(kubeconfig);
         return -1;
     }
 
-    rc = parse_kubeconfig_yaml_node(kubeconfig, document, root);
+    rc = kubeyaml_load_kubeconfig(kubeconfig);
+    if (0 == rc) {
+        const char *current_context = kubeconfig->current_context ? kubeconfig->current_context : "";
+        rc = peek_copy(buf, len, current_context, strlen(current_context));
+    }
 
+    kubeconfig_free(kubeconfig);
     return rc;
 }
 
-int kubeyaml_load_kubeconfig(kubeconfig_t * kubeconfig)
+int kubeyaml_peek_current_context(const char *fileName, char *buf, size_t len)
 {
-    static char fname[] = "kubeyaml_load_kubeconfig()";
-
-    yaml_parser_t parser;
-    yaml_document_t document;
-
-    int done = 0;
-
-    /* Create the Parser object. */
-    yaml_parser_initialize(&parser);
-
-    /* Set a file input. */
-    FILE *input = NULL;
-    if (kubeconfig->fileName) {
-        input = fopen(kubeconfig->fileName, "rb");
-        if (!input) {
-            fprintf(stderr, "%s: Cannot open the file %s.[%s]\n", fname, kubeconfig->fileName, strerror(errno));
-            return -1;
-        }
-    } else {
-        fprintf(stderr, "%s: The kubeconf file name needs be set by kubeconfig->fileName .\n", fname);
+    static char fname[] = "kubeyaml_peek_current_context()";
+
+    struct stat st;
+    void *map = NULL;
+    char *scratch = NULL;
+    const char *value = NULL;
+    size_t length = 0;
+    int fd = -1;
+    int rc = PEEK_UNSUPPORTED;
+
+    if (!fileName || !buf || 0 == len) {
+        fprintf(stderr, "%s: The file name or the buffer is invalid.\n", fname);
         return -1;
     }
 
-    yaml_parser_set_input_file(&parser, input);
-
-    while (!done) {
-
-        if (!yaml_parser_load(&parser, &document)) {
-            goto error;
+    fd = open(fileName, O_RDONLY);
+    if (-1 == fd) {
+        fprintf(stderr, "%s: Cannot open the file %s.[%s]\n", fname, fileName, strerror(errno));
+        return -1;
+    }
+    /* Other files and empty ones are left to the loader. */
+    if (0 == fstat(fd, &st) && S_ISREG(st.st_mode) && st.st_size > 0) {
+        map = mmap(NULL, (size_t) st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (MAP_FAILED == map) {
+            map = NULL;
         }
+    }
+    close(fd);
 
-        done = (!yaml_document_get_root_node(&document));
-
-        if (!done) {
-            parse_kubeconfig_yaml_document(kubeconfig, &document);
+    if (map) {
+        rc = peek_current_context_scan(map, (size_t) st.st_size, &scratch, &value, &length);
+        if (PEEK_NOT_FOUND == rc) {
+            rc = peek_copy(buf, len, "", 0);
+        } else if (0 == rc) {
+            rc = peek_copy(buf, len, value, length);
         }
-
-        yaml_document_delete(&document);
-
+        munmap(map, (size_t) st.st_size);
+    }
+    if (scratch) {
+        kubeyaml_free(scratch);
     }
 
-    /* Cleanup */
-    yaml_parser_delete(&parser);
-    fclose(input);
-    return 0;
-
-  error:
-    yaml_parser_delete(&parser);
-    fclose(input);
-    return -1;
+    if (PEEK_UNSUPPORTED == rc) {
+        return peek_current_context_load(fileName, buf, len);
+    }
+    return rc;
 }
 
 static int parse_exec_credential_yaml_status_mapping(ExecCredential_status_t ** p_status, yaml_document_t * document, yaml_node_t * node)
@@ -453,15 +2998,21 @@ static int parse_exec_credential_yaml_status_mapping(ExecCredential_status_t **
         }
 
         if (value->type == YAML_SCALAR_NODE) {
-            if (0 == strcmp(key->data.scalar.value, KEY_TOKEN)) {
-                status->token = strdup(value->data.scalar.value);
+            switch (kubeconfig_key_lookup((const char *) key->data.scalar.value, key->data.scalar.length)) {
+            case KUBECONFIG_KEY_TOKEN:
+                status->token = kubeyaml_strdup(value->data.scalar.value);
                 status->type = EXEC_CREDENTIAL_TYPE_TOKEN;
-            } else if (0 == strcmp(key->data.scalar.value, KEY_CLIENT_CERTIFICATE_DATA2)) {
-                status->clientCertificateData = strdup(value->data.scalar.value);
+                break;
+            case KUBECONFIG_KEY_CLIENT_CERTIFICATE_DATA2:
+                status->clientCertificateData = kubeyaml_strdup(value->data.scalar.value);
                 status->type = EXEC_CREDENTIAL_TYPE_CLIENT_CERT;
-            } else if (0 == strcmp(key->data.scalar.value, KEY_CLIENT_KEY_DATA2)) {
-                status->clientKeyData = strdup(value->data.scalar.value);
+                break;
+            case KUBECONFIG_KEY_CLIENT_KEY_DATA2:
+                status->clientKeyData = kubeyaml_strdup(value->data.scalar.value);
                 status->type = EXEC_CREDENTIAL_TYPE_CLIENT_CERT;
+                break;
+            default:
+                break;
             }
         }
     }
@@ -480,6 +3031,11 @@ static int parse_exec_credential_yaml_top_mapping(ExecCredential_t * exec_creden
     yaml_node_t *key = NULL;
     yaml_node_t *value = NULL;
 
+    /* An entry that is not a mapping is an empty pair. */
+    if (YAML_MAPPING_NODE != node->type) {
+        return 0;
+    }
+
     for (pair = node->data.mapping.pairs.start; pair < node->data.mapping.pairs.top; pair++) {
         key = yaml_document_get_node(document, pair->key);
         value = yaml_document_get_node(document, pair->value);
@@ -490,13 +3046,18 @@ static int parse_exec_credential_yaml_top_mapping(ExecCredential_t * exec_creden
         }
 
         if (value->type == YAML_SCALAR_NODE) {
-            if (0 == strcmp(key->data.scalar.value, KEY_APIVERSION)) {
-                exec_credential->apiVersion = strdup(value->data.scalar.value);
-            } else if (0 == strcmp(key->data.scalar.value, KEY_KIND)) {
-                exec_credential->kind = strdup(value->data.scalar.value);
+            switch (kubeconfig_key_lookup((const char *) key->data.scalar.value, key->data.scalar.length)) {
+            case KUBECONFIG_KEY_APIVERSION:
+                exec_credential->apiVersion = kubeyaml_strdup(value->data.scalar.value);
+                break;
+            case KUBECONFIG_KEY_KIND:
+                exec_credential->kind = kubeyaml_strdup(value->data.scalar.value);
+                break;
+            default:
+                break;
             }
         } else {
-            if (0 == strcmp(key->data.scalar.value, KEY_STAUTS)) {
+            if (KUBECONFIG_KEY_STATUS == kubeconfig_key_lookup((const char *) key->data.scalar.value, key->data.scalar.length)) {
                 rc = parse_exec_credential_yaml_status_mapping(&(exec_credential->status), document, value);
             }
         }
@@ -537,25 +3098,16 @@ static int parse_exec_credential_yaml_document(ExecCredential_t * exec_credentia
     return rc;
 }
 
-int kubeyaml_parse_exec_crendential(ExecCredential_t * exec_credential, const char *exec_credential_string)
+static int parse_exec_credential_yaml_parser(ExecCredential_t * exec_credential, yaml_parser_t * parser)
 {
-    static char fname[] = "kubeyaml_parse_ExecCrendentail()";
-
-    yaml_parser_t parser;
     yaml_document_t document;
 
     int done = 0;
 
-    /* Create the Parser object. */
-    yaml_parser_initialize(&parser);
-
-    /* Set a string input. */
-    yaml_parser_set_input_string(&parser, exec_credential_string, strlen(exec_credential_string));
-
     while (!done) {
 
-        if (!yaml_parser_load(&parser, &document)) {
-            goto error;
+        if (!yaml_parser_load(parser, &document)) {
+            return -1;
         }
 
         done = (!yaml_document_get_root_node(&document));
@@ -568,13 +3120,80 @@ int kubeyaml_parse_exec_crendential(ExecCredential_t * exec_credential, const ch
 
     }
 
+    return 0;
+}
+
+int kubeyaml_parse_exec_crendential_with_context(kubeyaml_context_t * context, ExecCredential_t * exec_credential, const char *exec_credential_string)
+{
+    static char fname[] = "kubeyaml_parse_ExecCrendentail()";
+
+    yaml_parser_t parser;
+    size_t len = strlen(exec_credential_string);
+    int rc = 0;
+
+    /* Exec plugins print JSON, which is parsed without libyaml unless it leaves what kubeconfig_json_parse_exec_credential() handles. */
+    if (context) {
+        rc = kubeconfig_json_parse_exec_credential_with_scratch(exec_credential, exec_credential_string, len, &context->scratch, &context->scratch_size);
+    } else {
+        rc = kubeconfig_json_parse_exec_credential(exec_credential, exec_credential_string, len);
+    }
+    if (KUBECONFIG_JSON_UNSUPPORTED != rc) {
+        return rc;
+    }
+
+    /* Create the Parser object. */
+    yaml_parser_initialize(&parser);
+
+    /* Set a string input. */
+    yaml_parser_set_input_string(&parser, exec_credential_string, len);
+
+    rc = parse_exec_credential_yaml_parser(exec_credential, &parser);
+
     /* Cleanup */
     yaml_parser_delete(&parser);
-    return 0;
+    return rc;
+}
+
+int kubeyaml_parse_exec_crendential(ExecCredential_t * exec_credential, const char *exec_credential_string)
+{
+    return kubeyaml_parse_exec_crendential_with_context(NULL, exec_credential, exec_credential_string);
+}
+
+int kubeyaml_parse_exec_crendential_from_reader(ExecCredential_t * exec_credential, kubeyaml_read_handler_t handler, void *data)
+{
+    static char fname[] = "kubeyaml_parse_exec_crendential_from_reader()";
 
-  error:
+    yaml_parser_t parser;
+    int rc = 0;
+
+    if (!handler) {
+        fprintf(stderr, "%s: The read handler is null.\n", fname);
+        return -1;
+    }
+
+    /* Create the Parser object. */
+    yaml_parser_initialize(&parser);
+
+    /* Pull the input through the caller's handler as the parser needs it. */
+    yaml_parser_set_input(&parser, (yaml_read_handler_t *) handler, data);
+
+    rc = parse_exec_credential_yaml_parser(exec_credential, &parser);
+
+    /* Cleanup */
     yaml_parser_delete(&parser);
-    return -1;
+    return rc;
+}
+
+int kubeyaml_parse_exec_crendential_from_fd(ExecCredential_t * exec_credential, int fd)
+{
+    static char fname[] = "kubeyaml_parse_exec_crendential_from_fd()";
+
+    if (fd < 0) {
+        fprintf(stderr, "%s: The file descriptor %d is invalid.\n", fname, fd);
+        return -1;
+    }
+
+    return kubeyaml_parse_exec_crendential_from_reader(exec_credential, read_fd_handler, &fd);
 }
 
 static int append_key_stringvalue_to_mapping_node(yaml_document_t* output_document, int parent_node, const char *key_string, const char *value_string)
@@ -745,7 +3364,29 @@ int append_key_kvpseq_to_mapping_node(yaml_document_t* output_document, int pare
     return 0;
 }
 
-static int append_key_map_to_mapping_node(yaml_document_t* output_document, int parent_node, const char *key_string, const kubeconfig_property_t* property)
+/* Add a *-data field, encoded again if the kubeconfig holds it decoded. */
+static int append_key_datavalue_to_mapping_node(yaml_document_t* output_document, int parent_node, const char *key_string, const kubeconfig_t* kubeconfig, const char *value_string, const kubeconfig_data_t* data)
+{
+    char *text = NULL;
+    int rc = 0;
+
+    if (!kubeconfig->data_decoded) {
+        return append_key_stringvalue_to_mapping_node(output_document, parent_node, key_string, value_string);
+    }
+    if (data->length > (SIZE_MAX - 1) / 4 * 3) {
+        return -1;
+    }
+    text = kubeyaml_malloc(KUBECONFIG_BASE64_ENCODED_LENGTH(data->length) + 1);
+    if (!text) {
+        return -1;
+    }
+    kubeconfig_base64_encode(data->data, data->length, text);
+    rc = append_key_stringvalue_to_mapping_node(output_document, parent_node, key_string, text);
+    kubeyaml_free(text);
+    return rc;
+}
+
+static int append_key_map_to_mapping_node(yaml_document_t* output_document, int parent_node, const char *key_string, const kubeconfig_t* kubeconfig, const kubeconfig_property_t* property)
 {
     int key = yaml_document_add_scalar(output_document, NULL, (yaml_char_t*)key_string, -1, YAML_PLAIN_SCALAR_STYLE);
     if (!key) {
@@ -787,7 +3428,7 @@ static int append_key_map_to_mapping_node(yaml_document_t* output_document, int
     } else if (KUBECONFIG_PROPERTY_TYPE_CLUSTER == property->type) {
         /* Add 'certificate-authority-data': '' */
         if (property->certificate_authority_data) {
-            if (-1 == append_key_stringvalue_to_mapping_node(output_document, map, KEY_CERTIFICATE_AUTHORITY_DATA, property->certificate_authority_data)) {
+            if (-1 == append_key_datavalue_to_mapping_node(output_document, map, KEY_CERTIFICATE_AUTHORITY_DATA, kubeconfig, property->certificate_authority_data, property->certificate_authority_data_decoded)) {
                 return -1;
             }
         }
@@ -801,28 +3442,28 @@ static int append_key_map_to_mapping_node(yaml_document_t* output_document, int
     } else if (KUBECONFIG_PROPERTY_TYPE_USER == property->type) {
         /* Add 'auth-provider': {} */
         if (property->auth_provider) {
-            if (-1 == append_key_map_to_mapping_node(output_document, map, KEY_USER_AUTH_PROVIDER, property->auth_provider)) {
+            if (-1 == append_key_map_to_mapping_node(output_document, map, KEY_USER_AUTH_PROVIDER, kubeconfig, property->auth_provider)) {
                 return -1;
             }
         }
 
         /* Add 'client-certificate-data': '' */
         if (property->client_certificate_data) {
-            if (-1 == append_key_stringvalue_to_mapping_node(output_document, map, KEY_CLIENT_CERTIFICATE_DATA, property->client_certificate_data)) {
+            if (-1 == append_key_datavalue_to_mapping_node(output_document, map, KEY_CLIENT_CERTIFICATE_DATA, kubeconfig, property->client_certificate_data, property->client_certificate_data_decoded)) {
                 return -1;
             }
         }
 
         /* Add 'client-key-data': '' */
         if (property->client_key_data) {
-            if (-1 == append_key_stringvalue_to_mapping_node(output_document, map, KEY_CLIENT_KEY_DATA, property->client_key_data)) {
+            if (-1 == append_key_datavalue_to_mapping_node(output_document, map, KEY_CLIENT_KEY_DATA, kubeconfig, property->client_key_data, property->client_key_data_decoded)) {
                 return -1;
             }
         }
 
         /* Add 'exec': {} */
         if (property->exec) {
-            if (-1 == append_key_map_to_mapping_node(output_document, map, KEY_USER_EXEC, property->exec)) {
+            if (-1 == append_key_map_to_mapping_node(output_document, map, KEY_USER_EXEC, kubeconfig, property->exec)) {
                 return -1;
             }
         }
@@ -863,7 +3504,7 @@ static int append_key_map_to_mapping_node(yaml_document_t* output_document, int
     return 0;
 }
 
-static int append_key_seq_to_top_mapping_node(yaml_document_t* output_document, int parent_node, const char *first_level_key_string, const char *second_level_key_string, kubeconfig_property_t** properites, int properites_count)
+static int append_key_seq_to_top_mapping_node(yaml_document_t* output_document, int parent_node, const char *first_level_key_string, const char *second_level_key_string, const kubeconfig_t* kubeconfig, kubeconfig_property_t** properites, int properites_count)
 {
     int key = yaml_document_add_scalar(output_document, NULL, (yaml_char_t *)first_level_key_string, -1, YAML_PLAIN_SCALAR_STYLE);
     if (!key) {
@@ -890,7 +3531,7 @@ static int append_key_seq_to_top_mapping_node(yaml_document_t* output_document,
         if (NULL != strstr(second_level_key_string, KEY_CLUSTER) ||
             NULL != strstr(second_level_key_string, KEY_CONTEXT)) {
             /* Add 'cluster/context': {} */
-            if (-1 == append_key_map_to_mapping_node(output_document, map, second_level_key_string, properites[i])) {
+            if (-1 == append_key_map_to_mapping_node(output_document, map, second_level_key_string, kubeconfig, properites[i])) {
                 return -1;
             }
         }
@@ -902,7 +3543,7 @@ static int append_key_seq_to_top_mapping_node(yaml_document_t* output_document,
 
         if (NULL != strstr(second_level_key_string, KEY_USER)) {
             /* Add 'user': {} */
-            if (-1 == append_key_map_to_mapping_node(output_document, map, second_level_key_string, properites[i])) {
+            if (-1 == append_key_map_to_mapping_node(output_document, map, second_level_key_string, kubeconfig, properites[i])) {
                 return -1;
             }
         }
@@ -924,12 +3565,12 @@ static int fill_yaml_document(yaml_document_t* output_document, const kubeconfig
     }
 
     /* Add 'clusters': {} */
-    if (-1 == append_key_seq_to_top_mapping_node(output_document, root, KEY_CLUSTERS, KEY_CLUSTER, kubeconfig->clusters, kubeconfig->clusters_count)) {
+    if (-1 == append_key_seq_to_top_mapping_node(output_document, root, KEY_CLUSTERS, KEY_CLUSTER, kubeconfig, kubeconfig->clusters, kubeconfig->clusters_count)) {
         return -1;
     }
 
     /* Add 'contexts': {} */
-    if (-1 == append_key_seq_to_top_mapping_node(output_document, root, KEY_CONTEXTS, KEY_CONTEXT, kubeconfig->contexts, kubeconfig->contexts_count)) {
+    if (-1 == append_key_seq_to_top_mapping_node(output_document, root, KEY_CONTEXTS, KEY_CONTEXT, kubeconfig, kubeconfig->contexts, kubeconfig->contexts_count)) {
         return -1;
     }
 
@@ -944,12 +3585,12 @@ static int fill_yaml_document(yaml_document_t* output_document, const kubeconfig
     }
 
     /* Add 'preferences': {} */
-    if (-1 == append_key_map_to_mapping_node(output_document, root, KEY_PREFERENCES, NULL)) {
+    if (-1 == append_key_map_to_mapping_node(output_document, root, KEY_PREFERENCES, kubeconfig, NULL)) {
         return -1;
     }
 
     /* Add 'users': {} */
-    if (-1 == append_key_seq_to_top_mapping_node(output_document, root, KEY_USERS, KEY_USER, kubeconfig->users, kubeconfig->users_count)) {
+    if (-1 == append_key_seq_to_top_mapping_node(output_document, root, KEY_USERS, KEY_USER, kubeconfig, kubeconfig->users, kubeconfig->users_count)) {
         return -1;
     }
 
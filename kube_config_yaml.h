@@ -1,12 +1,66 @@
 #ifndef _KUBE_CONFIG_YAML_H
 #define _KUBE_CONFIG_YAML_H
 
+#include <stddef.h>
 #include "kube_config_model.h"
 
 #ifdef  __cplusplus
 extern "C" {
 #endif                          /* __cplusplus */
 
+/*
+ * kubeyaml_read_handler_t
+ *
+ * Description:
+ *
+ * Read callback used to pull the parser input from the caller (e.g. the
+ * stdout pipe of an exec plugin or a socket). The handler is called each
+ * time the parser needs more bytes.
+ *
+ * Return:
+ *
+ *   1     Success, *size_read is set to 0 at the end of the input
+ *   0     Failed
+ *
+ * Parameter:
+ *
+ * IN:
+ * data: the pointer passed to the *_from_reader() function
+ * size: size of buffer in bytes
+ *
+ * OUT:
+ * buffer: filled with at most size bytes of input
+ * size_read: number of bytes written to buffer
+ *
+ */
+    typedef int (*kubeyaml_read_handler_t) (void *data, unsigned char *buffer, size_t size, size_t * size_read);
+
+/*
+ * kubeyaml_context_t
+ *
+ * Description:
+ *
+ * Buffers kept between loads and parses: the scratch buffer of the fast
+ * path and the JSON parser and the NUL terminators of a zero-copy load. A
+ * caller that loads many kubeconfigs or parses many exec credentials
+ * passes the same context to each call instead of paying for their
+ * allocation every time. The libyaml parser of an input the fast path does
+ * not handle is not kept.
+ *
+ * The buffers keep the size they grew to until the context is freed. A
+ * context may be used by one call at a time, a multi-threaded caller needs
+ * one context per thread.
+ *
+ */
+    typedef struct kubeyaml_context_t kubeyaml_context_t;
+
+/*
+ * Return a new context, or NULL if the memory cannot be allocated.
+ */
+    kubeyaml_context_t *kubeyaml_context_create(void);
+
+    void kubeyaml_context_free(kubeyaml_context_t * context);
+
 /*
  * kubeyaml_load_kubeconfig
  *
@@ -15,6 +69,13 @@ extern "C" {
  * Load the kubeconfig file specified by kubeconfig->fileName
  * and get the kuberntes configuration for other fields of kubeconfig.
  *
+ * A gzip or zstd compressed file, recognized by its magic bytes, is
+ * decompressed as the parser reads it; the decompressed text is never
+ * written out nor held as a whole. The same goes for the buffers of
+ * kubeyaml_load_kubeconfig_from_buffer() and the mapped files of
+ * kubeyaml_load_kubeconfig_mmap(). zstd needs a library built with
+ * KUBEYAML_WITH_ZSTD.
+ *
  * Return:
  *
  *   0     Success
@@ -31,6 +92,375 @@ extern "C" {
  */
     int kubeyaml_load_kubeconfig(kubeconfig_t * kubeconfig);
 
+/*
+ * kubeyaml_load_kubeconfig_mmap
+ *
+ * Description:
+ *
+ * Load the kubeconfig file specified by kubeconfig->fileName like
+ * kubeyaml_load_kubeconfig(), but map the file read-only into memory
+ * and feed it to the parser as one contiguous buffer instead of reading
+ * it through stdio. The mapping is released before returning.
+ *
+ * Return:
+ *
+ *   0     Success
+ *  -1     Failed
+ *
+ * Parameter:
+ *
+ * IN:
+ * kubeconfig->fileName: kubernetes cluster configuration file name, must be a regular file
+ *
+ * OUT:
+ * kubeconfig: kubernetes cluster configuration
+ *
+ */
+    int kubeyaml_load_kubeconfig_mmap(kubeconfig_t * kubeconfig);
+
+/*
+ * kubeyaml_load_kubeconfig_from_buffer
+ *
+ * Description:
+ *
+ * Load the kubeconfig from an in-memory buffer (e.g. the data of a
+ * kubernetes secret) instead of the file kubeconfig->fileName.
+ * The buffer is parsed in place and is not copied, it does not need
+ * to be NUL-terminated.
+ *
+ * Return:
+ *
+ *   0     Success
+ *  -1     Failed
+ *
+ * Parameter:
+ *
+ * IN:
+ * buf: text of the kubeconfig
+ * len: length of buf in bytes
+ *
+ * OUT:
+ * kubeconfig: kubernetes cluster configuration
+ *
+ */
+    int kubeyaml_load_kubeconfig_from_buffer(kubeconfig_t * kubeconfig, const char *buf, size_t len);
+
+/*
+ * kubeyaml_load_kubeconfig_from_reader
+ *
+ * Description:
+ *
+ * Load the kubeconfig from a stream of bytes delivered by the read handler,
+ * the input is parsed as it arrives and is never buffered as a whole.
+ *
+ * Return:
+ *
+ *   0     Success
+ *  -1     Failed
+ *
+ * Parameter:
+ *
+ * IN:
+ * handler: read callback delivering the text of the kubeconfig
+ * data: caller data passed to each call of handler
+ *
+ * OUT:
+ * kubeconfig: kubernetes cluster configuration
+ *
+ */
+    int kubeyaml_load_kubeconfig_from_reader(kubeconfig_t * kubeconfig, kubeyaml_read_handler_t handler, void *data);
+
+/*
+ * kubeyaml_load_kubeconfig_from_fd
+ *
+ * Description:
+ *
+ * Load the kubeconfig by reading the file descriptor fd until the end of
+ * the input. The descriptor is not closed.
+ *
+ * Return:
+ *
+ *   0     Success
+ *  -1     Failed
+ *
+ * Parameter:
+ *
+ * IN:
+ * fd: readable file descriptor, e.g. a pipe or a socket
+ *
+ * OUT:
+ * kubeconfig: kubernetes cluster configuration
+ *
+ */
+    int kubeyaml_load_kubeconfig_from_fd(kubeconfig_t * kubeconfig, int fd);
+
+/*
+ * kubeyaml_load_kubeconfig_from_secret
+ *
+ * Description:
+ *
+ * Load the kubeconfig stored base64-encoded in the data of a Secret
+ * manifest, YAML or JSON, e.g. the "<cluster>-kubeconfig" Secrets of
+ * Cluster API. The data is decoded as the parser reads it, without a
+ * decoded copy of the kubeconfig.
+ *
+ * Return:
+ *
+ *   0     Success
+ *  -1     Failed
+ *
+ * Parameter:
+ *
+ * IN:
+ * buf: text of the Secret manifest
+ * len: length of buf in bytes
+ * key: key of the kubeconfig in the data of the Secret, NULL for "value"
+ *
+ * OUT:
+ * kubeconfig: kubernetes cluster configuration
+ *
+ */
+    int kubeyaml_load_kubeconfig_from_secret(kubeconfig_t * kubeconfig, const char *buf, size_t len, const char *key);
+
+#define KUBEYAML_LOAD_MMAP      0x0001  /* map kubeconfig->fileName instead of reading it through stdio */
+#define KUBEYAML_LOAD_EVENTS    0x0002  /* fill the kubeconfig from parser events without building a document tree */
+#define KUBEYAML_LOAD_NO_FAST_PATH 0x0004     /* always parse with libyaml, even if the input is in the subset the fast path handles */
+#define KUBEYAML_LOAD_ZERO_COPY 0x0008  /* keep the input and point the plain scalars into it instead of copying them */
+#define KUBEYAML_LOAD_CURRENT_CONTEXT 0x0010  /* select the current context, see options->contexts */
+#define KUBEYAML_LOAD_PARALLEL  0x0020  /* scan the entries of clusters, contexts and users on options->threads threads */
+#define KUBEYAML_LOAD_ARENA     0x0040  /* allocate the strings, properties and arrays of the kubeconfig from an arena */
+#define KUBEYAML_LOAD_INTERN    0x0080  /* keep one copy of equal names, see kubeconfig->strings */
+#define KUBEYAML_LOAD_DECODE_DATA 0x0100        /* decode the base64 of the *-data fields, see kubeconfig_data_t */
+
+#define KUBEYAML_SKIP_AUTH_PROVIDER 0x0001      /* do not load the auth-provider of the users */
+#define KUBEYAML_SKIP_EXEC      0x0002  /* do not load the exec of the users */
+#define KUBEYAML_SKIP_DATA      0x0004  /* do not load the certificate and key *-data fields */
+
+    typedef struct kubeyaml_load_options_t {
+        unsigned int flags;     /* KUBEYAML_LOAD_* */
+        const char *buffer;     /* load this buffer instead of kubeconfig->fileName */
+        size_t buffer_length;
+        kubeyaml_read_handler_t read_handler;   /* or pull the input through this handler */
+        void *read_handler_data;
+        const char *const *contexts;    /* only load these contexts and the clusters and users they refer to */
+        int contexts_count;
+        unsigned int skip_fields;       /* KUBEYAML_SKIP_* */
+        kubeyaml_context_t *context;    /* reuse the buffers of this context, NULL for fresh ones */
+        int threads;            /* threads of KUBEYAML_LOAD_PARALLEL, 0 or less for the number of online CPUs */
+    } kubeyaml_load_options_t;
+
+/*
+ * kubeyaml_load_kubeconfig_with_options
+ *
+ * Description:
+ *
+ * Load the kubeconfig like kubeyaml_load_kubeconfig() with the input
+ * and the loading mode selected by options:
+ *
+ * The input is options->buffer if it is set, otherwise the bytes returned
+ * by options->read_handler if it is set, otherwise the file specified by
+ * kubeconfig->fileName.
+ *
+ * KUBEYAML_LOAD_MMAP maps the file instead of reading it through stdio,
+ * see kubeyaml_load_kubeconfig_mmap().
+ *
+ * KUBEYAML_LOAD_EVENTS fills the kubeconfig directly from the libyaml event
+ * stream instead of loading a yaml document tree and walking it, which
+ * lowers peak memory and the number of allocations for large files.
+ * YAML aliases are not supported in this mode.
+ *
+ * Files and buffers are first scanned by a fast path that only handles the
+ * YAML subset kubectl writes (block collections, single-line scalars, no
+ * anchors, tags or block scalars), or JSON when the input starts with '{'.
+ * Any other input is parsed by libyaml with the same result.
+ * KUBEYAML_LOAD_NO_FAST_PATH always uses libyaml. Compressed files and
+ * buffers are streamed to libyaml, see kubeyaml_load_kubeconfig().
+ *
+ * KUBEYAML_LOAD_ZERO_COPY keeps the input in kubeconfig->buffer when the
+ * fast path handles it: the plain scalars that need no unescaping are not
+ * copied, the strings of the kubeconfig point into the input and are
+ * NUL-terminated in place, over the blank or line break that follows them.
+ * Quoted scalars are still copied, and so is all of a compressed input.
+ * The file read or mapped for the load is released by kubeconfig_free();
+ * options->buffer must then be writable and stay valid until
+ * kubeconfig_free(). A kubeconfig that holds a buffer cannot be loaded
+ * again.
+ *
+ * options->contexts selects contexts by name, KUBEYAML_LOAD_CURRENT_CONTEXT
+ * selects the current context. When contexts are selected, only they and
+ * the clusters and users they refer to are loaded, the other entries of
+ * clusters, contexts and users are skipped without copying their content,
+ * and without checking it.
+ * options->skip_fields leaves the fields of the KUBEYAML_SKIP_* mask NULL.
+ *
+ * options->context lends the buffers of a context to the load,
+ * see kubeyaml_context_t.
+ *
+ * KUBEYAML_LOAD_PARALLEL splits the entries of clusters, contexts and
+ * users of a large file or buffer into shards scanned by the fast path on
+ * options->threads threads, the calling thread included. The result is the
+ * same as without it. Inputs with few entries, JSON, zero-copy loads,
+ * selected contexts and inputs the fast path does not handle are loaded
+ * on the calling thread only. The context of options is not used by the
+ * threads.
+ *
+ * KUBEYAML_LOAD_ARENA allocates the strings, properties and arrays of the
+ * kubeconfig from a few large chunks of an arena, kubeconfig->arena,
+ * instead of one malloc() each. kubeconfig_free() then frees the chunks
+ * without walking the entries, and a load that fails leaves nothing to
+ * clean up but the arena. The kubeconfig must be empty or already have an
+ * arena, later loads into it use the arena too. Memory of the entries a
+ * later load replaces is only freed with the kubeconfig.
+ *
+ * KUBEYAML_LOAD_INTERN interns the names and the values that repeat
+ * across entries in a table of the kubeconfig, kubeconfig->strings: the
+ * name, cluster, namespace and user of contexts, the names of clusters
+ * and users, current-context and the command and apiVersion of exec. Equal
+ * strings are then one copy, so the cluster of a context can be found by
+ * comparing pointers with the names of the clusters. The interned strings
+ * are freed with the table, the caller must not free them, and later loads
+ * into the kubeconfig intern too. KUBEYAML_LOAD_PARALLEL is not used with
+ * it.
+ *
+ * KUBEYAML_LOAD_DECODE_DATA decodes certificate-authority-data,
+ * client-certificate-data and client-key-data once the kubeconfig is
+ * loaded: kubeconfig->data_decoded is set and these fields hold a
+ * kubeconfig_data_t, to be read through their *_decoded members, e.g.
+ * cluster->certificate_authority_data_decoded->data. The bytes take a
+ * quarter less memory than the text and need no decoding before a TLS
+ * setup. kubeyaml_save_kubeconfig() encodes them again. A field that is
+ * not valid base64 fails the load and is left NULL. A kubeconfig holding
+ * decoded fields cannot be loaded again.
+ *
+ * Return:
+ *
+ *   0     Success
+ *  -1     Failed
+ *
+ * Parameter:
+ *
+ * IN:
+ * kubeconfig->fileName: kubernetes cluster configuration file name, unless the input is a buffer or a read handler
+ * options: input and loading mode, NULL loads kubeconfig->fileName like kubeyaml_load_kubeconfig()
+ *
+ * OUT:
+ * kubeconfig: kubernetes cluster configuration
+ *
+ */
+    int kubeyaml_load_kubeconfig_with_options(kubeconfig_t * kubeconfig, const kubeyaml_load_options_t * options);
+
+/*
+ * kubeyaml_load_kubeconfig_documents
+ *
+ * Description:
+ *
+ * Load each document of a stream of YAML documents, e.g. a dump of many
+ * kubeconfigs separated by "---", into its own kubeconfig. The documents
+ * are found by their "---" lines and loaded in parallel by threads worker
+ * threads, the calling thread included.
+ *
+ * options selects the loading mode of each document like in
+ * kubeyaml_load_kubeconfig_with_options(), its input fields, context and
+ * KUBEYAML_LOAD_PARALLEL are ignored.
+ * With KUBEYAML_LOAD_ZERO_COPY, buf must be writable and stay valid until
+ * the kubeconfigs are freed.
+ *
+ * Return:
+ *
+ *   0     Success
+ *  -1     Failed, one of the documents cannot be loaded, no kubeconfig is returned
+ *
+ * Parameter:
+ *
+ * IN:
+ * buf: text of the documents
+ * len: length of buf in bytes
+ * options: loading mode, NULL for the default one
+ * threads: number of threads, 0 or less for the number of online CPUs
+ *
+ * OUT:
+ * kubeconfigs: array of *count kubeconfigs in the order of the documents, the caller needs to free it with kubeconfig_list_free()
+ * count: number of documents, 0 if buf has none
+ *
+ */
+    int kubeyaml_load_kubeconfig_documents(const char *buf, size_t len, const kubeyaml_load_options_t * options, int threads, kubeconfig_t *** kubeconfigs, int *count);
+
+/*
+ * Handler of kubeyaml_foreach(): entry is a cluster, a context or a user,
+ * see entry->type. It is freed when the handler returns, the handler
+ * copies what it needs to keep. Return 0 to go on with the next entry,
+ * anything else to stop.
+ */
+    typedef int (*kubeyaml_foreach_handler_t) (void *data, const kubeconfig_property_t * entry);
+
+/*
+ * kubeyaml_foreach
+ *
+ * Description:
+ *
+ * Pass the entries of clusters, contexts and users to handler one at a
+ * time, in the order of the input, without loading them into the
+ * kubeconfig. The input is streamed through the libyaml event parser and
+ * each entry is freed before the next one is read, so the memory used does
+ * not grow with the size of the input. apiVersion, kind and
+ * current-context are still loaded into the kubeconfig.
+ *
+ * The input is selected by options like in
+ * kubeyaml_load_kubeconfig_with_options(), compressed inputs included.
+ * options->skip_fields is used, options->context, the other loading modes
+ * and the selection of contexts are ignored. YAML aliases are not
+ * supported. When clusters, contexts or users appear more than once, e.g.
+ * in several documents, the entries of each occurrence are passed. A
+ * kubeconfig loaded with KUBEYAML_LOAD_ARENA is refused.
+ *
+ * Return:
+ *
+ *   0     Success, all the entries are passed
+ *   1     handler stopped the iteration
+ *  -1     Failed, the entries passed before the error stay passed
+ *
+ * Parameter:
+ *
+ * IN:
+ * kubeconfig->fileName: kubernetes cluster configuration file name, unless the input is a buffer or a read handler
+ * options: input, NULL for kubeconfig->fileName
+ * handler: called for each entry
+ * data: passed to handler
+ *
+ * OUT:
+ * kubeconfig: apiVersion, kind and current_context of the kubernetes cluster configuration
+ *
+ */
+    int kubeyaml_foreach(kubeconfig_t * kubeconfig, const kubeyaml_load_options_t * options, kubeyaml_foreach_handler_t handler, void *data);
+
+/*
+ * kubeyaml_peek_current_context
+ *
+ * Description:
+ *
+ * Get the current-context of the kubeconfig file without loading it. Only
+ * the keys of the top mapping are parsed, the clusters, contexts and users
+ * are skipped without being built, and the scan stops at current-context.
+ * The rest of the file is not read, so it is not validated either. A file
+ * the scan cannot follow is loaded with kubeyaml_load_kubeconfig().
+ *
+ * Return:
+ *
+ *   0     Success, buf is "" if the file has no current-context
+ *  -1     Failed, e.g. the file cannot be read or buf is too small
+ *
+ * Parameter:
+ *
+ * IN:
+ * fileName: kubernetes cluster configuration file name
+ * len: size of buf in bytes, including the terminating NUL
+ *
+ * OUT:
+ * buf: NUL-terminated name of the current context
+ *
+ */
+    int kubeyaml_peek_current_context(const char *fileName, char *buf, size_t len);
+
 /*
  * kubeyaml_parse_exec_crendential
  *
@@ -54,6 +484,81 @@ extern "C" {
  */
     int kubeyaml_parse_exec_crendential(ExecCredential_t * exec_credential, const char *exec_credential_string);
 
+/*
+ * kubeyaml_parse_exec_crendential_with_context
+ *
+ * Description:
+ *
+ * Like kubeyaml_parse_exec_crendential(), with the scratch buffer of
+ * context, see kubeyaml_context_t.
+ *
+ * Return:
+ *
+ *   0     Success
+ *  -1     Failed
+ *
+ * Parameter:
+ *
+ * IN:
+ * context: buffers to reuse, NULL for fresh ones
+ * exec_credential_string: text string of kubeconfig exec result
+ *
+ * OUT:
+ * exec_credential: data structure of kubeconfig exec credential
+ *
+ */
+    int kubeyaml_parse_exec_crendential_with_context(kubeyaml_context_t * context, ExecCredential_t * exec_credential, const char *exec_credential_string);
+
+/*
+ * kubeyaml_parse_exec_crendential_from_reader
+ *
+ * Description:
+ *
+ * Parse the exec result delivered by the read handler to get the kubeconfig
+ * exec credential, e.g. while the exec plugin is still writing its stdout.
+ *
+ * Return:
+ *
+ *   0     Success
+ *  -1     Failed
+ *
+ * Parameter:
+ *
+ * IN:
+ * handler: read callback delivering the text of the kubeconfig exec result
+ * data: caller data passed to each call of handler
+ *
+ * OUT:
+ * exec_credential: data structure of kubeconfig exec credential
+ *
+ */
+    int kubeyaml_parse_exec_crendential_from_reader(ExecCredential_t * exec_credential, kubeyaml_read_handler_t handler, void *data);
+
+/*
+ * kubeyaml_parse_exec_crendential_from_fd
+ *
+ * Description:
+ *
+ * Parse the exec result read from the file descriptor fd (e.g. the stdout
+ * pipe of the exec plugin) until the end of the input. The descriptor is
+ * not closed.
+ *
+ * Return:
+ *
+ *   0     Success
+ *  -1     Failed
+ *
+ * Parameter:
+ *
+ * IN:
+ * fd: readable file descriptor
+ *
+ * OUT:
+ * exec_credential: data structure of kubeconfig exec credential
+ *
+ */
+    int kubeyaml_parse_exec_crendential_from_fd(ExecCredential_t * exec_credential, int fd);
+
 /*
  * kubeyaml_save_kubeconfig
  *
@@ -61,6 +566,9 @@ extern "C" {
  *
  * Save the kubeconfig to the file specified by kubeconfig->fileName
  *
+ * The *-data fields of a kubeconfig loaded with KUBEYAML_LOAD_DECODE_DATA
+ * are written as base64 again.
+ *
  * Return:
  *
  *   0     Success